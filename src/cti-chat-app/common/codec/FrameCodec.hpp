@@ -0,0 +1,269 @@
+/**
+    @author: Mohamed Ashraf
+    @email: mohamed.ashraf@coretech-innovations.com
+    @date: Oct 2026
+    @description: Block compression of response frames, shared by server and client.
+    @mohamedashraf-eng
+*/
+
+#ifndef FRAME_CODEC_HPP
+#   define FRAME_CODEC_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QtEndian>
+
+#if defined(CTI_HAVE_LZ4)
+#include <lz4.h>
+#endif
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class FrameCodec
+ * @brief Wire format and codecs for compressed frames (COMPRESS).
+ *
+ * A compressed frame replaces one serialized response:
+ *
+ *     "\x1bZ <codec>\n" { u32 rawLength, u32 storedLength, stored bytes }* u32 0, u32 0 ';'
+ *
+ * (lengths big-endian). The response is cut into blocks that are compressed
+ * independently, so the sender can write each block as soon as it is ready and
+ * the receiver never has to hold more than one encoded block to make
+ * progress. A block that does not shrink is stored as-is (storedLength ==
+ * rawLength). Lengths are explicit, so ';' inside compressed data is harmless.
+ *
+ * Codecs: "zlib" (qCompress, always available) and "lz4" (faster, only when
+ * built with CTI_HAVE_LZ4).
+ */
+class FrameCodec {
+public:
+    /** @brief Supported codecs. */
+    enum class Codec { None, Zlib, Lz4 };
+
+    /** @brief Marker that starts every compressed frame. */
+    static constexpr const char* MAGIC = "\x1bZ ";
+
+    /** @brief Largest block a decoder accepts (guards allocations). */
+    static constexpr quint32 MAX_BLOCK_BYTES = 1024 * 1024 * 4;
+
+    /** @brief Returns the protocol name of a codec. */
+    static QString name(Codec codec) {
+        switch (codec) {
+        case Codec::Zlib: return QStringLiteral("zlib");
+        case Codec::Lz4:  return QStringLiteral("lz4");
+        case Codec::None: break;
+        }
+        return QStringLiteral("none");
+    }
+
+    /** @brief Parses a codec name; unknown or unavailable codecs map to None. */
+    static Codec fromName(const QString& name) {
+        const QString n = name.trimmed().toLower();
+        if (n == QLatin1String("zlib")) {
+            return Codec::Zlib;
+        }
+#if defined(CTI_HAVE_LZ4)
+        if (n == QLatin1String("lz4")) {
+            return Codec::Lz4;
+        }
+#endif
+        return Codec::None;
+    }
+
+    /** @brief Codecs available in this build, fastest first. */
+    static QStringList available() {
+        QStringList names;
+#if defined(CTI_HAVE_LZ4)
+        names << name(Codec::Lz4);
+#endif
+        names << name(Codec::Zlib);
+        return names;
+    }
+
+    /**
+     * @class Encoder
+     * @brief Produces a compressed frame piece by piece.
+     *
+     * Usage: header(), block() for each slice of at most blockBytes, trailer().
+     */
+    class Encoder {
+    public:
+        /**
+         * @param codec Codec to use (must not be None).
+         * @param zlibLevel Compression level passed to qCompress.
+         */
+        explicit Encoder(Codec codec, int zlibLevel = -1)
+            : m_codec(codec), m_zlibLevel(zlibLevel) {}
+
+        /** @brief Frame header naming the codec. */
+        QByteArray header() const {
+            return QByteArray(MAGIC) + name(m_codec).toLatin1() + '\n';
+        }
+
+        /** @brief Encodes one block (length prefix included). */
+        QByteArray block(const char* data, int size) const {
+            QByteArray stored = compress(data, size);
+            const bool raw = stored.isEmpty() || stored.size() >= size;
+
+            QByteArray out(8, Qt::Uninitialized);
+            qToBigEndian<quint32>(static_cast<quint32>(size), out.data());
+            qToBigEndian<quint32>(static_cast<quint32>(raw ? size : stored.size()), out.data() + 4);
+            if (raw) {
+                out.append(data, size);
+            } else {
+                out.append(stored);
+            }
+            return out;
+        }
+
+        /** @brief End-of-frame marker followed by the frame delimiter. */
+        static QByteArray trailer() {
+            return QByteArray(8, '\0') + ';';
+        }
+
+    private:
+        /** @brief Compresses one block; empty on failure. */
+        QByteArray compress(const char* data, int size) const {
+            switch (m_codec) {
+            case Codec::Zlib: {
+                // qCompress prefixes its own 4-byte length; the block header carries it already.
+                const QByteArray z = qCompress(reinterpret_cast<const uchar*>(data), size, m_zlibLevel);
+                return z.size() > 4 ? z.mid(4) : QByteArray();
+            }
+            case Codec::Lz4: {
+#if defined(CTI_HAVE_LZ4)
+                QByteArray out(LZ4_compressBound(size), Qt::Uninitialized);
+                const int n = LZ4_compress_default(data, out.data(), size, out.size());
+                out.resize(qMax(0, n));
+                return out;
+#else
+                break;
+#endif
+            }
+            case Codec::None:
+                break;
+            }
+            return QByteArray();
+        }
+
+        Codec m_codec;
+        int m_zlibLevel;
+    };
+
+    /**
+     * @class Decoder
+     * @brief Incrementally decodes one compressed frame from a byte stream.
+     *
+     * feed() may be called with whatever has arrived so far; it consumes
+     * complete pieces only and appends decoded bytes to the output as each
+     * block completes.
+     */
+    class Decoder {
+    public:
+        /**
+         * @brief Consumes bytes from the front of @p buffer.
+         * @param buffer Received bytes; consumed bytes are removed.
+         * @param out Receives the decoded data.
+         * @return false on a malformed frame.
+         */
+        bool feed(QByteArray* buffer, QByteArray* out) {
+            // Step 1: Header.
+            if (m_codec == Codec::None) {
+                const int eol = buffer->indexOf('\n');
+                if (eol < 0) {
+                    return buffer->size() <= 64;
+                }
+                const QByteArray magic(MAGIC);
+                if (!buffer->startsWith(magic)) {
+                    return false;
+                }
+                m_codec = fromName(QString::fromLatin1(buffer->mid(magic.size(), eol - magic.size())));
+                buffer->remove(0, eol + 1);
+                if (m_codec == Codec::None) {
+                    return false;
+                }
+            }
+
+            // Step 2: As many complete blocks as have arrived.
+            while (!m_finished && buffer->size() >= 8) {
+                const quint32 rawSize = qFromBigEndian<quint32>(buffer->constData());
+                const quint32 storedSize = qFromBigEndian<quint32>(buffer->constData() + 4);
+                if (rawSize > MAX_BLOCK_BYTES || storedSize > rawSize) {
+                    return false;
+                }
+                if (rawSize == 0) {
+                    // Terminator, then the usual frame delimiter.
+                    if (buffer->size() < 9) {
+                        return true;
+                    }
+                    buffer->remove(0, 9);
+                    m_finished = true;
+                    break;
+                }
+                if (static_cast<quint32>(buffer->size()) < 8 + storedSize) {
+                    return true;
+                }
+                if (!decompress(buffer->constData() + 8, storedSize, rawSize, out)) {
+                    return false;
+                }
+                buffer->remove(0, 8 + static_cast<int>(storedSize));
+            }
+            return true;
+        }
+
+        /** @brief True once the end-of-frame marker has been consumed. */
+        bool finished() const { return m_finished; }
+
+    private:
+        /** @brief Appends one decoded block to @p out. */
+        bool decompress(const char* data, quint32 storedSize, quint32 rawSize, QByteArray* out) const {
+            if (storedSize == rawSize) {
+                out->append(data, static_cast<int>(rawSize));
+                return true;
+            }
+            switch (m_codec) {
+            case Codec::Zlib: {
+                QByteArray z(4, Qt::Uninitialized);
+                qToBigEndian<quint32>(rawSize, z.data());
+                z.append(data, static_cast<int>(storedSize));
+                const QByteArray raw = qUncompress(z);
+                if (static_cast<quint32>(raw.size()) != rawSize) {
+                    return false;
+                }
+                out->append(raw);
+                return true;
+            }
+            case Codec::Lz4: {
+#if defined(CTI_HAVE_LZ4)
+                const int offset = out->size();
+                out->resize(offset + static_cast<int>(rawSize));
+                const int n = LZ4_decompress_safe(data, out->data() + offset,
+                                                  static_cast<int>(storedSize), static_cast<int>(rawSize));
+                if (n != static_cast<int>(rawSize)) {
+                    out->resize(offset);
+                    return false;
+                }
+                return true;
+#else
+                break;
+#endif
+            }
+            case Codec::None:
+                break;
+            }
+            return false;
+        }
+
+        Codec m_codec = Codec::None;
+        bool m_finished = false;
+    };
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* FRAME_CODEC_HPP */
@@ -18,6 +18,13 @@ INCLUDEPATH += \
 
 QT += core network
 
+# Optional LZ4 codec for COMPRESS (zlib through qCompress is always available)
+CONFIG += link_pkgconfig
+packagesExist(liblz4) {
+    DEFINES += CTI_HAVE_LZ4
+    PKGCONFIG += liblz4
+}
+
 # Check Build Mode and define a C++ macro
 CONFIG(debug, debug|release) {
     message("Shared: Building in DEBUG mode")
@@ -35,10 +42,15 @@ CONFIG(debug, debug|release) {
 
 HEADERS += \
            $$PWD/constants.hpp \
+           $$PWD/codec/FrameCodec.hpp \
            $$PWD/error/error_codes.hpp \
            $$PWD/error/error_emitter.hpp \
+           $$PWD/error/log_backend.hpp \
            $$PWD/network_layer/iconnect.hpp \
            $$PWD/protocol_layer/imessage.hpp \
 
+SOURCES += \
+           $$PWD/error/log_backend.cpp \
+
 # HEADERS += $$PWD/chatmessage.h
 # SOURCES += $$PWD/chatmessage.cpp
\ No newline at end of file
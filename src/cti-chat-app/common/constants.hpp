@@ -31,6 +31,17 @@ namespace Constants {
      */
     static constexpr uint32_t MAX_PAYLOAD_SIZE        = 1024 * 1024 * 5; 
 
+    /**
+     * @brief SESSION_BUFFER_LIMIT_BYTES
+     * Bytes of one incomplete frame a connection may hold. A frame growing past
+     * this (or past MAX_PAYLOAD_SIZE) is dropped while it streams in.
+     */
+    static constexpr qint64   SESSION_BUFFER_LIMIT_BYTES = MAX_PAYLOAD_SIZE;
+    /** @brief Bytes taken from the socket per framing step. */
+    static constexpr int      SESSION_READ_CHUNK_BYTES = 1024 * 64;
+    /** @brief Read buffer of each socket; a client sending faster is slowed down by TCP. */
+    static constexpr qint64   SESSION_SOCKET_BUFFER_BYTES = 1024 * 256;
+
     /** 
      * @brief MAX_MESSAGE_LENGTH
      * Max characters allowed in a single chat message.
@@ -39,12 +50,100 @@ namespace Constants {
     
     static constexpr uint8_t  MAX_USERNAME_LENGTH      = 32;
     static constexpr uint16_t MAX_CONNECTED_CLIENTS    = 1000;
+    /** @brief Maximum number of sub-commands in one MULTI ... EXEC batch. */
+    static constexpr int      MULTI_MAX_COMMANDS       = 1000;
+    /** @brief Tagged ("#id") requests of one session that may run at the same time. */
+    static constexpr int      PIPELINE_MAX_IN_FLIGHT   = 16;
+    /** @brief Size of the shared request worker pool, per CPU core. */
+    static constexpr int      PIPELINE_THREADS_PER_CORE = 2;
+    /**
+     * @brief Threads running offloaded requests (AUTH), apart from the request pool.
+     * Kept above AUTH_MAX_PENDING, so logins beyond the credential store's
+     * backlog reach it and are answered busy instead of queueing here.
+     */
+    static constexpr int      PIPELINE_OFFLOAD_THREADS  = 16;
+
+    // --- Rate Limiting (RateLimitPolicy; 0 = unlimited) ---
+    /** @brief Sustained requests per second of one connection, and its burst. */
+    static constexpr qint64   RATE_SESSION_REQUESTS_PER_SEC = 200;
+    static constexpr qint64   RATE_SESSION_REQUEST_BURST    = 400;
+    /** @brief Sustained payload bytes per second of one connection (8 MB), and its burst. */
+    static constexpr qint64   RATE_SESSION_BYTES_PER_SEC    = 1024 * 1024 * 8;
+    static constexpr qint64   RATE_SESSION_BYTE_BURST       = 2 * qint64(MAX_PAYLOAD_SIZE);
+    /** @brief Same, shared by all connections of one authenticated user. */
+    static constexpr qint64   RATE_USER_REQUESTS_PER_SEC    = 500;
+    static constexpr qint64   RATE_USER_REQUEST_BURST       = 1000;
+    static constexpr qint64   RATE_USER_BYTES_PER_SEC       = 1024 * 1024 * 32;
+    static constexpr qint64   RATE_USER_BYTE_BURST          = 4 * qint64(MAX_PAYLOAD_SIZE);
+    /** @brief Requests of each command class running at once, server-wide; beyond that they are shed. */
+    static constexpr int      RATE_MAX_CONCURRENT_AUTH      = 16;
+    static constexpr int      RATE_MAX_CONCURRENT_READ      = 256;
+    static constexpr int      RATE_MAX_CONCURRENT_WRITE     = 128;
+    static constexpr int      RATE_MAX_CONCURRENT_SEARCH    = 8;
+
+    // --- File Service Limits ---
+    /** @brief Directory served to clients unless --root is given. */
+    inline const QString      SERVED_ROOT_PATH         = ".";
+    /** @brief Page size used by LIST when a paginated option is given without limit=. */
+    static constexpr int      LIST_DEFAULT_PAGE_SIZE   = 1000;
+    /** @brief Upper bound on limit= for a single LIST page. */
+    static constexpr int      LIST_MAX_PAGE_SIZE       = 10000;
+    /** @brief Total bytes of file content kept by the READ cache (64 MB). */
+    static constexpr qint64   READ_CACHE_BUDGET_BYTES  = 1024 * 1024 * 64;
+    /** @brief Files larger than this are always read from disk (4 MB). */
+    static constexpr qint64   READ_CACHE_MAX_ENTRY_BYTES = 1024 * 1024 * 4;
+    /**
+     * @brief APPEND_DURABILITY_LEVEL
+     * When an APPEND is acknowledged: 0 = queued in memory, 1 = written to the
+     * kernel, 2 = fdatasync'ed (group commit).
+     */
+    static constexpr int      APPEND_DURABILITY_LEVEL  = 1;
+    /** @brief Extra time an append batch stays open to collect more appends. */
+    static constexpr int      APPEND_GROUP_COMMIT_WINDOW_MS = 0;
+    /** @brief Number of append targets kept open between batches. */
+    static constexpr int      APPEND_MAX_OPEN_FILES    = 64;
+    /** @brief Upper bound on the matching lines returned by one GREP (1 MB). */
+    static constexpr qint64   GREP_MAX_RESULT_BYTES    = 1024 * 1024;
+    /** @brief Matching lines longer than this are clipped in GREP output. */
+    static constexpr int      GREP_MAX_LINE_BYTES      = 1024;
+    /** @brief Maintain the inverted index behind SEARCH (stored in <root>/.cti_index). */
+    static constexpr bool     FULLTEXT_INDEX_ENABLED   = true;
+    /** @brief Marks AtomicWriter temp files (".<name>.ctitmp.XXXXXX"); reserved in client paths. */
+    inline const QString      ATOMIC_TEMP_MARKER       = ".ctitmp.";
+    /** @brief Directory of the index beneath the root; reserved, no file command may name it. */
+    inline const QString      FULLTEXT_INDEX_DIR       = ".cti_index";
+    /** @brief Files larger than this are left out of the full-text index (16 MB). */
+    static constexpr qint64   FULLTEXT_MAX_FILE_BYTES  = 1024 * 1024 * 16;
+    /**
+     * @brief A changed file is re-indexed this long after its first change; later
+     * changes (e.g. a stream of APPENDs) fold into that one re-read.
+     */
+    static constexpr int      FULLTEXT_UPDATE_DELAY_MS = 5000;
+    /** @brief Changed files kept in memory before the on-disk segment is rebuilt. */
+    static constexpr int      FULLTEXT_MAX_OVERLAY_DOCS = 1024;
+    /** @brief Maximum number of paths a single client may WATCH. */
+    static constexpr int      WATCH_MAX_PER_CLIENT     = 256;
+    /** @brief Number of file digests remembered by CHECKSUM / conditional READ. */
+    static constexpr int      CHECKSUM_CACHE_MAX_ENTRIES = 65536;
+    /** @brief Files at least this large are hashed by several threads (8 MB). */
+    static constexpr qint64   CHECKSUM_PARALLEL_THRESHOLD = 1024 * 1024 * 8;
+    /** @brief Chunk handed to each hashing thread (2 MB). */
+    static constexpr qint64   CHECKSUM_CHUNK_BYTES     = 1024 * 1024 * 2;
+    /** @brief SIGNATURE block size when the client does not ask for one. */
+    static constexpr int      DELTA_DEFAULT_BLOCK_BYTES = 4096;
+    /** @brief Smallest block size accepted by SIGNATURE/DELTA. */
+    static constexpr int      DELTA_MIN_BLOCK_BYTES    = 256;
+    /** @brief Largest block size accepted by SIGNATURE/DELTA (1 MB). */
+    static constexpr int      DELTA_MAX_BLOCK_BYTES    = 1024 * 1024;
+    /** @brief Largest file a DELTA may rebuild (1 GB); a delta expanding past it is rejected. */
+    static constexpr qint64   DELTA_MAX_RESULT_BYTES   = 1024 * 1024 * 1024;
 
     // --- Timeouts (Milliseconds) ---
     static constexpr int      CONNECTION_TIMEOUT_MS    = 10000; // 10s
     static constexpr int      SSL_HANDSHAKE_TIMEOUT_MS = 5000;  // 5s
     static constexpr int      KEEP_ALIVE_INTERVAL_MS   = 30000; // 30s Heartbeat
     static constexpr int      IDLE_CLIENT_TIMEOUT_MS   = 60000; // Disconnect after 1 min inactivity
+    static constexpr int      AUTH_SWEEP_INTERVAL_MS   = 5000;  // Idle authenticated sessions are expired this often
 
     // --- Protocol Details ---
     /**
@@ -53,10 +152,55 @@ namespace Constants {
      * uint32_t = 4 bytes.
      */
     static constexpr uint8_t  PACKET_HEADER_SIZE       = sizeof(uint32_t);
+    /** @brief Once COMPRESS is negotiated, responses at least this large are compressed. */
+    static constexpr int      COMPRESS_MIN_FRAME_BYTES = 1024;
+    /** @brief Slice of a response compressed (and written) at a time (256 KB). */
+    static constexpr int      COMPRESS_BLOCK_BYTES     = 1024 * 256;
+    /** @brief qCompress level for the zlib codec (1 = fastest). */
+    static constexpr int      COMPRESS_ZLIB_LEVEL      = 1;
 
     // --- Security / SSL Paths ---
+    // Relative to the server binary's directory (never the CWD, the default served root).
     inline const QString      SERVER_CERT_PATH         = "configs/certs/server.crt";
     inline const QString      SERVER_KEY_PATH          = "configs/certs/server.key";
+    /** @brief TLS sessions kept by the server for resumption by session id. */
+    static constexpr long     TLS_SESSION_CACHE_SIZE   = 20480;
+    /** @brief How long a TLS session (cached or ticket) may be resumed, in seconds. */
+    static constexpr long     TLS_SESSION_LIFETIME_SEC = 7200;
+    /** @brief TLS 1.3 tickets issued per full handshake. */
+    static constexpr int      TLS_TICKETS_PER_HANDSHAKE = 1;
+    /**
+     * @brief User database of AUTH (PBKDF2 records, see CredentialStore), relative to
+     * the server binary's directory unless --credentials names another file. Never
+     * resolved against the CWD, which is the default served root.
+     */
+    inline const QString      CREDENTIALS_PATH         = "configs/credentials.db";
+    /** @brief The credentials file is checked for changes at most this often. */
+    static constexpr int      CREDENTIALS_RELOAD_CHECK_MS = 2000;
+    /** @brief PBKDF2 iterations for records created by the server (fallback users). */
+    static constexpr int      CREDENTIALS_DEFAULT_ITERATIONS = 100000;
+    /** @brief Records asking for more PBKDF2 iterations are refused (bounds one KDF run). */
+    static constexpr int      CREDENTIALS_MAX_ITERATIONS = 2000000;
+    /** @brief Threads running the password KDF; logins never use more cores than this. */
+    static constexpr int      AUTH_WORKER_THREADS      = 2;
+    /**
+     * @brief AUTH requests allowed to wait for a KDF worker before AUTH answers busy.
+     * Each one holds an offload-pool thread while it waits (never a request-pool
+     * thread), so this stays below PIPELINE_OFFLOAD_THREADS.
+     */
+    static constexpr int      AUTH_MAX_PENDING         = 8;
+
+    // --- Logging (EMIT_* backend) ---
+    /** @brief Per-thread ring of pending log records; a full ring drops records instead of blocking. */
+    static constexpr int      LOG_RING_BYTES           = 1024 * 32;
+    /** @brief Largest encoded log record; longer arguments are truncated. */
+    static constexpr int      LOG_MAX_RECORD_BYTES     = 512;
+    /** @brief How often the log writer drains the rings. */
+    static constexpr int      LOG_FLUSH_INTERVAL_MS    = 20;
+
+    // --- Metrics (METRICS command) ---
+    /** @brief Command verbs with their own counters; later ones are counted as UNKNOWN. */
+    static constexpr int      METRICS_MAX_VERBS        = 32;
 
     // --- Application Info ---
     inline const QString      APP_NAME                 = "CTI Chat Server - Wx";
@@ -72,6 +72,7 @@ namespace Chat {
             case ErrorCode::ERR_PAYLOAD_TOO_LARGE:       return "Security Warning: Payload Too Large";
             case ErrorCode::ERR_USER_NOT_FOUND:          return "User Not Found";
             case ErrorCode::ERR_INTERNAL_SERVER_ERROR:   return "Internal Server Error";
+            case ErrorCode::ERR_SERVER_BUSY:             return "Server Busy";
             case ErrorCode::ERR_MALFORMED_PACKET:        return "Detected malformed packet";
             case ErrorCode::ERR_CHAT_NOT_FOUND:          return "Chat Not Found";
             default:                                     return "Unknown Error Code";
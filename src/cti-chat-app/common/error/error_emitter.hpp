@@ -3,7 +3,8 @@
     @email: mohamed.ashraf@coretech-innovations.com
     @date: Jan 2026
     @description: Standardized error emitter for CTI Chat Application.
-                  Wraps Qt logging with context-aware metadata.
+                  Records are filtered per module at runtime and written by the
+                  asynchronous backend in log_backend.hpp.
     @mohamedashraf-eng
 */
 
@@ -12,51 +13,59 @@
 
 // Qt Depends
 #   include <QDebug>
-#   include <QDateTime>
 
-// Std Depends
-#   include <iostream>
+// Other
+#   include "log_backend.hpp"
 
 /**
- * @brief Formatting helpers for the console output
+ * @brief Starts a log record for the calling site.
+ *
+ * The call site is described once, by a static Site (file, line, level);
+ * the record only stores its address, a timestamp and the binary arguments.
+ * Formatting ("[time][file:line][LEVEL]: ...") happens on the log writer thread.
  */
-#   define CTI_LOG_FORMAT(level) \
-        qUtf8Printable(QString("[%1][%2][%3]: ") \
-            .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz")) \
-            .arg(__LINE__) \
-            .arg(level))
+#   define CTI_LOG_RECORD(lvl) \
+        ::CTI::Chat::Log::Record([]() -> const ::CTI::Chat::Log::Site* { \
+            static constexpr ::CTI::Chat::Log::Site site{__FILE__, __LINE__, lvl}; \
+            return &site; \
+        }())
+
+/**
+ * @brief Runs the statement only if @p lvl is enabled for the file's module.
+ *
+ * The module is derived from __FILE__ at compile time; a disabled statement
+ * costs one relaxed atomic load and a branch, and its arguments are never
+ * evaluated. (A loop rather than an if, so that an else after the
+ * statement cannot bind to it.)
+ */
+#   define CTI_LOG_AT(lvl) \
+        for (bool cti_log_enabled = \
+                 ::CTI::Chat::Log::enabled<::CTI::Chat::Log::moduleOf(__FILE__)>(lvl); \
+             cti_log_enabled; cti_log_enabled = false) \
+            CTI_LOG_RECORD(lvl)
 
 /**
  * @section Log Levels Abstraction
  * 
- * CRITICAL and ERROR are always enabled for safety and security tracking.
- * INFO and WARN are toggled via the CTI_CHAT_VERBOSE_MODE flag.
+ * Every level is compiled in and filtered at runtime, per module (core,
+ * transport, session, security, commands, storage): see Log::configure(),
+ * the LOGLEVEL command and SIGUSR1/SIGUSR2. CRITICAL is always emitted.
+ * Debug builds (CTI_CHAT_VERBOSE_MODE) start at DEBUG, release builds at ERROR.
  */
 
 // 1. Critical Errors (System failure, Security Breach)
-#   define EMIT_CRITICAL() qCritical().noquote() << CTI_LOG_FORMAT("CRITICAL")
+#   define EMIT_CRITICAL() CTI_LOG_AT(::CTI::Chat::Log::Level::Critical)
 
 // 2. Standard Errors (Recoverable errors, Socket drops)
-#   define EMIT_ERROR()    qCritical().noquote() << CTI_LOG_FORMAT("ERROR")
-
-#   if defined(CTI_CHAT_VERBOSE_MODE)
-
-        // 3. Warnings (Potential issues, suspicious activity)
-#       define EMIT_WARN() qWarning().noquote() << CTI_LOG_FORMAT("WARN")
-
-        // 4. Info (Flow tracking, connection heartbeats)
-#       define EMIT_INFO() qInfo().noquote() << CTI_LOG_FORMAT("INFO")
+#   define EMIT_ERROR()    CTI_LOG_AT(::CTI::Chat::Log::Level::Error)
 
-        // 5. Debug (Only for development-heavy logic)
-#       define EMIT_DEBUG() qDebug().noquote() << CTI_LOG_FORMAT("DEBUG")
+// 3. Warnings (Potential issues, suspicious activity)
+#   define EMIT_WARN()     CTI_LOG_AT(::CTI::Chat::Log::Level::Warn)
 
-#   else
-        // If Verbose is OFF, these macros expand to a no-op "Nothing Stream"
-        // This ensures zero CPU/Memory overhead for logging in production.
-#       define EMIT_WARN()  while(false) QMessageLogger().noDebug()
-#       define EMIT_INFO()  while(false) QMessageLogger().noDebug()
-#       define EMIT_DEBUG() while(false) QMessageLogger().noDebug()
+// 4. Info (Flow tracking, connection heartbeats)
+#   define EMIT_INFO()     CTI_LOG_AT(::CTI::Chat::Log::Level::Info)
 
-#   endif /* defined(CTI_CHAT_VERBOSE_MODE) */
+// 5. Debug (Only for development-heavy logic)
+#   define EMIT_DEBUG()    CTI_LOG_AT(::CTI::Chat::Log::Level::Debug)
 
-#endif /* ERROR_EMITTER_H */
\ No newline at end of file
+#endif /* ERROR_EMITTER_H */
@@ -0,0 +1,622 @@
+/** 
+    @author: Mohamed Ashraf
+    @email: mohamed.ashraf@coretech-innovations.com
+    @date: Oct 2026
+    @description: Per-thread log rings and the background writer draining them.
+    @mohamedashraf-eng
+*/
+
+// Qt Depends
+#include <QDateTime>
+#include <QStringList>
+
+// Std Depends
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <csignal>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "log_backend.hpp"
+
+namespace CTI {
+namespace Chat {
+namespace Log {
+
+namespace {
+
+    /** @brief Level every module starts at. */
+#if defined(CTI_CHAT_VERBOSE_MODE)
+    constexpr quint8 DEFAULT_LEVEL = static_cast<quint8>(Level::Debug);
+#else
+    constexpr quint8 DEFAULT_LEVEL = static_cast<quint8>(Level::Error);
+#endif
+
+    static_assert(std::atomic<quint8>::is_always_lock_free, "levels are changed from a signal handler");
+
+    /** @brief Levels resetLevels() restores: the build default until saveStartupLevels(). */
+    std::atomic<quint8> g_startupLevels[MODULE_COUNT] = {
+        {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}
+    };
+
+    /** @brief Fixed part of every record (and of the ring's padding markers). */
+    struct Header {
+        quint32 size;       ///< Bytes of the record, header included.
+        quint32 flags;      ///< FLAG_* bits.
+        qint64 ns;          ///< Steady-clock time of the statement.
+        const Site* site;   ///< Call site (format id).
+    };
+
+    /** @brief The record lost arguments because it was full. */
+    constexpr quint32 FLAG_TRUNCATED = 1u << 0;
+    /** @brief Ring filler up to its end; not a record. */
+    constexpr quint32 FLAG_PADDING = 1u << 1;
+
+    /** @brief Records are stored 8-byte aligned in the rings. */
+    constexpr size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+    static_assert(Constants::LOG_RING_BYTES % 8 == 0, "LOG_RING_BYTES must be a multiple of 8");
+    static_assert(Constants::LOG_MAX_RECORD_BYTES * 2 <= Constants::LOG_RING_BYTES, "log ring too small");
+
+    /** @brief Sets FLAG_TRUNCATED in an encoded record's header. */
+    void markTruncated(unsigned char* record) {
+        quint32 flags;
+        std::memcpy(&flags, record + offsetof(Header, flags), sizeof(flags));
+        flags |= FLAG_TRUNCATED;
+        std::memcpy(record + offsetof(Header, flags), &flags, sizeof(flags));
+    }
+
+    qint64 steadyNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Single-producer/single-consumer byte ring of one thread.
+     *
+     * Positions only grow; the producer publishes with a release store of
+     * m_head, the consumer frees space with a release store of m_tail. A
+     * record that does not fit before the end of the buffer is preceded by a
+     * padding marker and written at the start.
+     */
+    class Ring {
+    public:
+        Ring() : m_data(new unsigned char[Constants::LOG_RING_BYTES]) {}
+
+        /** @brief Producer side; false if the ring is full. */
+        bool push(const unsigned char* record, size_t size) {
+            const size_t length = align8(size);
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t tail = m_tail.load(std::memory_order_acquire);
+            const size_t offset = head % CAPACITY;
+            const size_t contiguous = CAPACITY - offset;
+            const size_t padding = (contiguous < length) ? contiguous : 0;
+            if (CAPACITY - (head - tail) < padding + length) {
+                return false;
+            }
+
+            size_t at = head;
+            if (padding) {
+                const quint32 marker[2] = { static_cast<quint32>(padding), FLAG_PADDING };
+                std::memcpy(m_data.get() + offset, marker, sizeof(marker));
+                at += padding;
+            }
+            std::memcpy(m_data.get() + at % CAPACITY, record, size);
+            m_head.store(at + length, std::memory_order_release);
+            return true;
+        }
+
+        /** @brief Consumer side; calls @p sink for every record published so far. */
+        template <class Sink>
+        bool drain(Sink&& sink) {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_acquire);
+            if (tail == head) {
+                return false;
+            }
+            while (tail != head) {
+                const unsigned char* at = m_data.get() + tail % CAPACITY;
+                quint32 marker[2];
+                std::memcpy(marker, at, sizeof(marker));
+                if (!(marker[1] & FLAG_PADDING)) {
+                    sink(at, marker[0]);
+                }
+                tail += (marker[1] & FLAG_PADDING) ? marker[0] : align8(marker[0]);
+            }
+            m_tail.store(tail, std::memory_order_release);
+            return true;
+        }
+
+        /** @brief Set when the owning thread has exited; the ring is freed once drained. */
+        std::atomic<bool> retired{false};
+
+    private:
+        static constexpr size_t CAPACITY = Constants::LOG_RING_BYTES;
+
+        std::unique_ptr<unsigned char[]> m_data;
+        alignas(64) std::atomic<size_t> m_head{0};
+        alignas(64) std::atomic<size_t> m_tail{0};
+    };
+
+    /**
+     * @brief Owner of the rings and of the writer thread.
+     *
+     * Never destroyed (threads may log until the very end); an atexit hook
+     * stops the writer after a final drain.
+     */
+    class Backend {
+    public:
+        static Backend& instance() {
+            static Backend* backend = new Backend();
+            return *backend;
+        }
+
+        /** @brief Creates and registers the ring of the calling thread. */
+        Ring* attach() {
+            auto* ring = new Ring();
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            m_rings.push_back(ring);
+            return ring;
+        }
+
+        void countDrop() { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+
+        quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+        /** @brief Drains every ring and writes the result now. */
+        void flush() {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            drainAndWrite();
+        }
+
+        /** @brief Stops the writer after a last drain (process exit). */
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            if (m_writer.joinable()) {
+                m_writer.join();
+            }
+            flush();
+            m_stopped.store(true, std::memory_order_release);
+        }
+
+        /** @brief True once the writer is gone; records are then written by their caller. */
+        bool stopped() const { return m_stopped.load(std::memory_order_acquire); }
+
+    private:
+        Backend() {
+            // Wall-clock origin for the steady timestamps of the records.
+            m_steadyBaseNs = steadyNs();
+            m_wallBaseMs = QDateTime::currentMSecsSinceEpoch();
+            m_writer = std::thread([this]() { run(); });
+            std::atexit([]() { Backend::instance().stop(); });
+        }
+
+        /** @brief Writer thread: drain, format, write, sleep. */
+        void run() {
+            std::unique_lock<std::mutex> wake(m_wakeMutex);
+            while (!m_stop) {
+                wake.unlock();
+                flush();
+                wake.lock();
+                m_wake.wait_for(wake, std::chrono::milliseconds(Constants::LOG_FLUSH_INTERVAL_MS),
+                                [this]() { return m_stop; });
+            }
+        }
+
+        /** @brief One pass over the rings (caller holds m_drainMutex). */
+        void drainAndWrite() {
+            // Step 1: Snapshot the rings; free those of exited threads once empty.
+            std::vector<Ring*> rings;
+            {
+                std::lock_guard<std::mutex> lock(m_ringsMutex);
+                rings = m_rings;
+            }
+
+            // Step 2: Decode everything published so far.
+            m_lines.clear();
+            std::vector<Ring*> finished;
+            for (Ring* ring : rings) {
+                const bool retired = ring->retired.load(std::memory_order_acquire);
+                ring->drain([this](const unsigned char* record, quint32 size) { decode(record, size); });
+                if (retired) {
+                    finished.push_back(ring);
+                }
+            }
+            if (!finished.empty()) {
+                std::lock_guard<std::mutex> lock(m_ringsMutex);
+                for (Ring* ring : finished) {
+                    m_rings.erase(std::find(m_rings.begin(), m_rings.end(), ring));
+                    delete ring;
+                }
+            }
+
+            const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+            if (m_lines.empty() && dropped == m_reportedDrops) {
+                return;
+            }
+
+            // Step 3: Merge the threads' records in time order and write them at once.
+            std::stable_sort(m_lines.begin(), m_lines.end(),
+                             [](const Line& a, const Line& b) { return a.ns < b.ns; });
+            m_batch.clear();
+            for (const Line& line : m_lines) {
+                m_batch.append(line.text);
+                m_batch.append('\n');
+            }
+            if (dropped != m_reportedDrops) {
+                m_batch.append("[LOG] ").append(QByteArray::number(dropped - m_reportedDrops))
+                       .append(" records dropped (ring full)\n");
+                m_reportedDrops = dropped;
+            }
+            std::fwrite(m_batch.constData(), 1, static_cast<size_t>(m_batch.size()), stderr);
+            std::fflush(stderr);
+        }
+
+        /** @brief Formats one record into m_lines. */
+        void decode(const unsigned char* record, quint32 size) {
+            Header header;
+            std::memcpy(&header, record, sizeof(header));
+
+            Line line;
+            line.ns = header.ns;
+            QByteArray& text = line.text;
+            text.reserve(static_cast<int>(size) + 48);
+
+            // Step 1: "[time][file:line][LEVEL]: ".
+            const qint64 ms = m_wallBaseMs + (header.ns - m_steadyBaseNs) / 1000000;
+            const qint64 second = ms / 1000;
+            if (second != m_cachedSecond) {
+                m_cachedSecond = second;
+                m_cachedStamp = QDateTime::fromMSecsSinceEpoch(second * 1000)
+                                    .toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")).toUtf8();
+            }
+            char millis[8];
+            std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(ms % 1000));
+            const char* file = header.site->file;
+            for (const char* p = file; *p; ++p) {
+                if (*p == '/' || *p == '\\') {
+                    file = p + 1;
+                }
+            }
+            text.append('[').append(m_cachedStamp).append(millis).append("][")
+                .append(file).append(':')
+                .append(QByteArray::number(header.site->line)).append("][")
+                .append(levelName(header.site->level)).append("]:");
+
+            // Step 2: Arguments, space separated.
+            size_t at = sizeof(Header);
+            while (at < size) {
+                const ArgType type = static_cast<ArgType>(record[at++]);
+                text.append(' ');
+                if (type == ArgType::Utf8 || type == ArgType::Utf16) {
+                    quint32 length;
+                    std::memcpy(&length, record + at, sizeof(length));
+                    at += sizeof(length);
+                    if (type == ArgType::Utf8) {
+                        text.append(reinterpret_cast<const char*>(record + at), static_cast<int>(length));
+                    } else {
+                        std::vector<ushort> units(length / sizeof(ushort));
+                        std::memcpy(units.data(), record + at, units.size() * sizeof(ushort));
+                        text.append(QString::fromUtf16(units.data(), static_cast<int>(units.size())).toUtf8());
+                    }
+                    at += length;
+                    continue;
+                }
+
+                quint64 bits;
+                std::memcpy(&bits, record + at, sizeof(bits));
+                at += sizeof(bits);
+                switch (type) {
+                case ArgType::Int:    text.append(QByteArray::number(static_cast<qint64>(bits))); break;
+                case ArgType::UInt:   text.append(QByteArray::number(bits)); break;
+                case ArgType::Bool:   text.append(bits ? "true" : "false"); break;
+                case ArgType::Char:   text.append(static_cast<char>(bits)); break;
+                case ArgType::Double: {
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    text.append(QByteArray::number(d, 'g', 6));
+                    break;
+                }
+                default: break;
+                }
+            }
+            if (header.flags & FLAG_TRUNCATED) {
+                text.append(" [...]");
+            }
+            m_lines.push_back(std::move(line));
+        }
+
+        /** @brief A formatted record waiting to be written. */
+        struct Line {
+            qint64 ns;
+            QByteArray text;
+        };
+
+        /** @brief Registered rings (registration and removal only). */
+        std::mutex m_ringsMutex;
+        std::vector<Ring*> m_rings;
+
+        /** @brief One consumer at a time (writer thread or flush()). */
+        std::mutex m_drainMutex;
+
+        /** @brief Sleep of the writer thread. */
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+        bool m_stop = false;
+        std::thread m_writer;
+        std::atomic<bool> m_stopped{false};
+
+        std::atomic<quint64> m_dropped{0};
+        quint64 m_reportedDrops = 0;
+
+        qint64 m_steadyBaseNs = 0;
+        qint64 m_wallBaseMs = 0;
+
+        /** @brief Formatted "yyyy-MM-dd HH:mm:ss" of m_cachedSecond. */
+        qint64 m_cachedSecond = -1;
+        QByteArray m_cachedStamp;
+
+        /** @brief Scratch buffers of the consumer. */
+        std::vector<Line> m_lines;
+        QByteArray m_batch;
+    };
+
+    /** @brief The calling thread's ring; retired when the thread exits. */
+    struct ThreadRing {
+        Ring* ring = nullptr;
+        ~ThreadRing() {
+            if (ring) {
+                ring->retired.store(true, std::memory_order_release);
+                ring = nullptr;
+            }
+        }
+    };
+    thread_local ThreadRing t_ring;
+
+#if defined(SIGUSR1)
+    /** @brief SIGUSR1: one level more verbose everywhere; SIGUSR2: startup levels. */
+    void onLevelSignal(int signo) {
+        for (int i = 0; i < MODULE_COUNT; ++i) {
+            std::atomic<quint8>& level = g_levels[i];
+            if (signo == SIGUSR2) {
+                level.store(g_startupLevels[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            } else if (level.load(std::memory_order_relaxed) < static_cast<quint8>(Level::Debug)) {
+                level.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+#endif
+
+    bool parseLevel(const QString& name, Level* out) {
+        for (quint8 i = 0; i <= static_cast<quint8>(Level::Debug); ++i) {
+            if (name.compare(QLatin1String(levelName(static_cast<Level>(i))), Qt::CaseInsensitive) == 0) {
+                *out = static_cast<Level>(i);
+                return true;
+            }
+        }
+        if (name.compare(QLatin1String("warning"), Qt::CaseInsensitive) == 0) {
+            *out = Level::Warn;
+            return true;
+        }
+        return false;
+    }
+
+    /** @brief parseSetting() targets besides a single module index. */
+    constexpr int SETTING_ALL = -1;
+    constexpr int SETTING_DEFAULT = -2;
+
+    /** @brief Splits a configure() setting into a module index (or SETTING_*) and a level. */
+    bool parseSetting(const QString& text, int* module, Level* out) {
+        const QString setting = text.trimmed();
+        if (setting.compare(QLatin1String("default"), Qt::CaseInsensitive) == 0) {
+            *module = SETTING_DEFAULT;
+            return true;
+        }
+
+        // Step 1: "<module>=<level>", or a bare level for every module.
+        const int eq = setting.indexOf('=');
+        if (!parseLevel(setting.mid(eq + 1).trimmed(), out)) {
+            return false;
+        }
+        const QString name = (eq < 0) ? QStringLiteral("all") : setting.left(eq).trimmed();
+
+        // Step 2: Resolve the module name.
+        if (name.compare(QLatin1String("all"), Qt::CaseInsensitive) == 0) {
+            *module = SETTING_ALL;
+            return true;
+        }
+        for (int i = 0; i < MODULE_COUNT; ++i) {
+            if (name.compare(QLatin1String(moduleName(static_cast<Module>(i))), Qt::CaseInsensitive) == 0) {
+                *module = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} /* namespace */
+
+std::atomic<quint8> g_levels[MODULE_COUNT] = {
+    {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}, {DEFAULT_LEVEL}
+};
+static_assert(MODULE_COUNT == 6, "initialize g_levels for every module");
+
+Record::Record(const Site* site) noexcept
+    : m_size(sizeof(Header)) {
+    Header header;
+    header.size = 0;
+    header.flags = 0;
+    header.ns = steadyNs();
+    header.site = site;
+    std::memcpy(m_data, &header, sizeof(header));
+}
+
+Record::~Record() {
+    // Step 1: Seal the header.
+    const quint32 size = static_cast<quint32>(m_size);
+    std::memcpy(m_data, &size, sizeof(size));
+
+    // Step 2: Publish to this thread's ring; drop rather than wait when it is full.
+    Backend& backend = Backend::instance();
+    if (!t_ring.ring) {
+        t_ring.ring = backend.attach();
+    }
+    if (!t_ring.ring->push(m_data, m_size)) {
+        backend.countDrop();
+    }
+
+    // A critical record may precede a crash: write it out now (as everything
+    // logged after the writer has stopped at exit).
+    Header header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (header.site->level == Level::Critical || backend.stopped()) {
+        backend.flush();
+    }
+}
+
+void Record::put(ArgType type, quint64 bits) {
+    if (m_size + 1 + sizeof(bits) > sizeof(m_data)) {
+        markTruncated(m_data);
+        return;
+    }
+    m_data[m_size++] = static_cast<unsigned char>(type);
+    std::memcpy(m_data + m_size, &bits, sizeof(bits));
+    m_size += sizeof(bits);
+}
+
+Record& Record::raw(ArgType type, const void* data, size_t size) {
+    const size_t room = sizeof(m_data) - m_size;
+    if (room < 1 + sizeof(quint32)) {
+        markTruncated(m_data);
+        return *this;
+    }
+    size_t length = std::min(size, room - 1 - sizeof(quint32));
+    if (type == ArgType::Utf16) {
+        length &= ~size_t(1);
+    }
+    if (length < size) {
+        markTruncated(m_data);
+    }
+    const quint32 length32 = static_cast<quint32>(length);
+    m_data[m_size++] = static_cast<unsigned char>(type);
+    std::memcpy(m_data + m_size, &length32, sizeof(length32));
+    m_size += sizeof(length32);
+    if (length) {
+        std::memcpy(m_data + m_size, data, length);
+    }
+    m_size += length;
+    return *this;
+}
+
+void flush() {
+    Backend::instance().flush();
+}
+
+quint64 dropped() {
+    return Backend::instance().dropped();
+}
+
+void setLevel(Module module, Level level) {
+    g_levels[static_cast<int>(module)].store(static_cast<quint8>(level), std::memory_order_relaxed);
+}
+
+Level level(Module module) {
+    return static_cast<Level>(g_levels[static_cast<int>(module)].load(std::memory_order_relaxed));
+}
+
+void saveStartupLevels() {
+    for (int i = 0; i < MODULE_COUNT; ++i) {
+        g_startupLevels[i].store(g_levels[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void resetLevels() {
+    for (int i = 0; i < MODULE_COUNT; ++i) {
+        g_levels[i].store(g_startupLevels[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+bool configure(const QString& setting) {
+    int module;
+    Level lvl;
+    if (!parseSetting(setting, &module, &lvl)) {
+        return false;
+    }
+    if (module == SETTING_DEFAULT) {
+        resetLevels();
+    } else if (module == SETTING_ALL) {
+        for (int i = 0; i < MODULE_COUNT; ++i) {
+            setLevel(static_cast<Module>(i), lvl);
+        }
+    } else {
+        setLevel(static_cast<Module>(module), lvl);
+    }
+    return true;
+}
+
+bool isValidSetting(const QString& setting) {
+    int module;
+    Level lvl;
+    return parseSetting(setting, &module, &lvl);
+}
+
+QString describeLevels() {
+    QStringList parts;
+    for (int i = 0; i < MODULE_COUNT; ++i) {
+        const Module module = static_cast<Module>(i);
+        parts << QStringLiteral("%1=%2").arg(QLatin1String(moduleName(module)),
+                                             QString::fromLatin1(levelName(level(module))).toLower());
+    }
+    return parts.join(' ');
+}
+
+void installSignalHandlers() {
+#if defined(SIGUSR1)
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onLevelSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    ::sigaction(SIGUSR1, &action, nullptr);
+    ::sigaction(SIGUSR2, &action, nullptr);
+#endif
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+    case Level::Critical: return "CRITICAL";
+    case Level::Error:    return "ERROR";
+    case Level::Warn:     return "WARN";
+    case Level::Info:     return "INFO";
+    case Level::Debug:    return "DEBUG";
+    }
+    return "?";
+}
+
+const char* moduleName(Module module) {
+    switch (module) {
+    case Module::Core:      return "core";
+    case Module::Transport: return "transport";
+    case Module::Session:   return "session";
+    case Module::Security:  return "security";
+    case Module::Commands:  return "commands";
+    case Module::Storage:   return "storage";
+    case Module::Count:     break;
+    }
+    return "?";
+}
+
+} /* namespace Log */
+} /* namespace Chat */
+} /* namespace CTI */
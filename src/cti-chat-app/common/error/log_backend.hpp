@@ -0,0 +1,220 @@
+/** 
+    @author: Mohamed Ashraf
+    @email: mohamed.ashraf@coretech-innovations.com
+    @date: Oct 2026
+    @description: Asynchronous binary logging backend behind the EMIT_* macros.
+    @mohamedashraf-eng
+*/
+
+#ifndef LOG_BACKEND_H
+#   define LOG_BACKEND_H
+
+// Qt Depends
+#   include <QByteArray>
+#   include <QDebug>
+#   include <QString>
+
+// Std Depends
+#   include <atomic>
+#   include <cstring>
+#   include <string>
+#   include <type_traits>
+
+#   include "constants.hpp"
+
+namespace CTI {
+namespace Chat {
+namespace Log {
+
+    /** @brief Severity of a record. */
+    enum class Level : quint8 { Critical, Error, Warn, Info, Debug };
+
+    /** @brief Subsystem of a call site; each one has its own runtime level. */
+    enum class Module : quint8 { Core, Transport, Session, Security, Commands, Storage, Count };
+
+    /** @brief Number of modules (size of the level table). */
+    constexpr int MODULE_COUNT = static_cast<int>(Module::Count);
+
+    namespace Detail {
+        /** @brief True if @p path has a component starting with @p dir (e.g. "security/"). */
+        constexpr bool hasComponent(const char* path, const char* dir) {
+            for (const char* p = path; *p; ++p) {
+                if (p != path && p[-1] != '/' && p[-1] != '\\') {
+                    continue;
+                }
+                const char* a = p;
+                const char* b = dir;
+                while (*b && *a == *b) {
+                    ++a;
+                    ++b;
+                }
+                if (!*b) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } /* namespace Detail */
+
+    /**
+     * @brief Module of a source file, from the directory it lives in.
+     * Evaluated at compile time on __FILE__, so call sites need no annotation.
+     */
+    constexpr Module moduleOf(const char* file) {
+        return Detail::hasComponent(file, "transport/")       ? Module::Transport
+             : Detail::hasComponent(file, "network/")
+               || Detail::hasComponent(file, "threading/")
+               || Detail::hasComponent(file, "SessionManager.") ? Module::Session
+             : Detail::hasComponent(file, "security/")        ? Module::Security
+             : Detail::hasComponent(file, "handlers/")        ? Module::Commands
+             : Detail::hasComponent(file, "storage/")         ? Module::Storage
+             :                                                  Module::Core;
+    }
+
+    /** @brief Most verbose level enabled, per module (indexed by Module). */
+    extern std::atomic<quint8> g_levels[MODULE_COUNT];
+
+    /**
+     * @brief Whether a statement of @p level in module @p M is emitted.
+     * The module is a template argument so the table slot is a constant:
+     * the whole check is one relaxed load and a compare.
+     */
+    template <Module M>
+    inline bool enabled(Level level) {
+        return static_cast<quint8>(level) <= g_levels[static_cast<int>(M)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Static description of one EMIT_* call site.
+     * Records carry a pointer to it instead of any text: it is their format id.
+     */
+    struct Site {
+        const char* file;
+        int line;
+        Level level;
+    };
+
+    /** @brief Kinds of encoded arguments. */
+    enum class ArgType : quint8 { Int, UInt, Double, Bool, Char, Utf8, Utf16 };
+
+    /**
+     * @brief One log statement being built: EMIT_INFO() << a << b;
+     *
+     * Arguments are copied into a small stack buffer in binary form (numbers
+     * as 8 bytes, strings as raw bytes); nothing is formatted on the calling
+     * thread. The destructor hands the record to the calling thread's ring,
+     * a fixed-size single-producer/single-consumer buffer, without locking.
+     * A background thread decodes the rings, formats the lines and writes
+     * them in batches. If a ring is full the record is dropped and counted,
+     * so logging never blocks a caller.
+     *
+     * Types without a binary form here are formatted through QDebug at the
+     * call site, as before.
+     */
+    class Record {
+    public:
+        explicit Record(const Site* site) noexcept;
+        ~Record();
+
+        Record(const Record&) = delete;
+        Record& operator=(const Record&) = delete;
+
+        Record& operator<<(const char* text) { return utf8(text, text ? std::strlen(text) : 0); }
+        Record& operator<<(const std::string& text) { return utf8(text.data(), text.size()); }
+        Record& operator<<(const QByteArray& bytes) { return utf8(bytes.constData(), static_cast<size_t>(bytes.size())); }
+        Record& operator<<(const QString& text) {
+            return raw(ArgType::Utf16, text.utf16(), static_cast<size_t>(text.size()) * sizeof(ushort));
+        }
+
+        template <class T>
+        Record& operator<<(const T& value) {
+            if constexpr (std::is_same<T, bool>::value) {
+                put(ArgType::Bool, value ? 1u : 0u);
+            } else if constexpr (std::is_same<T, char>::value) {
+                put(ArgType::Char, static_cast<quint64>(static_cast<unsigned char>(value)));
+            } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+                put(ArgType::Int, static_cast<quint64>(static_cast<qint64>(value)));
+            } else if constexpr (std::is_integral<T>::value) {
+                put(ArgType::UInt, static_cast<quint64>(value));
+            } else if constexpr (std::is_floating_point<T>::value) {
+                const double d = static_cast<double>(value);
+                quint64 bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                put(ArgType::Double, bits);
+            } else if constexpr (std::is_convertible<T, const char*>::value) {
+                *this << static_cast<const char*>(value);
+            } else {
+                QString text;
+                QDebug(&text).noquote().nospace() << value;
+                *this << text;
+            }
+            return *this;
+        }
+
+    private:
+        /** @brief Appends a fixed-size argument. */
+        void put(ArgType type, quint64 bits);
+
+        Record& utf8(const char* data, size_t size) { return raw(ArgType::Utf8, data, size); }
+
+        /** @brief Appends a variable-size argument (truncated to what fits). */
+        Record& raw(ArgType type, const void* data, size_t size);
+
+        /** @brief Header followed by the encoded arguments. */
+        alignas(8) unsigned char m_data[Constants::LOG_MAX_RECORD_BYTES];
+
+        /** @brief Bytes of m_data in use. */
+        size_t m_size;
+    };
+
+    /** @brief Writes out everything logged so far; returns when it is written. */
+    void flush();
+
+    /** @brief Records dropped because their thread's ring was full. */
+    quint64 dropped();
+
+    /** @brief Sets the most verbose level emitted by @p module. */
+    void setLevel(Module module, Level level);
+
+    /** @brief Current level of @p module. */
+    Level level(Module module);
+
+    /**
+     * @brief Records the current levels (those set on the command line) as the
+     * ones resetLevels() restores. Call once, before installSignalHandlers().
+     */
+    void saveStartupLevels();
+
+    /** @brief Puts every module back to its startup level (see saveStartupLevels()). */
+    void resetLevels();
+
+    /**
+     * @brief Applies one level setting: "<level>" (every module), "<module>=<level>"
+     * or "default" (resetLevels()).
+     * Names are case-insensitive; "all" stands for every module.
+     * @return false (and nothing changed) if the setting is malformed.
+     */
+    bool configure(const QString& setting);
+
+    /** @brief True if configure() would accept @p setting. */
+    bool isValidSetting(const QString& setting);
+
+    /** @brief Current levels as "core=error transport=info ...". */
+    QString describeLevels();
+
+    /**
+     * @brief Lets signals change the levels of a running process:
+     * SIGUSR1 makes every module one level more verbose, SIGUSR2 restores the
+     * startup levels.
+     * Does nothing on platforms without these signals.
+     */
+    void installSignalHandlers();
+
+    const char* levelName(Level level);
+    const char* moduleName(Module module);
+
+} /* namespace Log */
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* LOG_BACKEND_H */
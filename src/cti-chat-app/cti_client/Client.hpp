@@ -19,9 +19,11 @@
 
 // Other
 #include <iostream>
+#include <memory>
 #include <string>
 #include <cstdio>
 #include "error_emitter.hpp"
+#include "codec/FrameCodec.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -94,9 +96,46 @@ public slots:
     }
 
 private slots:
-    void onConnected() { EMIT_DEBUG() << "Connected to server."; }
+    void onConnected() {
+        EMIT_DEBUG() << "Connected to server.";
+        // Offer every codec this build can decode; the server picks the first it supports.
+        sendMessage("COMPRESS " + FrameCodec::available().join(','));
+    }
     void onReadyRead() {
-        EMIT_DEBUG() << "Received:" << m_socket->readAll();
+        m_buffer.append(m_socket->readAll());
+
+        while (!m_buffer.isEmpty()) {
+            // Compressed frame: decode block by block as the bytes arrive. Only
+            // a frame that starts with the marker is compressed; the same bytes
+            // inside a plain frame are ordinary data.
+            const QByteArray magic(FrameCodec::MAGIC);
+            if (m_decoder || (m_frameStart && m_buffer.startsWith(magic))) {
+                if (!m_decoder) m_decoder = std::make_unique<FrameCodec::Decoder>();
+                if (!m_decoder->feed(&m_buffer, &m_frame)) {
+                    EMIT_ERROR() << "Malformed compressed frame, dropping buffered data.";
+                    m_buffer.clear();
+                    m_frame.clear();
+                    m_decoder.reset();
+                    return;
+                }
+                if (!m_decoder->finished()) return;
+                m_decoder.reset();
+                m_frameStart = true;
+                EMIT_DEBUG() << "Received:" << m_frame;
+                m_frame.clear();
+                continue;
+            }
+
+            // A frame start that may still become the marker: wait for more bytes.
+            if (m_frameStart && m_buffer.size() < magic.size() && magic.startsWith(m_buffer)) return;
+
+            // Plain data: the rest of the current frame, up to and including its ';'.
+            const qsizetype end = m_buffer.indexOf(';');
+            const qsizetype plain = (end < 0) ? m_buffer.size() : end + 1;
+            m_frameStart = (end >= 0);
+            EMIT_DEBUG() << "Received:" << m_buffer.left(plain);
+            m_buffer.remove(0, plain);
+        }
     }
     void onError(QAbstractSocket::SocketError) {
         EMIT_DEBUG() << "Socket Error:" << m_socket->errorString();
@@ -105,6 +144,10 @@ private slots:
 private:
     QTcpSocket* m_socket;
     ConsoleInputHandler* m_inputHandler;
+    QByteArray m_buffer;                               // bytes not yet shown
+    QByteArray m_frame;                                // decoded part of the current compressed frame
+    std::unique_ptr<FrameCodec::Decoder> m_decoder;    // set while a compressed frame is open
+    bool m_frameStart = true;                          // m_buffer begins a new frame
 };
 
 } /* namespace Chat */
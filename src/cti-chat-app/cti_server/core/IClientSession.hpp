@@ -14,6 +14,7 @@
 
 // Qt Depends
 #include <QByteArray>
+#include <QByteArrayList>
 
 // Other
 #include <vector>
@@ -50,6 +51,12 @@ public:
      * @param data The raw byte array to be sent to the client.
      */
     virtual void send(const QByteArray& data) = 0;
+
+    /**
+     * @brief Sends one frame made of consecutive buffers (header, body...).
+     * @param parts The buffers, written in order without being joined.
+     */
+    virtual void send(const QByteArrayList& parts) = 0;
     
     /** @brief Returns the current clientInfo */
     virtual const ClientInfo* getClientInfo() = 0;
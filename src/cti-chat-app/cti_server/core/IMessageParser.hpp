@@ -15,6 +15,7 @@
 
 // Qt Depends
 #include <QByteArray>
+#include <QByteArrayList>
 
 // Other
 #include <vector>
@@ -56,16 +57,18 @@ public:
     virtual Message parse(const QByteArray& data) = 0;
 
     /**
-     * @brief Serializes a Message object into a raw byte array.
+     * @brief Serializes a Message object into the buffers of one frame.
      * 
      * This pure virtual function prepares a Message object for network 
      * transmission by converting its fields into the protocol-specific 
      * byte format.
      * 
      * @param msg The Message object to be serialized.
-     * @return A QByteArray containing the formatted data ready for transport.
+     * @return The frame as consecutive buffers, written to the socket one
+     *         after the other; large shared buffers (Message::body) can be
+     *         passed through without being copied into a single array.
      */
-    virtual QByteArray serialize(const Message& msg) = 0;
+    virtual QByteArrayList serialize(const Message& msg) = 0;
 };
 
 } /* namespace Chat */
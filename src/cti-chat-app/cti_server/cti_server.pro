@@ -16,9 +16,11 @@ include(../common/common.pri)
 INCLUDEPATH += \
         $$PWD/core \
         $$PWD/domain \
+        $$PWD/metrics \
         $$PWD/network \
         $$PWD/security \
         $$PWD/server \
+        $$PWD/storage \
         $$PWD/threading \
         $$PWD/transport \
 
@@ -32,34 +34,88 @@ CONFIG(debug, debug|release) {
 # QT += \
 # 	core
 
+# GREP, the full-text index build and CHECKSUM use the global thread pool
+QT += concurrent
+
+# --tls (TlsContext/TlsChannel) is available when OpenSSL is found
+packagesExist(openssl) {
+    DEFINES += CTI_HAVE_OPENSSL
+    PKGCONFIG += openssl
+}
+
 TARGET = cti_server
 TEMPLATE = app
 
 SOURCES += \
 	main.cpp \
     network/ClientSession.cpp \
+    network/RequestPipeline.cpp \
     server/ChatServer.cpp \
     threading/SessionThread.cpp \
     transport/TcpServer.cpp \
+    transport/TlsContext.cpp \
+    transport/TlsChannel.cpp \
     server/SessionManager.cpp \
+    security/AuthSessionTable.cpp \
+    security/CredentialStore.cpp \
+    security/RateLimitPolicy.cpp \
+    metrics/Metrics.cpp \
+    storage/RootDirectory.cpp \
+    storage/MetadataIndex.cpp \
+    storage/ContentCache.cpp \
+    storage/AppendWriter.cpp \
+    storage/FileLockManager.cpp \
+    storage/AtomicWriter.cpp \
+    storage/ContentSearch.cpp \
+    storage/FullTextIndex.cpp \
+    storage/WatchRegistry.cpp \
+    storage/ContentDigest.cpp \
+    storage/DeltaSync.cpp \
 
 HEADERS += \
     core/IMessageHandler.hpp \
     core/IMessageParser.hpp \
     core/IServer.hpp \
+    domain/AuthTicket.hpp \
     domain/ClientInfo.hpp \
     domain/Message.hpp \
+    domain/TokenBucket.hpp \
     network/ClientSession.hpp \
+    network/RequestPipeline.hpp \
     server/ChatServer.hpp \
     threading/SessionThread.hpp \
     transport/TcpServer.hpp \
+    transport/TlsContext.hpp \
+    transport/TlsChannel.hpp \
     server/SessionManager.hpp \
     core/IClientSession.hpp \
     security/ModerateSecurityPolicy.hpp \
+    security/AuthSessionTable.hpp \
+    security/CredentialStore.hpp \
+    security/RateLimitPolicy.hpp \
+    metrics/Metrics.hpp \
     server/handlers/EchoMessageHandler.hpp \
     server/handlers/CmdMessageHandler.hpp \
     security/ISecurityPolicy.hpp \
     server/parsers/RawMessageParser.hpp \
+    server/handlers/cmd_message_handler/ICommand.hpp \
+    server/handlers/cmd_message_handler/CommandFactory.hpp \
+    server/handlers/cmd_message_handler/FileCommands.hpp \
+    storage/RootDirectory.hpp \
+    storage/MetadataIndex.hpp \
+    storage/FileServices.hpp \
+    storage/ContentCache.hpp \
+    storage/AppendWriter.hpp \
+    storage/FileLockManager.hpp \
+    storage/AtomicWriter.hpp \
+    storage/ContentSearch.hpp \
+    storage/FullTextIndex.hpp \
+    storage/WatchRegistry.hpp \
+    storage/ContentDigest.hpp \
+    storage/DeltaSync.hpp \
+    server/handlers/cmd_message_handler/AdminCommands.hpp \
+    server/handlers/cmd_message_handler/SearchCommands.hpp \
+    server/handlers/cmd_message_handler/SyncCommands.hpp \
     
 
 
@@ -0,0 +1,146 @@
+/**
+ * @file AuthTicket.hpp
+ * @brief Definition of the AuthTicket class, the authentication state of one session.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file contains the per-connection authentication record that commands
+ * consult instead of the shared session table.
+ */
+
+#ifndef AUTHTICKET_HPP
+#define AUTHTICKET_HPP
+
+// Qt Depends
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+// Other
+#include <atomic>
+#include <chrono>
+#include "domain/TokenBucket.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class AuthTicket
+ * @brief Whether (and as whom) a session is authenticated.
+ *
+ * Owned by the session's ClientInfo and attached to every Message the
+ * session produces. AUTH grants it; the shared session table keeps a
+ * reference only so it can revoke it (eviction). The per-command check is a
+ * single atomic load, with no lock and no table lookup.
+ *
+ * Activity is recorded here too (touch()), with a relaxed store; the session
+ * table reads it when it decides what is idle, so commands never have to
+ * reorder the table themselves.
+ *
+ * Being the one per-session object every Message carries, it also holds the
+ * session's rate-limit buckets (rate()), so RateLimitPolicy finds them
+ * without a lookup.
+ */
+class AuthTicket {
+public:
+    /**
+     * @brief Marks the session as authenticated as @p username.
+     * @param admin Whether the user may run administrative commands.
+     */
+    void grant(const QString& username, bool admin = false) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_username = username;
+        }
+        m_admin.store(admin, std::memory_order_relaxed);
+        m_grants.fetch_add(1, std::memory_order_release);
+        touch();
+        m_authorized.store(true, std::memory_order_release);
+    }
+
+    /** @brief Withdraws the authentication (evicted or logged out). */
+    void revoke() {
+        m_authorized.store(false, std::memory_order_release);
+    }
+
+    /** @brief True while the session is authenticated. */
+    bool isAuthorized() const {
+        return m_authorized.load(std::memory_order_acquire);
+    }
+
+    /** @brief True while the session is authenticated as an administrator. */
+    bool isAdmin() const {
+        return isAuthorized() && m_admin.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Records activity of the session. */
+    void touch() {
+        m_lastActiveMs.store(nowMs(), std::memory_order_relaxed);
+    }
+
+    /** @brief Time of the last grant() or touch() (steady clock, ms). */
+    qint64 lastActiveMs() const {
+        return m_lastActiveMs.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Current time on the steady clock used for activity, in ms. */
+    static qint64 nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** @brief The user the session authenticated as (empty if never granted). */
+    QString username() const {
+        QMutexLocker locker(&m_mutex);
+        return m_username;
+    }
+
+    /** @brief Number of grant() calls; changes whenever the user may have changed. */
+    quint64 grants() const {
+        return m_grants.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @struct Rate
+     * @brief Rate-limit state of the session, maintained by RateLimitPolicy.
+     */
+    struct Rate {
+        /** @brief Buckets of this session. */
+        RateBuckets session;
+        /** @brief Buckets of the authenticated user (owned by the policy). */
+        std::atomic<RateBuckets*> user{nullptr};
+        /** @brief grants() value @c user was resolved for. */
+        std::atomic<quint64> userGrant{0};
+    };
+
+    /** @brief Rate-limit state of the session. */
+    Rate& rate() { return m_rate; }
+
+private:
+    /** @brief Hot flag read by every command. */
+    std::atomic<bool> m_authorized{false};
+
+    /** @brief Administrator role of the granted user. */
+    std::atomic<bool> m_admin{false};
+
+    /** @brief Last activity (steady clock, ms). */
+    std::atomic<qint64> m_lastActiveMs{0};
+
+    /** @brief Protects m_username (rarely read). */
+    mutable QMutex m_mutex;
+
+    /** @brief Authenticated user name. */
+    QString m_username;
+
+    /** @brief Bumped by every grant(). */
+    std::atomic<quint64> m_grants{0};
+
+    /** @brief Rate-limit buckets. */
+    Rate m_rate;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* AUTHTICKET_HPP */
@@ -15,7 +15,9 @@
 // Qt Depends
 
 // Other
+#include <memory>
 #include <string>
+#include "domain/AuthTicket.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -35,6 +37,12 @@ public:
      * This ID is used by the server to route messages and track user sessions.
      */
     std::string id;
+
+    /**
+     * @brief Authentication state of this client, granted by AUTH.
+     * Attached to every message the client sends.
+     */
+    std::shared_ptr<AuthTicket> auth = std::make_shared<AuthTicket>();
 };
 
 } /* namespace Chat */
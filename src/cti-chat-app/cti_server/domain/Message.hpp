@@ -9,8 +9,11 @@
 #ifndef MESSAGE_HPP
 #define MESSAGE_HPP
 
+#include <QByteArray>
+#include <memory>
 #include <string>
 #include <utility>
+#include "domain/AuthTicket.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -43,7 +46,7 @@ public:
      * @brief Equality operator for unit testing and logic comparison.
      */
     bool operator==(const Message& other) const {
-        return (senderId == other.senderId && payload == other.payload);
+        return (senderId == other.senderId && payload == other.payload && body == other.body);
     }
 
     /** 
@@ -55,6 +58,22 @@ public:
      * @brief The actual content or command data of the message. 
      */
     std::string payload;    
+
+    /**
+     * @brief Optional bulk data sent verbatim after the payload.
+     *
+     * Used for file contents in responses. QByteArray is implicitly shared,
+     * so a buffer owned by a cache can be attached here without copying.
+     */
+    QByteArray body;
+
+    /**
+     * @brief Authentication state of the sending session.
+     *
+     * Set by the ChatServer for client messages (null for server messages).
+     * Shared with the session, so AUTH granted by one message is seen by the next.
+     */
+    std::shared_ptr<AuthTicket> auth;
 };
 
 } /* namespace Chat */
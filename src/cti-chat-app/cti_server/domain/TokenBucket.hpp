@@ -0,0 +1,109 @@
+/**
+ * @file TokenBucket.hpp
+ * @brief Definition of the TokenBucket class, a lock-free rate limiter.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file contains the bucket used by RateLimitPolicy for requests per
+ * second and bytes per second, per session and per user. It is a plain value
+ * type with no policy in it, so the session's AuthTicket can embed it.
+ */
+
+#ifndef TOKENBUCKET_HPP
+#define TOKENBUCKET_HPP
+
+// Qt Depends
+#include <QtGlobal>
+
+// Other
+#include <atomic>
+#include <chrono>
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class TokenBucket
+ * @brief Token bucket kept in one atomic word.
+ *
+ * Instead of a token count and a refill time, the bucket stores the time at
+ * which it will be full again (the "theoretical arrival time" of the generic
+ * cell rate algorithm, which admits exactly what a token bucket admits).
+ * Taking tokens moves that time forward by amount / rate; the request is
+ * refused when it would land further than burst / rate in the future. One
+ * compare-and-swap per check, no lock, and an idle bucket needs no timer.
+ *
+ * Rate and burst are passed on every call, so the bucket itself is a single
+ * word and many can be embedded in per-session objects.
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief Takes @p amount tokens if the bucket holds them.
+     * @param amount Tokens wanted (1 per request, or a byte count).
+     * @param ratePerSec Refill rate; 0 disables the bucket.
+     * @param burst Capacity of the bucket.
+     * @param nowNs Current time from nowNs().
+     * @return false (and nothing taken) if the bucket is short.
+     */
+    bool tryTake(qint64 amount, qint64 ratePerSec, qint64 burst, qint64 nowNs) {
+        if (ratePerSec <= 0) {
+            return true;
+        }
+        const qint64 cost = toNs(amount, ratePerSec);
+        const qint64 capacity = toNs(qMax(burst, amount), ratePerSec);
+
+        qint64 full = m_fullAtNs.load(std::memory_order_relaxed);
+        for (;;) {
+            const qint64 next = qMax(full, nowNs) + cost;
+            if (next - nowNs > capacity) {
+                return false;
+            }
+            if (m_fullAtNs.compare_exchange_weak(full, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns @p amount tokens taken by tryTake() for a request refused later on.
+     * @param amount Tokens to return.
+     * @param ratePerSec Refill rate passed to tryTake().
+     */
+    void giveBack(qint64 amount, qint64 ratePerSec) {
+        if (ratePerSec <= 0) {
+            return;
+        }
+        m_fullAtNs.fetch_sub(toNs(amount, ratePerSec), std::memory_order_relaxed);
+    }
+
+    /** @brief Steady-clock time in ns. */
+    static qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    /** @brief Time @p amount tokens take to refill. */
+    static qint64 toNs(qint64 amount, qint64 ratePerSec) {
+        return static_cast<qint64>(static_cast<double>(amount) * 1e9 / static_cast<double>(ratePerSec));
+    }
+
+    /** @brief Time at which the bucket is full again (0: full). */
+    std::atomic<qint64> m_fullAtNs{0};
+};
+
+/**
+ * @struct RateBuckets
+ * @brief Requests-per-second and bytes-per-second buckets of one client.
+ */
+struct RateBuckets {
+    TokenBucket requests;
+    TokenBucket bytes;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* TOKENBUCKET_HPP */
@@ -12,16 +12,23 @@
 
 // Qt Depends
 #include <QCoreApplication>
+#include <QCommandLineParser>
 #include <QByteArray>
+#include <QDir>
+#include <QTimer>
 
 // Other
 #include "transport/TcpServer.hpp"
+#include "transport/TlsContext.hpp"
 #include "server/ChatServer.hpp"
 #include "constants.hpp"
+#include "error/error_emitter.hpp"
 
 #include "security/ModerateSecurityPolicy.hpp"
+#include "security/RateLimitPolicy.hpp"
 #include "server/parsers/RawMessageParser.hpp"
 #include "server/handlers/CmdMessageHandler.hpp"
+#include "storage/FileServices.hpp"
 
 using namespace CTI::Chat;
 
@@ -42,17 +49,103 @@ int main(int argc, char *argv[]) {
     // Step 1: Initialize the Qt Core Application to manage the event loop
     QCoreApplication app(argc, argv);
 
+    // The served directory; every file command is confined beneath it.
+    QCommandLineParser cli;
+    cli.addHelpOption();
+    const QCommandLineOption rootOption(QStringLiteral("root"),
+                                        QStringLiteral("Directory served to clients."),
+                                        QStringLiteral("dir"), Constants::SERVED_ROOT_PATH);
+    cli.addOption(rootOption);
+
+    // Optional TLS on the listening port (plaintext by default); keys live next to the binary.
+    const QDir binaryDir(QCoreApplication::applicationDirPath());
+    const QCommandLineOption tlsOption(QStringLiteral("tls"),
+                                       QStringLiteral("Accept TLS connections only."));
+    const QCommandLineOption certOption(QStringLiteral("cert"),
+                                        QStringLiteral("PEM certificate chain for --tls."),
+                                        QStringLiteral("file"), binaryDir.filePath(Constants::SERVER_CERT_PATH));
+    const QCommandLineOption keyOption(QStringLiteral("key"),
+                                       QStringLiteral("PEM private key for --tls (outside the served directory)."),
+                                       QStringLiteral("file"), binaryDir.filePath(Constants::SERVER_KEY_PATH));
+    cli.addOption(tlsOption);
+    cli.addOption(certOption);
+    cli.addOption(keyOption);
+
+    // Runtime log levels; also changed later by LOGLEVEL or SIGUSR1/SIGUSR2.
+    const QCommandLineOption logOption(QStringLiteral("log"),
+                                       QStringLiteral("Log levels: <level> or <module>=<level>, comma separated "
+                                                      "(modules: core, transport, session, security, commands, storage)."),
+                                       QStringLiteral("levels"));
+    cli.addOption(logOption);
+
+    // User database; by default next to the binary, never under the served root.
+    const QCommandLineOption credentialsOption(QStringLiteral("credentials"),
+                                               QStringLiteral("User database of AUTH (outside the served directory)."),
+                                               QStringLiteral("file"),
+                                               binaryDir.filePath(Constants::CREDENTIALS_PATH));
+    cli.addOption(credentialsOption);
+
+    // Demo accounts for a checkout without configs/credentials.db (never in production).
+    const QCommandLineOption demoUsersOption(QStringLiteral("demo-users"),
+                                             QStringLiteral("Accept the built-in demo accounts while the "
+                                                            "credentials file is missing (development only)."));
+    cli.addOption(demoUsersOption);
+    cli.process(app);
+    for (const QString& setting : cli.value(logOption).split(',', Qt::SkipEmptyParts)) {
+        if (!Log::configure(setting)) {
+            EMIT_ERROR() << "Invalid --log setting:" << setting;
+            return 1;
+        }
+    }
+    // "LOGLEVEL default" and SIGUSR2 come back to the --log levels.
+    Log::saveStartupLevels();
+    Log::installSignalHandlers();
+
+    const QString root = cli.value(rootOption);
+    if (!QDir(root).exists()) {
+        EMIT_ERROR() << "Served directory does not exist:" << root;
+        return 1;
+    }
+
     // Step 2: Component Instantiation (Dependency Injection setup)
     // Here we choose the specific behaviors for parsing, handling, and security.
     
     /** @brief Concrete implementation for raw message parsing. */
     auto parser   = std::make_shared<RawMessageParser>();
     
+    /** @brief Storage services (metadata index) for the served directory. */
+    auto files    = std::make_shared<FileServices>(root);
+
+    // Server-private files must not be reachable through the file commands.
+    const QString credentialsPath = cli.value(credentialsOption);
+    if (files->dir().contains(credentialsPath)) {
+        EMIT_ERROR() << "Credentials file" << credentialsPath << "lies in the served directory"
+                     << files->root() << "; use --credentials to move it out.";
+        return 1;
+    }
+    SecurityState::setCredentialsPath(credentialsPath);
+
+    /** @brief One TLS context (and session cache) for every connection. */
+    std::shared_ptr<TlsContext> tls;
+    if (cli.isSet(tlsOption)) {
+        for (const QCommandLineOption* option : {&certOption, &keyOption}) {
+            if (files->dir().contains(cli.value(*option))) {
+                EMIT_ERROR() << "TLS file" << cli.value(*option) << "lies in the served directory"
+                             << files->root() << "; refusing --tls.";
+                return 1;
+            }
+        }
+        tls = TlsContext::create(cli.value(certOption), cli.value(keyOption));
+        if (!tls) {
+            return 1;
+        }
+    }
+
+    /** @brief Concrete implementation of the security policy (Moderate level, rate limited). */
+    auto security = std::make_shared<RateLimitPolicy>(std::make_shared<ModerateSecurityPolicy>());
+
     /** @brief Concrete implementation for handling messages (Cmd strategy). */
-    auto handler  = std::make_shared<CmdMessageHandler>();
-    
-    /** @brief Concrete implementation of the security policy (Moderate level). */
-    auto security = std::make_shared<ModerateSecurityPolicy>();
+    auto handler  = std::make_shared<CmdMessageHandler>(files, security);
     
     /** @brief The central session registry for tracking connected users. */
     auto sessions = std::make_shared<SessionManager>();
@@ -65,9 +158,37 @@ int main(int argc, char *argv[]) {
                                     security, 
                                     sessions);
 
+    // Wire server-initiated pushes: WATCH events go out through the logic layer,
+    // and a client's subscriptions are dropped when its session ends.
+    std::weak_ptr<ChatServer> weakLogic = logic;
+    files->watches().setSink([weakLogic](const std::string& clientId, const QString& event) {
+        if (auto server = weakLogic.lock()) {
+            server->notify(Message{event.toStdString(), "Server"}, clientId);
+        }
+    });
+    sessions->addRemoveListener([files](const std::string& clientId) {
+        files->watches().unwatchAll(clientId);
+    });
+
+    // Load the user database (and hash the demo accounts, if enabled) before the first AUTH.
+    if (cli.isSet(demoUsersOption)) {
+        SecurityState::enableDemoUsers();
+    }
+    SecurityState::credentials();
+
+    // Authenticated sessions end with their connection, or after being idle.
+    sessions->addRemoveListener([](const std::string& clientId) {
+        SecurityState::sessions().logout(QString::fromStdString(clientId));
+    });
+    QTimer authSweep;
+    QObject::connect(&authSweep, &QTimer::timeout, [] {
+        SecurityState::sessions().expire();
+    });
+    authSweep.start(Constants::AUTH_SWEEP_INTERVAL_MS);
+
     // Step 4: Configure and start the Network Transport layer
     // Instantiate the TCP server and bind it to the default port.
-    TcpServer server(logic, sessions);
+    TcpServer server(logic, sessions, tls);
     
     bool isListening = server.listen(
         QHostAddress::Any,
@@ -0,0 +1,330 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the per-thread metrics shards and their merge.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+// Other
+#include "Metrics.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+constexpr int MAX_VERBS = Constants::METRICS_MAX_VERBS;
+
+/**
+ * @struct Shard
+ * @brief Counters of one thread. Only that thread writes them.
+ *
+ * Value-initialized (new Shard()), which zeroes every cell.
+ */
+struct Shard {
+    struct Hist {
+        std::atomic<quint64> sum;
+        std::atomic<quint64> max;
+        std::atomic<quint64> buckets[Metrics::BUCKETS];
+    };
+
+    Hist histograms[Metrics::HISTOGRAM_COUNT];
+    std::atomic<quint64> counters[Metrics::COUNTER_COUNT];
+    std::atomic<qint64> gauges[Metrics::GAUGE_COUNT];
+    std::atomic<quint64> verbCount[MAX_VERBS];
+    std::atomic<quint64> verbErrors[MAX_VERBS];
+    std::atomic<quint64> verbNanos[MAX_VERBS];
+};
+
+/** @brief Single-writer increment: a plain load and store, no locked instruction. */
+template <class T>
+inline void bump(std::atomic<T>& cell, T amount) {
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/** @brief Adds the current values of @p shard to @p out. */
+void accumulate(const Shard& shard, Metrics::Snapshot* out) {
+    for (int h = 0; h < Metrics::HISTOGRAM_COUNT; ++h) {
+        const Shard::Hist& from = shard.histograms[h];
+        Metrics::Distribution& to = out->histograms[h];
+        for (int b = 0; b < Metrics::BUCKETS; ++b) {
+            const quint64 n = from.buckets[b].load(std::memory_order_relaxed);
+            to.buckets[b] += n;
+            to.count += n;
+        }
+        to.sum += from.sum.load(std::memory_order_relaxed);
+        to.max = qMax(to.max, from.max.load(std::memory_order_relaxed));
+    }
+    for (int c = 0; c < Metrics::COUNTER_COUNT; ++c) {
+        out->counters[c] += shard.counters[c].load(std::memory_order_relaxed);
+    }
+    for (int g = 0; g < Metrics::GAUGE_COUNT; ++g) {
+        out->gauges[g] += shard.gauges[g].load(std::memory_order_relaxed);
+    }
+    for (int v = 0; v < MAX_VERBS; ++v) {
+        Metrics::Verb& verb = out->verbs[v];
+        verb.count  += shard.verbCount[v].load(std::memory_order_relaxed);
+        verb.errors += shard.verbErrors[v].load(std::memory_order_relaxed);
+        verb.nanos  += shard.verbNanos[v].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @class Registry
+ * @brief Live shards, the totals of exited threads and the verb names.
+ *
+ * Never destroyed: threads may record until the very end of the process.
+ */
+class Registry {
+public:
+    static Registry& instance() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    /** @brief Creates and registers the calling thread's shard. */
+    Shard* attach() {
+        auto* shard = new Shard();
+        QMutexLocker locker(&m_mutex);
+        m_shards.push_back(shard);
+        return shard;
+    }
+
+    /** @brief Folds an exiting thread's shard into the totals and frees it. */
+    void retire(Shard* shard) {
+        QMutexLocker locker(&m_mutex);
+        accumulate(*shard, &m_retired);
+        m_shards.erase(std::find(m_shards.begin(), m_shards.end(), shard));
+        delete shard;
+    }
+
+    int registerVerb(const QString& name) {
+        QMutexLocker locker(&m_mutex);
+        const int existing = m_verbNames.indexOf(name);
+        if (existing >= 0) {
+            return existing;
+        }
+        if (m_verbNames.size() >= MAX_VERBS) {
+            return Metrics::UNKNOWN_VERB;
+        }
+        m_verbNames.append(name);
+        return m_verbNames.size() - 1;
+    }
+
+    std::shared_ptr<Metrics::SessionCounters> openSession(const std::string& id) {
+        auto session = std::make_shared<Metrics::SessionCounters>();
+        session->id = id;
+        QMutexLocker locker(&m_mutex);
+        m_sessions.erase(std::remove_if(m_sessions.begin(), m_sessions.end(),
+                                        [](const std::weak_ptr<Metrics::SessionCounters>& s) { return s.expired(); }),
+                         m_sessions.end());
+        m_sessions.push_back(session);
+        return session;
+    }
+
+    QVector<Metrics::SessionTraffic> sessions() {
+        QVector<Metrics::SessionTraffic> out;
+        QMutexLocker locker(&m_mutex);
+        for (const auto& weak : m_sessions) {
+            if (const auto session = weak.lock()) {
+                Metrics::SessionTraffic row;
+                row.id = QString::fromStdString(session->id);
+                row.bytesIn = session->bytesIn.load(std::memory_order_relaxed);
+                row.bytesOut = session->bytesOut.load(std::memory_order_relaxed);
+                out.append(row);
+            }
+        }
+        return out;
+    }
+
+    Metrics::Snapshot snapshot() {
+        QMutexLocker locker(&m_mutex);
+        Metrics::Snapshot snap = m_retired;
+        for (const Shard* shard : m_shards) {
+            accumulate(*shard, &snap);
+        }
+        snap.threads = static_cast<int>(m_shards.size());
+        snap.verbs.resize(m_verbNames.size());
+        for (int v = 0; v < m_verbNames.size(); ++v) {
+            snap.verbs[v].name = m_verbNames[v];
+        }
+        return snap;
+    }
+
+private:
+    Registry() {
+        m_retired.verbs.resize(MAX_VERBS);
+        m_verbNames.append(QStringLiteral("UNKNOWN"));
+    }
+
+    /** @brief Protects every member. */
+    QMutex m_mutex;
+
+    std::vector<Shard*> m_shards;
+
+    /** @brief Sum of the shards of exited threads (verbs sized MAX_VERBS). */
+    Metrics::Snapshot m_retired;
+
+    /** @brief Verb names by id. */
+    QVector<QString> m_verbNames;
+
+    /** @brief Traffic counters of the connections (expired ones pruned on open). */
+    std::vector<std::weak_ptr<Metrics::SessionCounters>> m_sessions;
+};
+
+/** @brief The calling thread's shard; retired when the thread exits. */
+struct ThreadShard {
+    Shard* shard = nullptr;
+    ~ThreadShard() {
+        if (shard) {
+            Registry::instance().retire(shard);
+            shard = nullptr;
+        }
+    }
+};
+thread_local ThreadShard t_shard;
+
+inline Shard& localShard() {
+    if (Q_UNLIKELY(!t_shard.shard)) {
+        t_shard.shard = Registry::instance().attach();
+    }
+    return *t_shard.shard;
+}
+
+} /* namespace */
+
+quint64 Metrics::Distribution::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(std::ceil(q * static_cast<double>(count))));
+    quint64 seen = 0;
+    for (int b = 0; b < BUCKETS - 1; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return qMin(bucketCeiling(b), max);
+        }
+    }
+    return max;
+}
+
+void Metrics::record(Histogram histogram, quint64 value) {
+    Shard::Hist& hist = localShard().histograms[static_cast<int>(histogram)];
+    bump<quint64>(hist.buckets[bucketOf(value)], 1);
+    bump(hist.sum, value);
+    if (value > hist.max.load(std::memory_order_relaxed)) {
+        hist.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::add(Counter counter, quint64 amount) {
+    bump(localShard().counters[static_cast<int>(counter)], amount);
+}
+
+void Metrics::adjust(Gauge gauge, qint64 delta) {
+    bump(localShard().gauges[static_cast<int>(gauge)], delta);
+}
+
+int Metrics::registerVerb(const QString& name) {
+    return Registry::instance().registerVerb(name);
+}
+
+void Metrics::recordVerb(int verb, quint64 nanos, bool error) {
+    Shard& shard = localShard();
+    bump<quint64>(shard.verbCount[verb], 1);
+    bump(shard.verbNanos[verb], nanos);
+    if (error) {
+        bump<quint64>(shard.verbErrors[verb], 1);
+    }
+}
+
+Metrics::Snapshot Metrics::snapshot() {
+    return Registry::instance().snapshot();
+}
+
+std::shared_ptr<Metrics::SessionCounters> Metrics::openSession(const std::string& id) {
+    return Registry::instance().openSession(id);
+}
+
+QVector<Metrics::SessionTraffic> Metrics::sessions() {
+    return Registry::instance().sessions();
+}
+
+void Metrics::received(SessionCounters& session, quint64 bytes) {
+    bump(session.bytesIn, bytes);
+    add(Counter::BytesIn, bytes);
+}
+
+void Metrics::sent(SessionCounters& session, quint64 bytes) {
+    bump(session.bytesOut, bytes);
+    add(Counter::BytesOut, bytes);
+}
+
+int Metrics::bucketOf(quint64 value) {
+    if (value < static_cast<quint64>(SUB_COUNT)) {
+        return static_cast<int>(value);
+    }
+    const int exponent = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+    if (exponent >= MAX_BITS) {
+        return BUCKETS - 1;
+    }
+    const int sub = static_cast<int>((value >> (exponent - SUB_BITS)) & (SUB_COUNT - 1));
+    return (exponent - SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+quint64 Metrics::bucketCeiling(int bucket) {
+    if (bucket < SUB_COUNT) {
+        return static_cast<quint64>(bucket);
+    }
+    const int shift = bucket / SUB_COUNT - 1;
+    const quint64 floor = static_cast<quint64>(SUB_COUNT + bucket % SUB_COUNT) << shift;
+    return floor + (quint64(1) << shift) - 1;
+}
+
+const char* Metrics::name(Histogram histogram) {
+    switch (histogram) {
+    case Histogram::Parse:      return "parse";
+    case Histogram::Validate:   return "validate";
+    case Histogram::Handle:     return "handle";
+    case Histogram::Serialize:  return "serialize";
+    case Histogram::QueueDepth: return "queue_depth";
+    case Histogram::Count:      break;
+    }
+    return "?";
+}
+
+const char* Metrics::name(Counter counter) {
+    switch (counter) {
+    case Counter::Requests:  return "requests";
+    case Counter::Rejected:  return "rejected";
+    case Counter::Busy:      return "busy";
+    case Counter::BytesIn:   return "bytes_in";
+    case Counter::BytesOut:  return "bytes_out";
+    case Counter::Count:     break;
+    }
+    return "?";
+}
+
+const char* Metrics::name(Gauge gauge) {
+    switch (gauge) {
+    case Gauge::QueuePending: return "queue_pending";
+    case Gauge::QueueRunning: return "queue_running";
+    case Gauge::Count:        break;
+    }
+    return "?";
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,214 @@
+/**
+ * @file Metrics.hpp
+ * @brief Definition of the Metrics registry: per-thread counters and latency histograms.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the server's internal measurements (request stages,
+ * command verbs, traffic, queue depths) and the snapshot the METRICS
+ * command reports.
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+// Qt Depends
+#include <QString>
+#include <QVector>
+
+// Other
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class Metrics
+ * @brief Process-wide measurements, recorded per thread and merged on read.
+ *
+ * Every thread that records gets its own shard of counters, allocated on
+ * its first measurement. A shard has a single writer, so recording is a
+ * relaxed load and store of a few thread-local words: no lock, no atomic
+ * read-modify-write, no cache line shared with another writer. snapshot()
+ * sums the shards of the live threads and the totals left by threads that
+ * have exited.
+ *
+ * Histograms are log-linear (HDR style): values below 16 have a bucket
+ * each, and every power of two above is split into 16 buckets, so a bucket
+ * is within 6.25% of the values it holds. Values from 2^35 (about 34 s when
+ * they are nanoseconds) share the last bucket.
+ *
+ * Traffic is also kept per connection (openSession()), for "METRICS sessions".
+ */
+class Metrics {
+public:
+    /** @brief Recorded distributions: latencies in nanoseconds, depths in requests. */
+    enum class Histogram { Parse, Validate, Handle, Serialize, QueueDepth, Count };
+
+    /** @brief Monotonic counters. */
+    enum class Counter { Requests, Rejected, Busy, BytesIn, BytesOut, Count };
+
+    /** @brief Levels that go up and down; the shards hold deltas that sum to the level. */
+    enum class Gauge { QueuePending, QueueRunning, Count };
+
+    static constexpr int HISTOGRAM_COUNT = static_cast<int>(Histogram::Count);
+    static constexpr int COUNTER_COUNT = static_cast<int>(Counter::Count);
+    static constexpr int GAUGE_COUNT = static_cast<int>(Gauge::Count);
+
+    /** @brief Bits of a value resolved within each power of two. */
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    /** @brief Values from 2^MAX_BITS go to the last bucket. */
+    static constexpr int MAX_BITS = 35;
+    static constexpr int BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    /** @brief Verb id of unknown commands (and of verbs beyond METRICS_MAX_VERBS). */
+    static constexpr int UNKNOWN_VERB = 0;
+
+    /**
+     * @struct Distribution
+     * @brief Merged histogram.
+     */
+    struct Distribution {
+        quint64 count = 0;
+        quint64 sum = 0;
+        quint64 max = 0;
+        std::array<quint64, BUCKETS> buckets{};
+
+        /**
+         * @brief Value at quantile @p q (0..1): the upper bound of its bucket,
+         *        capped at the largest value recorded.
+         */
+        quint64 percentile(double q) const;
+    };
+
+    /**
+     * @struct Verb
+     * @brief Merged counters of one command verb.
+     */
+    struct Verb {
+        QString name;
+        quint64 count = 0;
+        quint64 errors = 0;
+        quint64 nanos = 0;
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief Everything recorded so far, summed over all threads.
+     */
+    struct Snapshot {
+        std::array<Distribution, HISTOGRAM_COUNT> histograms;
+        std::array<quint64, COUNTER_COUNT> counters{};
+        std::array<qint64, GAUGE_COUNT> gauges{};
+        /** @brief Registered verbs, by id (UNKNOWN_VERB first). */
+        QVector<Verb> verbs;
+        /** @brief Threads that have recorded and are still running. */
+        int threads = 0;
+    };
+
+    /**
+     * @struct SessionCounters
+     * @brief Traffic of one connection; written by the session's thread only.
+     */
+    struct SessionCounters {
+        std::string id;
+        std::atomic<quint64> bytesIn{0};
+        std::atomic<quint64> bytesOut{0};
+    };
+
+    /**
+     * @struct SessionTraffic
+     * @brief Snapshot of one connection's SessionCounters.
+     */
+    struct SessionTraffic {
+        QString id;
+        quint64 bytesIn = 0;
+        quint64 bytesOut = 0;
+    };
+
+    /** @brief Adds one value to a histogram. */
+    static void record(Histogram histogram, quint64 value);
+
+    /** @brief Increments a counter. */
+    static void add(Counter counter, quint64 amount = 1);
+
+    /** @brief Moves a gauge up or down. */
+    static void adjust(Gauge gauge, qint64 delta);
+
+    /**
+     * @brief Returns the id of a command verb, registering it if needed.
+     * Called when commands are registered, not per request.
+     */
+    static int registerVerb(const QString& name);
+
+    /** @brief Counts one execution of a verb. */
+    static void recordVerb(int verb, quint64 nanos, bool error);
+
+    /** @brief Merges the shards. */
+    static Snapshot snapshot();
+
+    /**
+     * @brief Creates the traffic counters of a connection.
+     * They are listed by sessions() for as long as the returned pointer lives.
+     */
+    static std::shared_ptr<SessionCounters> openSession(const std::string& id);
+
+    /** @brief Traffic of the open connections. */
+    static QVector<SessionTraffic> sessions();
+
+    /** @brief Counts bytes received on a connection (also in Counter::BytesIn). */
+    static void received(SessionCounters& session, quint64 bytes);
+
+    /** @brief Counts bytes sent on a connection (also in Counter::BytesOut). */
+    static void sent(SessionCounters& session, quint64 bytes);
+
+    /** @brief Metric name used in reports ("parse", "bytes_in", ...). */
+    static const char* name(Histogram histogram);
+    static const char* name(Counter counter);
+    static const char* name(Gauge gauge);
+
+    /** @brief Bucket of a value. */
+    static int bucketOf(quint64 value);
+
+    /** @brief Largest value that falls in @p bucket. */
+    static quint64 bucketCeiling(int bucket);
+
+    /** @brief Steady-clock time in nanoseconds. */
+    static qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @class Stopwatch
+     * @brief Times consecutive stages: each lap() records the time since the previous one.
+     */
+    class Stopwatch {
+    public:
+        Stopwatch() : m_last(nowNs()) {}
+
+        /** @brief Records the time since construction or the last lap into @p histogram. */
+        void lap(Histogram histogram) {
+            const qint64 now = nowNs();
+            record(histogram, static_cast<quint64>(now - m_last));
+            m_last = now;
+        }
+
+        /** @brief Time since construction or the last lap, without recording it. */
+        quint64 elapsed() const { return static_cast<quint64>(nowNs() - m_last); }
+
+    private:
+        qint64 m_last;
+    };
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* METRICS_HPP */
@@ -9,12 +9,17 @@
  */
 
 #include "ClientSession.hpp"
+#include <QThreadPool>
+#include <QTimer>
 #include <QUuid>
 #include "server/ChatServer.hpp"
 #include "server/SessionManager.hpp"
+#include "error/error_codes.hpp"
 #include "error/error_emitter.hpp"
 #include "constants.hpp"
 
+#include <cstring>
+
 /**
  * @namespace CTI::Chat
  * @brief Root namespace for the CoreTech Innovations Chat Application components.
@@ -32,26 +37,33 @@ namespace Chat {
  * @param socketDescriptor The native socket handle provided by the QTcpServer.
  * @param logic Shared pointer to the ChatServer logic for message processing.
  * @param sessions Pointer to the SessionManager to track active clients.
+ * @param tls Shared TLS context; null for a plaintext connection.
  * @param parent Optional QObject parent for memory management.
  */
 ClientSession::ClientSession(qintptr socketDescriptor,
                              std::shared_ptr<ChatServer> logic,
                              SessionManager* sessions,
+                             std::shared_ptr<TlsContext> tls,
                              QObject* parent)
     : QObject(parent),
       m_logic(std::move(logic)),
-      m_sessions(sessions) {
+      m_sessions(sessions),
+      m_readChunk(Constants::SESSION_READ_CHUNK_BYTES, Qt::Uninitialized),
+      m_frameLimit(qMin<qint64>(Constants::MAX_PAYLOAD_SIZE, Constants::SESSION_BUFFER_LIMIT_BYTES)),
+      m_pipeline(Constants::PIPELINE_MAX_IN_FLIGHT) {
 
     // Step 1: Initialize and configure the TCP Socket
     EMIT_INFO() << "Creating new TCP Scoket for client session.";
     m_socket = new QTcpSocket(this);
     m_socket->setSocketDescriptor(socketDescriptor);
+    m_socket->setReadBufferSize(Constants::SESSION_SOCKET_BUFFER_BYTES);
     
     // Step 2: Create a client uuid.
     m_clientInfo = new ClientInfo();
     QUuid id = QUuid::createUuid();
     m_clientInfo->id = id.toString(QUuid::WithoutBraces).toStdString();
     EMIT_INFO() << "Added new client with uuid: " << m_clientInfo->id.c_str();
+    m_traffic = Metrics::openSession(m_clientInfo->id);
 
     // Step 3: Register this session with the manager
     EMIT_DEBUG() << "Adding the session to session manager.";
@@ -63,6 +75,50 @@ ClientSession::ClientSession(qintptr socketDescriptor,
 
     connect(m_socket, &QTcpSocket::disconnected,
             this, &ClientSession::onDisconnected);
+
+    // Step 5: TLS connections must finish their handshake in time
+    if (tls) {
+        m_tls.reset(new TlsChannel(std::move(tls)));
+        QTimer::singleShot(Constants::SSL_HANDSHAKE_TIMEOUT_MS, this, [this]() {
+            if (m_tls && !m_tls->established()) {
+                EMIT_WARN() << error_code_to_string(ErrorCode::ERR_SSL_HANDSHAKE_FAILED) << "(timeout)";
+                m_tls->abandon();
+                dropTls();
+            }
+        });
+    }
+}
+
+/**
+ * @brief Writes bytes to the socket, encrypting them first on a TLS connection.
+ * @return Number of bytes accepted.
+ */
+qint64 ClientSession::transmit(const QByteArray& bytes) {
+    if (!m_tls) {
+        const qint64 written = m_socket->write(bytes);
+        if (written > 0) {
+            Metrics::sent(*m_traffic, static_cast<quint64>(written));
+        }
+        return written;
+    }
+    QByteArray records;
+    if (!m_tls->send(bytes.constData(), bytes.size(), &records)) {
+        return -1;
+    }
+    if (!records.isEmpty()) {
+        m_socket->write(records);
+        Metrics::sent(*m_traffic, static_cast<quint64>(records.size()));
+    }
+    return bytes.size();
+}
+
+/**
+ * @brief Ends a connection whose TLS layer cannot continue.
+ */
+void ClientSession::dropTls() {
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->disconnectFromHost();
+    }
 }
 
 /**
@@ -70,20 +126,124 @@ ClientSession::ClientSession(qintptr socketDescriptor,
  * 
  * Appends a delimiter (;) to the end of the byte array to ensure the 
  * client can distinguish between consecutive frames.
+ *
+ * With a negotiated codec, frames of at least m_compressMinBytes are written
+ * as a FrameCodec frame instead, one compressed block at a time, so only a
+ * single encoded block exists besides the response itself.
  * 
  * @param data The QByteArray containing the message or data to be sent.
  */
 void ClientSession::send(const QByteArray& data) {
+    send(QByteArrayList{data});
+}
+
+/**
+ * @brief Sends one frame given as consecutive buffers.
+ *
+ * The buffers are written one after the other, never joined, so a large
+ * shared body (a cached file) is not copied on its way to the socket.
+ * Compressed, each buffer is cut into its own blocks.
+ *
+ * @param parts The buffers of the frame, in order.
+ */
+void ClientSession::send(const QByteArrayList& parts) {
     // Step 1: Validate socket state
     if (!m_socket || !m_socket->isOpen()) {
         EMIT_DEBUG() << "Invalid socket.";
         return;
     }
 
-    // Step 2: Write data followed by the protocol delimiter
+    qsizetype size = 0;
+    for (const QByteArray& part : parts) {
+        size += part.size();
+    }
+
+    // Step 2: Large frames go out compressed when the client asked for it
+    if (m_compression != FrameCodec::Codec::None && size >= m_compressMinBytes) {
+        const FrameCodec::Encoder encoder(m_compression, Constants::COMPRESS_ZLIB_LEVEL);
+        qint64 written = transmit(encoder.header());
+        for (const QByteArray& part : parts) {
+            for (qsizetype offset = 0; offset < part.size(); offset += Constants::COMPRESS_BLOCK_BYTES) {
+                const int length = static_cast<int>(qMin<qsizetype>(Constants::COMPRESS_BLOCK_BYTES,
+                                                                     part.size() - offset));
+                written += transmit(encoder.block(part.constData() + offset, length));
+            }
+        }
+        written += transmit(FrameCodec::Encoder::trailer());
+        EMIT_DEBUG() << "Wrote compressed frame:" << size << "->" << written << "bytes.";
+        return;
+    }
+
+    // Step 3: Write the buffers followed by the protocol delimiter
     EMIT_DEBUG() << "Writing to socket.";
-    m_socket->write(data);
-    m_socket->write(";");
+    for (const QByteArray& part : parts) {
+        if (!part.isEmpty()) {
+            transmit(part);
+        }
+    }
+    transmit(";");
+}
+
+/**
+ * @brief Answers "COMPRESS <codec>[,<codec>...][,min=<bytes>]" and "COMPRESS off".
+ *
+ * Compression is a property of the connection, not of a command, so it is
+ * negotiated here rather than in the command handlers.
+ *
+ * @param frame One complete request frame, without its request id.
+ * @param requestId Request id to echo in the reply (may be empty).
+ * @return true if the frame was consumed.
+ */
+bool ClientSession::handleCompress(const QByteArray& frame, const QByteArray& requestId) {
+    // Step 1: Recognize the verb
+    const QByteArray request = frame.trimmed();
+    const QByteArray verb = request.left(request.indexOf(' ')).toUpper();
+    if (verb != "COMPRESS") {
+        return false;
+    }
+
+    const QByteArray tag = requestId.isEmpty() ? QByteArray() : '#' + requestId + ' ';
+
+    // Step 2: Pick the first supported codec and the optional threshold
+    FrameCodec::Codec codec = FrameCodec::Codec::None;
+    int minBytes = Constants::COMPRESS_MIN_FRAME_BYTES;
+    bool disable = false;
+    const QList<QByteArray> options = request.mid(verb.size()).split(',');
+    for (const QByteArray& raw : options) {
+        const QByteArray option = raw.trimmed().toLower();
+        if (option.startsWith("min=")) {
+            bool ok = false;
+            minBytes = option.mid(4).toInt(&ok);
+            if (!ok || minBytes < 0) {
+                send(tag + "ERROR 400 BAD_REQUEST");
+                return true;
+            }
+        } else if (option == "off" || option == "none") {
+            disable = true;
+        } else if (codec == FrameCodec::Codec::None) {
+            codec = FrameCodec::fromName(QString::fromLatin1(option));
+        }
+    }
+
+    // Step 3: Apply; the reply still goes out under the previous setting
+    if (disable) {
+        m_compression = FrameCodec::Codec::None;
+        send(tag + "OK COMPRESS none");
+        return true;
+    }
+    if (codec == FrameCodec::Codec::None) {
+        EMIT_WARN() << "COMPRESS rejected for client:" << m_clientInfo->id.c_str()
+                    << "Offered:" << request << "Available:" << FrameCodec::available();
+        send(tag + "ERROR 415 UNSUPPORTED_CODEC");
+        return true;
+    }
+
+    send(tag + QString("OK COMPRESS %1 min=%2").arg(FrameCodec::name(codec)).arg(minBytes).toUtf8());
+    m_compression = codec;
+    m_compressMinBytes = minBytes;
+    EMIT_INFO() << "Client[`" << m_clientInfo->id.c_str() << "`] negotiated compression:"
+                << FrameCodec::name(codec) << "min bytes:" << minBytes;
+    return true;
 }
 
 /**
@@ -108,13 +268,86 @@ void ClientSession::processBuffer() {
         m_buffer.remove(0, index + 1); 
 
         // Step 3: Pass non-empty frames to the server logic for processing
-        if (!frame.isEmpty()) {
+        if (frame.isEmpty()) {
+            continue;
+        }
+        RequestPipeline::Request request = RequestPipeline::classify(frame);
+        if (handleCompress(request.frame, request.tag)) {
+            continue;
+        }
+
+        // Untagged frame with nothing in flight: run it right here, as always.
+        if (request.tag.isEmpty() && !request.offload && m_pipeline.idle()) {
             EMIT_DEBUG() << "Processing message in bussiness logic.";
-            m_logic->processAndBroadcast(frame, m_clientInfo->id);
+            m_logic->processAndBroadcast(request.frame, m_clientInfo->id, m_clientInfo->auth);
+            continue;
+        }
+
+        m_pipeline.enqueue(std::move(request));
+        schedule();
+    }
+}
+
+/**
+ * @brief Starts the requests the pipeline allows to run.
+ *
+ * Barriers run synchronously on this thread (they are ordered with
+ * everything anyway), except offloaded ones (AUTH), which go to the offload
+ * pool; other requests are handed to the shared worker pool. Pooled requests
+ * report back through onRequestFinished() on this thread.
+ */
+void ClientSession::schedule() {
+    const std::string clientId = m_clientInfo->id;
+    const std::shared_ptr<AuthTicket> auth = m_clientInfo->auth;
+
+    for (;;) {
+        const QVector<RequestPipeline::Request> runnable = m_pipeline.takeRunnable();
+        if (runnable.isEmpty()) {
+            return;
+        }
+
+        for (const RequestPipeline::Request& request : runnable) {
+            if (!request.reply.isEmpty()) {
+                send(request.tag.isEmpty() ? request.reply : '#' + request.tag + ' ' + request.reply);
+                m_pipeline.finished(request);
+                continue;
+            }
+            if (request.barrier && !request.offload) {
+                m_logic->processAndBroadcast(request.frame, clientId, auth, request.tag);
+                m_pipeline.finished(request);
+                continue;
+            }
+
+            // The session outlives its running requests (see teardown()), so the
+            // completion can safely be posted back to it.
+            std::shared_ptr<ChatServer> logic = m_logic;
+            QThreadPool& workers = request.offload ? RequestPipeline::offloadPool() : RequestPipeline::pool();
+            workers.start([this, logic, clientId, auth, request]() {
+                logic->processAndBroadcast(request.frame, clientId, auth, request.tag);
+                QMetaObject::invokeMethod(this, [this, request]() {
+                    onRequestFinished(request);
+                }, Qt::QueuedConnection);
+            });
         }
     }
 }
 
+/**
+ * @brief Retires a pooled request and starts whatever it was holding back.
+ * @param request The completed request.
+ */
+void ClientSession::onRequestFinished(const RequestPipeline::Request& request) {
+    m_pipeline.finished(request);
+
+    if (m_closing) {
+        if (m_pipeline.running() == 0) {
+            teardown();
+        }
+        return;
+    }
+    schedule();
+}
+
 /**
  * @brief Slot triggered when the socket has new data available to read.
  * 
@@ -124,11 +357,112 @@ void ClientSession::processBuffer() {
 void ClientSession::onReadyRead() {
     EMIT_DEBUG() << "Data ready to read.";
     EMIT_INFO() << "Client[`" << m_clientInfo->id.c_str() << "`] sent message.";
-    // Step 1: Read incoming bytes and append to existing buffer
-    m_buffer.append(m_socket->readAll());
-    
-    // Step 2: Attempt to parse frames from the updated buffer
+    while (true) {
+        // Step 1: Read one chunk and frame it (oversized frames are dropped here)
+        const qint64 read = m_socket->read(m_readChunk.data(), m_readChunk.size());
+        if (read <= 0) {
+            break;
+        }
+        Metrics::received(*m_traffic, static_cast<quint64>(read));
+        if (m_tls) {
+            // TLS: decrypt first; handshake replies go straight back.
+            QByteArray plain;
+            QByteArray records;
+            const bool ok = m_tls->receive(m_readChunk.constData(), read, &plain, &records);
+            if (!records.isEmpty()) {
+                m_socket->write(records);
+                Metrics::sent(*m_traffic, static_cast<quint64>(records.size()));
+            }
+            if (!ok) {
+                dropTls();
+                return;
+            }
+            consume(plain.constData(), plain.size());
+        } else {
+            consume(m_readChunk.constData(), read);
+        }
+
+        // Step 2: Attempt to parse frames from the updated buffer
+        processBuffer();
+        m_frameStart = 0;
+    }
+}
+
+/**
+ * @brief Appends the bytes of @p data to m_buffer, frame by frame.
+ *
+ * The limit is checked before anything is appended, so an oversized frame
+ * costs at most m_frameLimit bytes of buffer however long it is.
+ *
+ * @param data Bytes just read from the socket.
+ * @param size Number of bytes.
+ */
+void ClientSession::consume(const char* data, qint64 size) {
+    qint64 pos = 0;
+    while (pos < size) {
+        const char* start = data + pos;
+        const char* delimiter = static_cast<const char*>(
+            std::memchr(start, Constants::DELIMITER, static_cast<size_t>(size - pos)));
+        const qint64 length = delimiter ? delimiter - start : size - pos;
+
+        // Step 1: Skip the rest of an oversized frame
+        if (m_discarding) {
+            m_discardedBytes += length;
+            if (!delimiter) {
+                return;
+            }
+            pos += length + 1;
+            rejectOversized();
+            continue;
+        }
+
+        // Step 2: Drop the frame as soon as it would pass the limit
+        const qint64 frameBytes = m_buffer.size() - m_frameStart;
+        if (frameBytes + length > m_frameLimit) {
+            QByteArray head = m_buffer.mid(static_cast<int>(m_frameStart), 64);
+            head.append(start, static_cast<int>(qMin<qint64>(length, 64 - head.size())));
+            const int space = head.indexOf(' ');
+            m_discardTag = (head.startsWith('#') && space > 1) ? head.mid(1, space - 1) : QByteArray();
+
+            m_buffer.truncate(static_cast<int>(m_frameStart));
+            m_discardedBytes = frameBytes;
+            m_discarding = true;
+            continue;
+        }
+
+        // Step 3: Keep the bytes; the delimiter closes the frame
+        m_buffer.append(start, static_cast<int>(delimiter ? length + 1 : length));
+        pos += delimiter ? length + 1 : length;
+        if (delimiter) {
+            m_frameStart = m_buffer.size();
+        }
+    }
+}
+
+/**
+ * @brief Answers the oversized frame that was just skipped.
+ *
+ * Frames completed before it are dispatched first, and the answer goes
+ * through the pipeline like a barrier, so it is not overtaken by (and does
+ * not overtake) the replies of the frames around it.
+ */
+void ClientSession::rejectOversized() {
+    EMIT_WARN() << error_code_to_string(ErrorCode::ERR_PAYLOAD_TOO_LARGE)
+                << "Client:" << m_clientInfo->id.c_str() << "Discarded bytes:" << m_discardedBytes;
+
     processBuffer();
+    m_frameStart = 0;
+
+    RequestPipeline::Request request;
+    request.tag = m_discardTag;
+    request.barrier = true;
+    request.reply = "ERROR 413 PAYLOAD_TOO_LARGE";
+    m_discarding = false;
+    m_discardedBytes = 0;
+    m_discardTag.clear();
+
+    m_pipeline.enqueue(std::move(request));
+    schedule();
 }
 
 /**
@@ -140,16 +474,31 @@ void ClientSession::onReadyRead() {
 void ClientSession::onDisconnected() {
     EMIT_INFO() << "Client`["<< m_clientInfo->id.c_str() << "]` disconnected."; 
     
+    // Step 1: Unregister from the session manager (still needs the client id);
+    // its listeners drop the client's WATCHes and its authenticated session.
+    m_clientInfo->auth->revoke();
+    m_sessions->remove(this);
+
+    // Step 2: Requests still running will post back to this object; wait for them
+    m_closing = true;
+    m_pipeline.clearPending();
+    if (m_pipeline.running() == 0) {
+        teardown();
+    }
+}
+
+/**
+ * @brief Final cleanup once no request of this session is running.
+ */
+void ClientSession::teardown() {
     // Delete the client info.
     if(m_clientInfo) {
         delete m_clientInfo;
         m_clientInfo = nullptr;
     }
-
-    // Step 1: Unregister from the session manager
-    m_sessions->remove(this);
+    m_traffic.reset();
     
-    // Step 2: Schedule object deletion to ensure safe cleanup after the event loop
+    // Schedule object deletion to ensure safe cleanup after the event loop
     m_socket->deleteLater();
     deleteLater();
 }
@@ -17,6 +17,10 @@
 // Other
 #include "core/IClientSession.hpp"
 #include "domain/ClientInfo.hpp"
+#include "codec/FrameCodec.hpp"
+#include "metrics/Metrics.hpp"
+#include "network/RequestPipeline.hpp"
+#include "transport/TlsChannel.hpp"
 #include <memory>
 #include <vector>
 
@@ -37,6 +41,21 @@ class SessionManager;
  * ClientSession implements the IClientSession interface and inherits from QObject
  * to utilize the Qt Signal/Slot mechanism. It manages its own QTcpSocket and
  * handles incoming stream fragmentation using a delimiter-based protocol.
+ *
+ * The session also owns the per-connection transport options: a client may
+ * send "COMPRESS <codec>[,<codec>...][,min=<bytes>]" (or "COMPRESS off") and
+ * from then on every response of at least min bytes is sent as a FrameCodec
+ * frame. The first codec in the client's list that this build supports is
+ * chosen; the reply is "OK COMPRESS <codec> min=<bytes>".
+ *
+ * Frames carrying a request id ("#<id> ...") are scheduled by a
+ * RequestPipeline and may run concurrently on a shared worker pool; untagged
+ * frames run on the session thread in order, exactly as before.
+ *
+ * When the server was given a TlsContext, the session speaks TLS: bytes
+ * read from the socket go through a TlsChannel before framing, and
+ * everything written goes through it on the way out. The handshake must
+ * complete within SSL_HANDSHAKE_TIMEOUT_MS.
  * 
  * @note This class is marked as 'final' to prevent further inheritance.
  */
@@ -49,22 +68,32 @@ public:
      * @param socketDescriptor The native handle for the incoming connection.
      * @param logic Shared pointer to the central server logic for processing messages.
      * @param sessions Pointer to the manager responsible for tracking all active sessions.
+     * @param tls Shared TLS context; null for a plaintext connection.
      * @param parent Optional QObject parent (defaults to nullptr).
      */
     explicit ClientSession(qintptr socketDescriptor,
                            std::shared_ptr<ChatServer> logic,
                            SessionManager* sessions,
+                           std::shared_ptr<TlsContext> tls = nullptr,
                            QObject* parent = nullptr);
 
     /**
      * @brief Sends a data packet to the connected client.
      * 
      * Implements the IClientSession interface. This method appends the 
-     * protocol delimiter automatically.
+     * protocol delimiter automatically, and compresses the frame block by
+     * block when COMPRESS was negotiated and the frame is large enough.
      * 
      * @param data The byte array to be transmitted.
      */
     void send(const QByteArray& data) override;
+
+    /**
+     * @brief Sends a frame made of several buffers (e.g. a header and a
+     *        cached file body), writing each one as is instead of joining them.
+     * @param parts The buffers of the frame, in order.
+     */
+    void send(const QByteArrayList& parts) override;
     
     /** @brief Returns the current clientInfo */
     const ClientInfo* getClientInfo() override {
@@ -85,6 +114,24 @@ private slots:
     void onDisconnected();
     
 private:
+    /**
+     * @brief Frames freshly read bytes into m_buffer, enforcing the frame limit.
+     *
+     * Bytes of a frame that would exceed the limit are never appended: the
+     * partial frame is dropped and the rest of it is skipped up to its
+     * delimiter, then answered with PAYLOAD_TOO_LARGE.
+     */
+    void consume(const char* data, qint64 size);
+
+    /** @brief Writes to the socket, through the TLS channel when there is one. */
+    qint64 transmit(const QByteArray& bytes);
+
+    /** @brief Closes a connection whose TLS channel failed or timed out. */
+    void dropTls();
+
+    /** @brief Answers a dropped oversized frame, in order with the frames before it. */
+    void rejectOversized();
+
     /**
      * @brief Internal helper to parse the raw buffer into discrete messages.
      * 
@@ -92,12 +139,57 @@ private:
      */
     void processBuffer();
 
+    /**
+     * @brief Handles the connection-level COMPRESS negotiation.
+     * @param frame The frame without its request id.
+     * @param requestId Request id to echo in the reply (may be empty).
+     * @return true if the frame was a COMPRESS request (and has been answered).
+     */
+    bool handleCompress(const QByteArray& frame, const QByteArray& requestId);
+
+    /**
+     * @brief Starts every pending request the pipeline allows to run now.
+     *
+     * Barriers run inline on the session thread, the others on the worker pool.
+     */
+    void schedule();
+
+    /**
+     * @brief Called on the session thread when a pooled request has completed.
+     * @param request The request returned earlier by the pipeline.
+     */
+    void onRequestFinished(const RequestPipeline::Request& request);
+
+    /** @brief Releases the client info and schedules the deletion of the session. */
+    void teardown();
+
     /** @brief The actual network socket for this client. */
     QTcpSocket* m_socket;
 
     /** @brief Internal storage for incoming data fragments. */
     QByteArray m_buffer;
 
+    /** @brief TLS layer of the connection (null for plaintext). */
+    std::unique_ptr<TlsChannel> m_tls;
+
+    /** @brief Reusable socket read buffer (one chunk). */
+    QByteArray m_readChunk;
+
+    /** @brief Offset in m_buffer where the incomplete frame starts. */
+    qint64 m_frameStart = 0;
+
+    /** @brief Largest frame accepted from this client. */
+    qint64 m_frameLimit = 0;
+
+    /** @brief Set while the rest of an oversized frame is skipped. */
+    bool m_discarding = false;
+
+    /** @brief Bytes skipped of the frame being discarded. */
+    qint64 m_discardedBytes = 0;
+
+    /** @brief Request id of the frame being discarded (if it had one). */
+    QByteArray m_discardTag;
+
     /** @brief Reference to the business logic layer. */
     std::shared_ptr<ChatServer> m_logic;
 
@@ -106,6 +198,21 @@ private:
 
     /** @brief Client information. */        
     ClientInfo* m_clientInfo;
+
+    /** @brief Bytes read from / written to the socket, reported by "METRICS sessions". */
+    std::shared_ptr<Metrics::SessionCounters> m_traffic;
+
+    /** @brief Negotiated response codec (None until COMPRESS). */
+    FrameCodec::Codec m_compression = FrameCodec::Codec::None;
+
+    /** @brief Responses smaller than this are sent uncompressed. */
+    int m_compressMinBytes = 0;
+
+    /** @brief Pending and running requests of this connection. */
+    RequestPipeline m_pipeline;
+
+    /** @brief Set once disconnected; teardown waits for running requests. */
+    bool m_closing = false;
 };
 
 } /* namespace Chat */
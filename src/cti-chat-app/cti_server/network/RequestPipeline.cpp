@@ -0,0 +1,187 @@
+/**
+ * @file RequestPipeline.cpp
+ * @brief Implementation of the per-session request scheduler.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QList>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+
+// Other
+#include "RequestPipeline.hpp"
+#include "constants.hpp"
+#include "metrics/Metrics.hpp"
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Verbs that touch several paths or the session itself. */
+bool isBarrierVerb(const QByteArray& verb) {
+    return verb == "AUTH" || verb == "MULTI" || verb == "TXN" || verb == "RENAME" || verb == "COPY";
+}
+
+/** @brief Verbs whose first argument is the path they operate on. */
+bool isPathVerb(const QByteArray& verb) {
+    return verb == "CREATE" || verb == "WRITE" || verb == "APPEND" || verb == "READ"
+        || verb == "DELETE" || verb == "INFO" || verb == "CHECKSUM" || verb == "SIGNATURE"
+        || verb == "DELTA" || verb == "WATCH" || verb == "UNWATCH";
+}
+
+/** @brief Argument @p index, split as the command layer does (empty fields skipped). */
+QByteArray argumentAt(const QByteArray& args, int index) {
+    int field = 0;
+    int start = 0;
+    for (int i = 0; i <= args.size(); ++i) {
+        if (i < args.size() && args.at(i) != ',' && args.at(i) != ';') {
+            continue;
+        }
+        if (i > start) {
+            if (field == index) {
+                return args.mid(start, i - start).trimmed();
+            }
+            ++field;
+        }
+        start = i + 1;
+    }
+    return QByteArray();
+}
+
+/** @brief Ordering key of a path: the spelling of ICommand::canonicalPath(). */
+QString pathKey(const QByteArray& path) {
+    return QDir::cleanPath(QString::fromUtf8(path));
+}
+
+} /* namespace */
+
+RequestPipeline::RequestPipeline(int maxInFlight)
+    : m_maxInFlight(qMax(1, maxInFlight)) {}
+
+RequestPipeline::Request RequestPipeline::classify(const QByteArray& frame) {
+    Request request;
+    request.frame = frame.trimmed();
+
+    // Step 1: Optional "#<id> " prefix.
+    if (request.frame.startsWith('#')) {
+        const int space = request.frame.indexOf(' ');
+        request.tag = request.frame.mid(1, space < 0 ? -1 : space - 1);
+        request.frame = (space < 0) ? QByteArray() : request.frame.mid(space + 1).trimmed();
+    }
+
+    const int space = request.frame.indexOf(' ');
+    const QByteArray verb = request.frame.left(space < 0 ? request.frame.size() : space).toUpper();
+    request.offload = (verb == "AUTH");
+
+    // Step 2: Untagged frames keep the sequential semantics.
+    if (request.tag.isEmpty()) {
+        request.barrier = true;
+        return request;
+    }
+
+    // Step 3: Ordering from the verb and its path.
+    const QByteArray args = (space < 0) ? QByteArray() : request.frame.mid(space + 1);
+    if (isBarrierVerb(verb)) {
+        request.barrier = true;
+    } else if (isPathVerb(verb) && space >= 0) {
+        request.key = pathKey(argumentAt(args, 0));
+    } else if (verb == "GREP" && space >= 0) {
+        // GREP reads its second argument: one file is keyed on it, a glob may
+        // cover any file and so waits for (and holds back) everything else.
+        const QByteArray target = argumentAt(args, 1);
+        if (target.contains('*') || target.contains('?') || target.contains('[')) {
+            request.barrier = true;
+        } else if (!target.isEmpty()) {
+            request.key = pathKey(target);
+        }
+    }
+    return request;
+}
+
+QThreadPool& RequestPipeline::pool() {
+    static QThreadPool* workers = [] {
+        auto* p = new QThreadPool();
+        p->setMaxThreadCount(qMax(2, QThread::idealThreadCount() * Constants::PIPELINE_THREADS_PER_CORE));
+        return p;
+    }();
+    return *workers;
+}
+
+QThreadPool& RequestPipeline::offloadPool() {
+    static QThreadPool* workers = [] {
+        auto* p = new QThreadPool();
+        p->setMaxThreadCount(Constants::PIPELINE_OFFLOAD_THREADS);
+        return p;
+    }();
+    return *workers;
+}
+
+void RequestPipeline::enqueue(Request request) {
+    m_pending.push_back(std::move(request));
+    Metrics::adjust(Metrics::Gauge::QueuePending, 1);
+    Metrics::record(Metrics::Histogram::QueueDepth, m_pending.size());
+}
+
+void RequestPipeline::clearPending() {
+    Metrics::adjust(Metrics::Gauge::QueuePending, -static_cast<qint64>(m_pending.size()));
+    m_pending.clear();
+}
+
+QVector<RequestPipeline::Request> RequestPipeline::takeRunnable() {
+    QVector<Request> runnable;
+    if (m_barrierRunning) {
+        return runnable;
+    }
+
+    // Step 1: Scan in arrival order; a waiting request blocks later ones on its key.
+    QSet<QString> blocked;
+    for (auto it = m_pending.begin(); it != m_pending.end() && m_running < m_maxInFlight;) {
+        if (it->barrier) {
+            if (m_running == 0 && it == m_pending.begin()) {
+                m_barrierRunning = true;
+                ++m_running;
+                runnable.append(std::move(*it));
+                m_pending.erase(it);
+            }
+            break;
+        }
+
+        const bool keyed = !it->key.isEmpty();
+        if (keyed && (m_busyKeys.contains(it->key) || blocked.contains(it->key))) {
+            blocked.insert(it->key);
+            ++it;
+            continue;
+        }
+
+        // Step 2: Start it.
+        if (keyed) {
+            m_busyKeys.insert(it->key);
+        }
+        ++m_running;
+        runnable.append(std::move(*it));
+        it = m_pending.erase(it);
+    }
+
+    Metrics::adjust(Metrics::Gauge::QueuePending, -runnable.size());
+    Metrics::adjust(Metrics::Gauge::QueueRunning, runnable.size());
+    return runnable;
+}
+
+void RequestPipeline::finished(const Request& request) {
+    --m_running;
+    Metrics::adjust(Metrics::Gauge::QueueRunning, -1);
+    if (request.barrier) {
+        m_barrierRunning = false;
+    } else if (!request.key.isEmpty()) {
+        m_busyKeys.remove(request.key);
+    }
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,127 @@
+/**
+ * @file RequestPipeline.hpp
+ * @brief Definition of the RequestPipeline class, per-session request scheduling.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the bookkeeping that lets one session run several tagged
+ * requests at once while keeping requests on the same path in order.
+ */
+
+#ifndef REQUESTPIPELINE_HPP
+#define REQUESTPIPELINE_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Other
+#include <deque>
+
+class QThreadPool;
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class RequestPipeline
+ * @brief Decides which of a session's pending requests may run now.
+ *
+ * A frame may start with a request id, "#<id> VERB args"; the response then
+ * starts with the same "#<id> " so the client can match it. Tagged requests
+ * are scheduled as follows:
+ * - requests with the same ordering key (their path; for GREP on one file,
+ *   that file) run one at a time, in arrival order;
+ * - requests with different keys, or without a key (LIST, STATS, SEARCH...),
+ *   run concurrently and are answered as they complete;
+ * - barriers (untagged frames, AUTH, MULTI, the multi-path TXN, RENAME and
+ *   COPY, and GREP over a glob) wait until everything before them has
+ *   finished, and everything after them waits for the barrier.
+ *
+ * A client that never sends ids therefore sees the old strictly sequential
+ * behaviour. AUTH is also marked for offloading: even untagged, it runs off
+ * the session's thread (still as a barrier), because verifying a password is
+ * slow. Offloaded requests use a pool of their own, so logins waiting for a
+ * KDF worker never hold the threads other sessions' tagged requests run on.
+ *
+ * The class is not thread-safe; it is owned and driven by the session's
+ * thread.
+ *
+ * Pending and running requests are reported as the QueuePending and
+ * QueueRunning gauges of Metrics, and the depth of the queue at every
+ * enqueue as the QueueDepth histogram.
+ */
+class RequestPipeline {
+public:
+    /**
+     * @struct Request
+     * @brief One frame, its request id and its ordering constraints.
+     */
+    struct Request {
+        QByteArray frame;     ///< Frame without the "#<id> " prefix.
+        QByteArray tag;       ///< Request id ("" if the frame had none).
+        QString key;          ///< Ordering key ("" if unordered).
+        bool barrier = false; ///< Runs alone, in order with everything.
+        bool offload = false; ///< Slow (AUTH): runs on offloadPool(), never on the session's thread.
+        QByteArray reply;     ///< Answer fixed by the session (rejected frame); not dispatched.
+    };
+
+    /** @param maxInFlight Upper bound on concurrently running requests. */
+    explicit RequestPipeline(int maxInFlight);
+
+    /** @brief Splits off the request id and derives the ordering constraints. */
+    static Request classify(const QByteArray& frame);
+
+    /** @brief Worker pool shared by all sessions for concurrent requests. */
+    static QThreadPool& pool();
+
+    /** @brief Separate pool for offloaded (slow) requests of all sessions. */
+    static QThreadPool& offloadPool();
+
+    /** @brief Queues a request behind the ones already pending. */
+    void enqueue(Request request);
+
+    /**
+     * @brief Removes and returns the requests that may start now.
+     *
+     * They count as running until finished() is called for each. A barrier is
+     * always returned alone.
+     */
+    QVector<Request> takeRunnable();
+
+    /** @brief Marks a request returned by takeRunnable() as completed. */
+    void finished(const Request& request);
+
+    /** @brief Drops the requests that have not started. */
+    void clearPending();
+
+    /** @brief True if nothing is pending or running. */
+    bool idle() const { return m_pending.empty() && m_running == 0; }
+
+    /** @brief Number of requests currently running. */
+    int running() const { return m_running; }
+
+private:
+    /** @brief Upper bound on m_running. */
+    const int m_maxInFlight;
+
+    /** @brief Requests not started yet, in arrival order. */
+    std::deque<Request> m_pending;
+
+    /** @brief Keys with a running request. */
+    QSet<QString> m_busyKeys;
+
+    /** @brief Number of running requests (barrier included). */
+    int m_running = 0;
+
+    /** @brief True while a barrier runs. */
+    bool m_barrierRunning = false;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* REQUESTPIPELINE_HPP */
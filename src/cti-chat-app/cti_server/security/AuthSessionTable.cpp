@@ -0,0 +1,152 @@
+/**
+ * @file AuthSessionTable.cpp
+ * @brief Implementation of the LRU/TTL table of authenticated sessions.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QMutexLocker>
+
+// Other
+#include "AuthSessionTable.hpp"
+#include "error/error_emitter.hpp"
+
+namespace CTI {
+namespace Chat {
+
+AuthSessionTable::AuthSessionTable(int capacity, qint64 ttlMs)
+    : m_capacity(qMax(1, capacity)),
+      m_ttlMs(ttlMs) {}
+
+AuthSessionTable::~AuthSessionTable() = default;
+
+void AuthSessionTable::login(const QString& senderId, const QString& username,
+                             const std::shared_ptr<AuthTicket>& ticket, bool admin) {
+    QMutexLocker locker(&m_mutex);
+    ++m_logins;
+
+    // Step 1: Re-authentication of a known session just refreshes it.
+    auto it = m_nodes.find(senderId);
+    if (it == m_nodes.end()) {
+        // Step 2: Make room by dropping the least recently active session.
+        if (static_cast<int>(m_nodes.size()) >= m_capacity) {
+            if (Node* victim = settledTail()) {
+                EMIT_INFO() << "Session table full. Evicted least recently active session:" << victim->senderId;
+                drop(victim);
+                ++m_evicted;
+            }
+        }
+        it = m_nodes.emplace(senderId, Node()).first;
+        it->second.senderId = senderId;
+    } else {
+        unlink(&it->second);
+    }
+
+    Node& node = it->second;
+    node.username = username;
+    node.ticket = ticket;
+    if (ticket) {
+        ticket->grant(username, admin);
+    }
+    node.placedMs = AuthTicket::nowMs();
+    pushFront(&node);
+}
+
+void AuthSessionTable::logout(const QString& senderId) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_nodes.find(senderId);
+    if (it == m_nodes.end()) {
+        return;
+    }
+    drop(&it->second);
+    ++m_loggedOut;
+}
+
+bool AuthSessionTable::contains(const QString& senderId) const {
+    QMutexLocker locker(&m_mutex);
+    return m_nodes.find(senderId) != m_nodes.end();
+}
+
+int AuthSessionTable::expire() {
+    const qint64 now = AuthTicket::nowMs();
+    int count = 0;
+
+    QMutexLocker locker(&m_mutex);
+    while (Node* tail = settledTail()) {
+        if (now - activityOf(tail) <= m_ttlMs) {
+            break;
+        }
+        EMIT_INFO() << "Session expired after inactivity:" << tail->senderId;
+        drop(tail);
+        ++count;
+    }
+    m_expired += static_cast<quint64>(count);
+    return count;
+}
+
+AuthSessionTable::Stats AuthSessionTable::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats s;
+    s.active    = static_cast<quint64>(m_nodes.size());
+    s.capacity  = static_cast<quint64>(m_capacity);
+    s.logins    = m_logins;
+    s.evicted   = m_evicted;
+    s.expired   = m_expired;
+    s.loggedOut = m_loggedOut;
+    return s;
+}
+
+void AuthSessionTable::pushFront(Node* node) {
+    node->prev = nullptr;
+    node->next = m_head;
+    if (m_head) {
+        m_head->prev = node;
+    }
+    m_head = node;
+    if (!m_tail) {
+        m_tail = node;
+    }
+}
+
+void AuthSessionTable::unlink(Node* node) {
+    (node->prev ? node->prev->next : m_head) = node->next;
+    (node->next ? node->next->prev : m_tail) = node->prev;
+    node->prev = nullptr;
+    node->next = nullptr;
+}
+
+AuthSessionTable::Node* AuthSessionTable::settledTail() {
+    // Each node is promoted at most once per call (bounded by the table size).
+    for (size_t moves = 0; m_tail && moves < m_nodes.size(); ++moves) {
+        Node* tail = m_tail;
+        const qint64 active = activityOf(tail);
+        if (active <= tail->placedMs) {
+            break;
+        }
+        tail->placedMs = active;
+        unlink(tail);
+        pushFront(tail);
+    }
+    return m_tail;
+}
+
+void AuthSessionTable::drop(Node* node) {
+    if (auto ticket = node->ticket.lock()) {
+        ticket->revoke();
+    }
+    unlink(node);
+    const QString key = node->senderId;
+    m_nodes.erase(key);
+}
+
+qint64 AuthSessionTable::activityOf(const Node* node) {
+    if (auto ticket = node->ticket.lock()) {
+        return qMax(node->placedMs, ticket->lastActiveMs());
+    }
+    return node->placedMs;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,146 @@
+/**
+ * @file AuthSessionTable.hpp
+ * @brief Definition of the AuthSessionTable class, the bounded table of authenticated sessions.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the registry of logged-in sessions: least-recently-active
+ * eviction when full, expiry after an idle period, and removal on disconnect.
+ */
+
+#ifndef AUTHSESSIONTABLE_HPP
+#define AUTHSESSIONTABLE_HPP
+
+// Qt Depends
+#include <QMutex>
+#include <QString>
+
+// Other
+#include <memory>
+#include <unordered_map>
+#include "domain/AuthTicket.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class AuthSessionTable
+ * @brief LRU + TTL table of authenticated sessions with O(1) operations.
+ *
+ * Entries sit in a hash map (node-based, so addresses are stable) and are
+ * threaded on an intrusive doubly linked list, most recently active first.
+ * Commands do not reorder the list: they only touch() their ticket. Whoever
+ * needs the least-recently-active entry (eviction, expiry) looks at the tail
+ * and gives a second chance to an entry whose ticket was used since it was
+ * last placed: it is moved to the head in O(1). Each entry is moved at most
+ * once per pass, so eviction and expiry stay O(1) amortized.
+ *
+ * Removing an entry (eviction, expiry, logout) revokes its ticket, so the
+ * session's next command is refused.
+ */
+class AuthSessionTable {
+public:
+    /**
+     * @struct Stats
+     * @brief Occupancy and eviction counters.
+     */
+    struct Stats {
+        quint64 active = 0;
+        quint64 capacity = 0;
+        quint64 logins = 0;
+        quint64 evicted = 0;
+        quint64 expired = 0;
+        quint64 loggedOut = 0;
+    };
+
+    /**
+     * @param capacity Maximum number of authenticated sessions.
+     * @param ttlMs Idle time after which a session loses its authentication.
+     */
+    AuthSessionTable(int capacity, qint64 ttlMs);
+    ~AuthSessionTable();
+
+    AuthSessionTable(const AuthSessionTable&) = delete;
+    AuthSessionTable& operator=(const AuthSessionTable&) = delete;
+
+    /**
+     * @brief Registers (or refreshes) a session and grants its ticket.
+     *
+     * Evicts the least recently active session when the table is full.
+     * @param admin Whether @p username holds the administrator role.
+     */
+    void login(const QString& senderId, const QString& username,
+               const std::shared_ptr<AuthTicket>& ticket, bool admin = false);
+
+    /** @brief Removes a session (client disconnected). */
+    void logout(const QString& senderId);
+
+    /** @brief True if the session is in the table (slow path; commands use their ticket). */
+    bool contains(const QString& senderId) const;
+
+    /**
+     * @brief Expires the sessions idle for longer than the TTL.
+     * @return Number of sessions expired.
+     */
+    int expire();
+
+    /** @brief Returns occupancy and eviction counters. */
+    Stats stats() const;
+
+private:
+    /**
+     * @struct Node
+     * @brief One session; also a link of the recency list.
+     */
+    struct Node {
+        QString senderId;
+        QString username;
+        std::weak_ptr<AuthTicket> ticket;
+        /** @brief Activity time the node's list position reflects. */
+        qint64 placedMs = 0;
+        Node* prev = nullptr;
+        Node* next = nullptr;
+    };
+
+    /** @brief Inserts a node at the head (most recent). */
+    void pushFront(Node* node);
+
+    /** @brief Detaches a node from the list. */
+    void unlink(Node* node);
+
+    /**
+     * @brief Moves tail nodes that were active since being placed to the head.
+     * @return The least recently active node (nullptr if empty).
+     */
+    Node* settledTail();
+
+    /** @brief Revokes the ticket, unlinks and erases a node. */
+    void drop(Node* node);
+
+    /** @brief Last activity of a node: its ticket's, or its placement time. */
+    static qint64 activityOf(const Node* node);
+
+    const int m_capacity;
+    const qint64 m_ttlMs;
+
+    /** @brief Protects every member below. */
+    mutable QMutex m_mutex;
+
+    /** @brief Sessions by sender id. */
+    std::unordered_map<QString, Node> m_nodes;
+
+    /** @brief Most / least recently active ends of the list. */
+    Node* m_head = nullptr;
+    Node* m_tail = nullptr;
+
+    quint64 m_logins = 0;
+    quint64 m_evicted = 0;
+    quint64 m_expired = 0;
+    quint64 m_loggedOut = 0;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* AUTHSESSIONTABLE_HPP */
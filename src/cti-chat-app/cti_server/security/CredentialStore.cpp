@@ -0,0 +1,255 @@
+/**
+ * @file CredentialStore.cpp
+ * @brief Implementation of the file-backed PBKDF2 credential store.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QCryptographicHash>
+#include <QFile>
+#include <QMutexLocker>
+#include <QPasswordDigestor>
+#include <QRandomGenerator>
+
+// Other
+#include "CredentialStore.hpp"
+#include "domain/AuthTicket.hpp"
+#include "error/error_emitter.hpp"
+#include "constants.hpp"
+
+#include <cstring>
+#include <future>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Algorithm tag of the only supported scheme. */
+const QByteArray SCHEME = QByteArrayLiteral("pbkdf2-sha256");
+
+/** @brief Derived key length (SHA-256 output). */
+constexpr int KEY_BYTES = 32;
+
+/** @brief Optional last field of a record granting the administrator role. */
+const QByteArray ADMIN_ROLE = QByteArrayLiteral("admin");
+
+/** @brief Random salt length. */
+constexpr int SALT_BYTES = 16;
+
+/** @brief Compares without an early exit, so timing does not leak the prefix. */
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    uchar diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= static_cast<uchar>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+} /* namespace */
+
+CredentialStore::CredentialStore(const QString& path, int workers, int maxPending, qint64 reloadCheckMs,
+                                 const QMap<QString, QString>& fallback, const QSet<QString>& fallbackAdmins)
+    : m_path(path),
+      m_maxPending(qMax(1, maxPending)),
+      m_reloadCheckMs(reloadCheckMs) {
+    m_workers.setMaxThreadCount(qMax(1, workers));
+    m_decoy = hashPassword(QStringLiteral("decoy"), Constants::CREDENTIALS_DEFAULT_ITERATIONS);
+
+    // Step 1: Fallback accounts (if enabled), hashed once.
+    auto table = std::make_shared<Table>();
+    for (auto it = fallback.constBegin(); it != fallback.constEnd(); ++it) {
+        Record record = hashPassword(it.value(), Constants::CREDENTIALS_DEFAULT_ITERATIONS);
+        record.admin = fallbackAdmins.contains(it.key());
+        table->insert(it.key(), record);
+    }
+    m_table = table;
+
+    // Step 2: The real file, if present.
+    reloadIfChanged();
+    if (m_loadedMeta.inode == 0) {
+        if (fallback.isEmpty()) {
+            EMIT_ERROR() << "Credentials file" << m_path << "not found; every AUTH is denied until it exists.";
+        } else {
+            EMIT_WARN() << "Credentials file" << m_path << "not found; using the built-in demo accounts.";
+        }
+    }
+}
+
+CredentialStore::Result CredentialStore::verify(const QString& username, const QString& password, bool* admin) {
+    // Step 1: Pick up edits of the file (throttled).
+    const qint64 now = AuthTicket::nowMs();
+    if (now - m_lastCheckMs.load(std::memory_order_relaxed) >= m_reloadCheckMs) {
+        reloadIfChanged();
+    }
+
+    // Step 2: Bounded backlog.
+    if (m_pending.fetch_add(1, std::memory_order_acq_rel) >= m_maxPending) {
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        m_busy.fetch_add(1, std::memory_order_relaxed);
+        EMIT_WARN() << "AUTH refused: Verification backlog full.";
+        return Result::Busy;
+    }
+
+    // Step 3: Look up on the snapshot; unknown users are checked against a decoy.
+    const std::shared_ptr<const Table> table = std::atomic_load(&m_table);
+    auto it = table->constFind(username);
+    const bool known = (it != table->constEnd());
+    const Record record = known ? it.value() : m_decoy;
+
+    // Step 4: Run the KDF on the verification pool and wait for it. A std::future
+    // is waited on without running the task here (QFuture::result() may steal a
+    // task that has not started), so at most m_workers KDFs run at once.
+    auto done = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = done->get_future();
+    m_workers.start([done, record, password]() {
+        done->set_value(matches(record, password));
+    });
+    const bool ok = result.get() && known;
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    if (admin) {
+        *admin = ok && record.admin;
+    }
+    (ok ? m_verified : m_denied).fetch_add(1, std::memory_order_relaxed);
+    return ok ? Result::Ok : Result::Denied;
+}
+
+void CredentialStore::reloadIfChanged() {
+    QMutexLocker locker(&m_reloadMutex);
+    m_lastCheckMs.store(AuthTicket::nowMs(), std::memory_order_relaxed);
+
+    // Step 1: Same version as loaded (or still missing): nothing to do.
+    FileMeta meta;
+    const bool exists = MetadataIndex::statFile(m_path, &meta);
+    if (exists && meta.inode == m_loadedMeta.inode && meta.size == m_loadedMeta.size
+        && meta.mtimeMs == m_loadedMeta.mtimeMs) {
+        return;
+    }
+    if (!exists) {
+        if (m_loadedMeta.inode != 0) {
+            EMIT_WARN() << "Credentials file" << m_path << "removed; keeping the users loaded from it.";
+            m_loadedMeta = FileMeta();
+        }
+        return;
+    }
+
+    // Step 2: Parse into a new snapshot; keep the old one if that fails.
+    std::shared_ptr<Table> table;
+    if (!load(&table)) {
+        EMIT_ERROR() << "Credentials file" << m_path << "is invalid; keeping the previous users.";
+        m_loadedMeta = meta;
+        return;
+    }
+    std::atomic_store(&m_table, std::shared_ptr<const Table>(std::move(table)));
+    m_loadedMeta = meta;
+    m_reloads.fetch_add(1, std::memory_order_relaxed);
+    EMIT_INFO() << "Loaded credentials for" << std::atomic_load(&m_table)->size() << "users from" << m_path;
+}
+
+CredentialStore::Stats CredentialStore::stats() const {
+    Stats s;
+    s.users    = static_cast<quint64>(std::atomic_load(&m_table)->size());
+    s.reloads  = m_reloads.load(std::memory_order_relaxed);
+    s.verified = m_verified.load(std::memory_order_relaxed);
+    s.denied   = m_denied.load(std::memory_order_relaxed);
+    s.busy     = m_busy.load(std::memory_order_relaxed);
+    return s;
+}
+
+QByteArray CredentialStore::makeRecord(const QString& username, const QString& password, int iterations,
+                                       bool admin) {
+    const Record record = hashPassword(password, iterations);
+    QByteArray line = username.toUtf8() + ':' + SCHEME + ':' + QByteArray::number(record.iterations) + ':'
+                      + record.salt.toBase64() + ':' + record.hash.toBase64();
+    if (admin) {
+        line += ':' + ADMIN_ROLE;
+    }
+    return line;
+}
+
+bool CredentialStore::parseLine(const QByteArray& line, QString* user, Record* record) {
+    const QList<QByteArray> fields = line.split(':');
+    if (fields.size() < 5 || fields.size() > 6 || fields[0].isEmpty() || fields[1] != SCHEME
+        || (fields.size() == 6 && fields[5] != ADMIN_ROLE)) {
+        return false;
+    }
+    bool ok = false;
+    record->iterations = fields[2].toInt(&ok);
+    if (!ok || record->iterations <= 0 || record->iterations > Constants::CREDENTIALS_MAX_ITERATIONS) {
+        return false;
+    }
+    auto salt = QByteArray::fromBase64Encoding(fields[3], QByteArray::AbortOnBase64DecodingErrors);
+    auto hash = QByteArray::fromBase64Encoding(fields[4], QByteArray::AbortOnBase64DecodingErrors);
+    if (!salt || !hash || hash.decoded.size() != KEY_BYTES) {
+        return false;
+    }
+    *user = QString::fromUtf8(fields[0]);
+    record->salt = salt.decoded;
+    record->hash = hash.decoded;
+    record->admin = (fields.size() == 6);
+    return true;
+}
+
+bool CredentialStore::load(std::shared_ptr<Table>* out) const {
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Step 1: Read it whole; the file is small and edited in place by
+    // administrators, so it is never mapped (a truncate would raise SIGBUS).
+    const QByteArray content = file.readAll();
+    const char* data = content.constData();
+    const qint64 size = content.size();
+
+    // Step 2: One record per line.
+    auto table = std::make_shared<Table>();
+    int lineNo = 0;
+    for (qint64 start = 0; start < size;) {
+        const char* end = static_cast<const char*>(std::memchr(data + start, '\n', static_cast<size_t>(size - start)));
+        const qint64 stop = end ? end - data : size;
+        const QByteArray line = QByteArray::fromRawData(data + start, static_cast<int>(stop - start)).trimmed();
+        start = stop + 1;
+        ++lineNo;
+
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QString user;
+        Record record;
+        if (!parseLine(line, &user, &record)) {
+            EMIT_ERROR() << "Credentials file" << m_path << "line" << lineNo << "is malformed.";
+            return false;
+        }
+        table->insert(user, record);
+    }
+
+    *out = std::move(table);
+    return true;
+}
+
+CredentialStore::Record CredentialStore::hashPassword(const QString& password, int iterations) {
+    Record record;
+    record.iterations = iterations;
+    record.salt.resize(SALT_BYTES);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(record.salt.data()),
+                                          SALT_BYTES / static_cast<int>(sizeof(quint32)));
+    record.hash = QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256, password.toUtf8(),
+                                                     record.salt, iterations, KEY_BYTES);
+    return record;
+}
+
+bool CredentialStore::matches(const Record& record, const QString& password) {
+    const QByteArray derived = QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256, password.toUtf8(),
+                                                                  record.salt, record.iterations, KEY_BYTES);
+    return constantTimeEquals(derived, record.hash);
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,169 @@
+/**
+ * @file CredentialStore.hpp
+ * @brief Definition of the CredentialStore class, the file-backed user database.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the store AUTH verifies passwords against: salted
+ * PBKDF2 hashes loaded from a file, reloaded when the file changes, and
+ * verified on a small dedicated thread pool.
+ */
+
+#ifndef CREDENTIALSTORE_HPP
+#define CREDENTIALSTORE_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+// Other
+#include <atomic>
+#include <memory>
+#include "storage/MetadataIndex.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class CredentialStore
+ * @brief Salted PBKDF2-HMAC-SHA256 credentials with hot reload and offloaded checks.
+ *
+ * File format, one user per line ('#' starts a comment):
+ *
+ *     <username>:pbkdf2-sha256:<iterations>:<salt base64>:<hash base64>[:admin]
+ *
+ * (makeRecord() produces such a line.) The optional last field grants the
+ * administrator role (LOGLEVEL, METRICS). A record asking for more than
+ * CREDENTIALS_MAX_ITERATIONS iterations makes the file invalid.
+ *
+ * - The file is read in one piece and parsed into a hash table keyed by
+ *   user name; lookups are O(1) on an immutable snapshot, which a reload
+ *   replaces atomically, so readers never lock.
+ * - verify() checks, at most every reload interval, whether the file's
+ *   inode, size or mtime changed and reloads it; a file that fails to parse
+ *   keeps the previous snapshot.
+ * - The KDF runs on a dedicated pool of a few threads. Logins therefore use at
+ *   most that many cores however many arrive at once, and beyond a bounded
+ *   backlog they are refused (Busy) instead of queueing without limit.
+ * - Unknown users cost the same KDF as known ones.
+ * - Without the file no user can log in, unless fallback accounts were given
+ *   (development only, see --demo-users); those are hashed at startup and
+ *   used until the file appears. A file removed at runtime never brings them
+ *   back: the users loaded last stay in effect.
+ */
+class CredentialStore {
+public:
+    /** @brief Outcome of verify(). */
+    enum class Result { Ok, Denied, Busy };
+
+    /**
+     * @struct Stats
+     * @brief Counters of the store.
+     */
+    struct Stats {
+        quint64 users = 0;
+        quint64 reloads = 0;
+        quint64 verified = 0;
+        quint64 denied = 0;
+        quint64 busy = 0;
+    };
+
+    /**
+     * @param path Credentials file.
+     * @param workers Threads running the KDF.
+     * @param maxPending Verifications allowed to wait for a worker.
+     * @param reloadCheckMs Minimum interval between checks of the file.
+     * @param fallback <username, password> accounts used until the file exists (empty = none).
+     * @param fallbackAdmins Fallback accounts holding the administrator role.
+     */
+    CredentialStore(const QString& path, int workers, int maxPending, qint64 reloadCheckMs,
+                    const QMap<QString, QString>& fallback, const QSet<QString>& fallbackAdmins = {});
+
+    /**
+     * @brief Checks a password; blocks the caller until a worker has run the KDF.
+     * @param admin Receives whether the verified user holds the administrator role (may be null).
+     */
+    Result verify(const QString& username, const QString& password, bool* admin = nullptr);
+
+    /** @brief Re-reads the file now if it changed. */
+    void reloadIfChanged();
+
+    /** @brief Returns the store counters. */
+    Stats stats() const;
+
+    /**
+     * @brief Builds a credentials line for @p username with a fresh random salt.
+     * @param iterations PBKDF2 iteration count.
+     * @param admin Whether the line grants the administrator role.
+     */
+    static QByteArray makeRecord(const QString& username, const QString& password, int iterations,
+                                 bool admin = false);
+
+private:
+    /**
+     * @struct Record
+     * @brief One user's KDF parameters.
+     */
+    struct Record {
+        int iterations = 0;
+        QByteArray salt;
+        QByteArray hash;
+        bool admin = false;
+    };
+
+    /** @brief Immutable user table. */
+    using Table = QHash<QString, Record>;
+
+    /** @brief Parses one credentials line into @p user and @p record. */
+    static bool parseLine(const QByteArray& line, QString* user, Record* record);
+
+    /** @brief Builds the table from the file; false if it cannot be read or parsed. */
+    bool load(std::shared_ptr<Table>* out) const;
+
+    /** @brief Hashes a password into a record with a fresh random salt. */
+    static Record hashPassword(const QString& password, int iterations);
+
+    /** @brief Runs the KDF and compares in constant time. */
+    static bool matches(const Record& record, const QString& password);
+
+    const QString m_path;
+    const int m_maxPending;
+    const qint64 m_reloadCheckMs;
+
+    /** @brief Current snapshot (read with std::atomic_load). */
+    std::shared_ptr<const Table> m_table;
+
+    /** @brief Serializes reloads. */
+    QMutex m_reloadMutex;
+
+    /** @brief File version the snapshot was built from. */
+    FileMeta m_loadedMeta;
+
+    /** @brief Steady-clock time of the last check of the file. */
+    std::atomic<qint64> m_lastCheckMs{0};
+
+    /** @brief Threads that run the KDF. */
+    QThreadPool m_workers;
+
+    /** @brief Verifications submitted and not finished. */
+    std::atomic<int> m_pending{0};
+
+    /** @brief Parameters used for unknown users. */
+    Record m_decoy;
+
+    std::atomic<quint64> m_reloads{0};
+    std::atomic<quint64> m_verified{0};
+    std::atomic<quint64> m_denied{0};
+    std::atomic<quint64> m_busy{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* CREDENTIALSTORE_HPP */
@@ -22,6 +22,21 @@ class ISecurityPolicy {
 public:
     virtual ~ISecurityPolicy() = default;
     virtual ErrorCode validate(const Message& msg) = 0;
+
+    /**
+     * @brief Called once the handler is done with a message validate() accepted.
+     * Policies that admit a bounded number of requests at a time release them here.
+     */
+    virtual void release(const Message& msg) { (void)msg; }
+
+    /**
+     * @brief Admits one sub-command of a batch (MULTI) whose frame validate() accepted.
+     * @return SUCCESS, or ERR_SERVER_BUSY to answer the sub-command busy.
+     */
+    virtual ErrorCode validateSubCommand(const Message& msg) { (void)msg; return ErrorCode::SUCCESS; }
+
+    /** @brief Called once a sub-command validateSubCommand() accepted has run. */
+    virtual void releaseSubCommand(const Message& msg) { (void)msg; }
 };
 
 } /* namespace Chat */
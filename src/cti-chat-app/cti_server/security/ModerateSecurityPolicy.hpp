@@ -23,7 +23,8 @@ namespace Chat {
 class ModerateSecurityPolicy : public ISecurityPolicy {
 public:
     ErrorCode validate(const Message& msg) override {
-        // Check against DDOS attacks.
+        // Check against DDOS attacks. ClientSession already drops oversized frames while
+        // they arrive; this covers frames reaching the logic by any other path.
         if(msg.payload.size() > Constants::MAX_PAYLOAD_SIZE) {
             EMIT_ERROR() << error_code_to_string(ErrorCode::ERR_PAYLOAD_TOO_LARGE);
             return ErrorCode::ERR_PAYLOAD_TOO_LARGE;
@@ -0,0 +1,276 @@
+/**
+ * @file RateLimitPolicy.cpp
+ * @brief Implementation of per-client rate limiting and per-class overload shedding.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QMutexLocker>
+
+// Other
+#include "RateLimitPolicy.hpp"
+#include "error/error_emitter.hpp"
+#include "constants.hpp"
+
+#include <cctype>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Case-insensitive comparison of @p verb with an upper-case keyword. */
+bool verbIs(const std::string& verb, const char* keyword) {
+    size_t i = 0;
+    for (; keyword[i] != '\0'; ++i) {
+        if (i >= verb.size() || std::toupper(static_cast<unsigned char>(verb[i])) != keyword[i]) {
+            return false;
+        }
+    }
+    return i == verb.size();
+}
+
+/** @brief First word of @p payload, after the blanks the handler trims; @p end is set past it. */
+std::string firstWord(const std::string& payload, size_t& end) {
+    size_t begin = 0;
+    while (begin < payload.size() && std::isspace(static_cast<unsigned char>(payload[begin]))) {
+        ++begin;
+    }
+    end = begin;
+    while (end < payload.size() && !std::isspace(static_cast<unsigned char>(payload[end]))) {
+        ++end;
+    }
+    return payload.substr(begin, end - begin);
+}
+
+} /* namespace */
+
+RateLimitPolicy::Limits RateLimitPolicy::Limits::defaults() {
+    Limits limits;
+    limits.sessionRequestsPerSec = Constants::RATE_SESSION_REQUESTS_PER_SEC;
+    limits.sessionRequestBurst   = Constants::RATE_SESSION_REQUEST_BURST;
+    limits.sessionBytesPerSec    = Constants::RATE_SESSION_BYTES_PER_SEC;
+    limits.sessionByteBurst      = Constants::RATE_SESSION_BYTE_BURST;
+    limits.userRequestsPerSec    = Constants::RATE_USER_REQUESTS_PER_SEC;
+    limits.userRequestBurst      = Constants::RATE_USER_REQUEST_BURST;
+    limits.userBytesPerSec       = Constants::RATE_USER_BYTES_PER_SEC;
+    limits.userByteBurst         = Constants::RATE_USER_BYTE_BURST;
+    limits.maxConcurrent[static_cast<int>(CommandClass::Auth)]   = Constants::RATE_MAX_CONCURRENT_AUTH;
+    limits.maxConcurrent[static_cast<int>(CommandClass::Read)]   = Constants::RATE_MAX_CONCURRENT_READ;
+    limits.maxConcurrent[static_cast<int>(CommandClass::Write)]  = Constants::RATE_MAX_CONCURRENT_WRITE;
+    limits.maxConcurrent[static_cast<int>(CommandClass::Search)] = Constants::RATE_MAX_CONCURRENT_SEARCH;
+    limits.maxConcurrent[static_cast<int>(CommandClass::Other)]  = 0;
+    return limits;
+}
+
+RateLimitPolicy::RateLimitPolicy(std::shared_ptr<ISecurityPolicy> inner, const Limits& limits)
+    : m_inner(std::move(inner)),
+      m_limits(limits) {
+    EMIT_DEBUG() << "Rate limiting enabled.";
+}
+
+ErrorCode RateLimitPolicy::validate(const Message& msg) {
+    // Step 1: Content checks first; a malformed frame costs no tokens.
+    if (m_inner) {
+        const ErrorCode inner = m_inner->validate(msg);
+        if (inner != ErrorCode::SUCCESS) {
+            return inner;
+        }
+    }
+    if (!msg.auth) {
+        return ErrorCode::SUCCESS; // Server-originated.
+    }
+
+    const qint64 now = TokenBucket::nowNs();
+    const qint64 requests = requestCount(msg.payload);
+    const qint64 bytes = static_cast<qint64>(msg.payload.size());
+
+    // Step 2: The session's own share.
+    AuthTicket::Rate& rate = msg.auth->rate();
+    if (!admit(rate.session, requests, bytes, now, m_limits.sessionRequestsPerSec,
+               m_limits.sessionRequestBurst, m_limits.sessionBytesPerSec, m_limits.sessionByteBurst)) {
+        m_sessionThrottled.fetch_add(1, std::memory_order_relaxed);
+        EMIT_DEBUG() << "Request throttled (session rate). Sender:" << msg.senderId.c_str();
+        return ErrorCode::ERR_SERVER_BUSY;
+    }
+
+    // Step 3: The user's share, across all of its sessions.
+    RateBuckets* user = nullptr;
+    if (msg.auth->isAuthorized()) {
+        user = userBuckets(*msg.auth);
+        if (!admit(*user, requests, bytes, now, m_limits.userRequestsPerSec, m_limits.userRequestBurst,
+                   m_limits.userBytesPerSec, m_limits.userByteBurst)) {
+            rate.session.requests.giveBack(requests, m_limits.sessionRequestsPerSec);
+            rate.session.bytes.giveBack(bytes, m_limits.sessionBytesPerSec);
+            m_userThrottled.fetch_add(1, std::memory_order_relaxed);
+            EMIT_DEBUG() << "Request throttled (user rate). Sender:" << msg.senderId.c_str();
+            return ErrorCode::ERR_SERVER_BUSY;
+        }
+    }
+
+    // Step 4: A slot in the command class; a shed request is not charged.
+    const CommandClass cls = classify(msg.payload);
+    if (!enter(cls)) {
+        rate.session.requests.giveBack(requests, m_limits.sessionRequestsPerSec);
+        rate.session.bytes.giveBack(bytes, m_limits.sessionBytesPerSec);
+        if (user) {
+            user->requests.giveBack(requests, m_limits.userRequestsPerSec);
+            user->bytes.giveBack(bytes, m_limits.userBytesPerSec);
+        }
+        EMIT_DEBUG() << "Request shed (class" << static_cast<int>(cls) << "saturated). Sender:"
+                     << msg.senderId.c_str();
+        return ErrorCode::ERR_SERVER_BUSY;
+    }
+
+    m_admitted.fetch_add(1, std::memory_order_relaxed);
+    return ErrorCode::SUCCESS;
+}
+
+void RateLimitPolicy::release(const Message& msg) {
+    if (m_inner) {
+        m_inner->release(msg);
+    }
+    if (msg.auth) {
+        leave(classify(msg.payload));
+    }
+}
+
+ErrorCode RateLimitPolicy::validateSubCommand(const Message& msg) {
+    if (m_inner) {
+        const ErrorCode inner = m_inner->validateSubCommand(msg);
+        if (inner != ErrorCode::SUCCESS) {
+            return inner;
+        }
+    }
+    // The batch frame already paid the tokens; only the class slot is taken here.
+    if (msg.auth && !enter(classify(msg.payload))) {
+        EMIT_DEBUG() << "Sub-command shed (class saturated). Sender:" << msg.senderId.c_str();
+        return ErrorCode::ERR_SERVER_BUSY;
+    }
+    return ErrorCode::SUCCESS;
+}
+
+void RateLimitPolicy::releaseSubCommand(const Message& msg) {
+    if (m_inner) {
+        m_inner->releaseSubCommand(msg);
+    }
+    if (msg.auth) {
+        leave(classify(msg.payload));
+    }
+}
+
+bool RateLimitPolicy::enter(CommandClass cls) {
+    const int index = static_cast<int>(cls);
+    const int cap = m_limits.maxConcurrent[index];
+    if (m_running[index].fetch_add(1, std::memory_order_acq_rel) >= cap && cap > 0) {
+        m_running[index].fetch_sub(1, std::memory_order_acq_rel);
+        m_shed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void RateLimitPolicy::leave(CommandClass cls) {
+    m_running[static_cast<int>(cls)].fetch_sub(1, std::memory_order_acq_rel);
+}
+
+RateLimitPolicy::Stats RateLimitPolicy::stats() const {
+    Stats s;
+    s.admitted         = m_admitted.load(std::memory_order_relaxed);
+    s.sessionThrottled = m_sessionThrottled.load(std::memory_order_relaxed);
+    s.userThrottled    = m_userThrottled.load(std::memory_order_relaxed);
+    s.shed             = m_shed.load(std::memory_order_relaxed);
+    return s;
+}
+
+RateLimitPolicy::CommandClass RateLimitPolicy::classify(const std::string& payload) {
+    // Step 1: First word, after the blanks the handler trims.
+    size_t end = 0;
+    const std::string verb = firstWord(payload, end);
+
+    // Step 2: Map it to its class.
+    if (verbIs(verb, "AUTH")) {
+        return CommandClass::Auth;
+    }
+    if (verbIs(verb, "READ") || verbIs(verb, "LIST") || verbIs(verb, "INFO") || verbIs(verb, "CHECKSUM")
+        || verbIs(verb, "SIGNATURE")) {
+        return CommandClass::Read;
+    }
+    if (verbIs(verb, "CREATE") || verbIs(verb, "WRITE") || verbIs(verb, "APPEND") || verbIs(verb, "DELETE")
+        || verbIs(verb, "RENAME") || verbIs(verb, "COPY") || verbIs(verb, "TXN") || verbIs(verb, "DELTA")) {
+        return CommandClass::Write;
+    }
+    if (verbIs(verb, "GREP") || verbIs(verb, "SEARCH")) {
+        return CommandClass::Search;
+    }
+    return CommandClass::Other;
+}
+
+int RateLimitPolicy::requestCount(const std::string& payload) {
+    // Step 1: Only a batch stands for more than one request.
+    size_t end = 0;
+    if (!verbIs(firstWord(payload, end), "MULTI")) {
+        return 1;
+    }
+
+    // Step 2: One per non-blank line between the MULTI line and EXEC.
+    const size_t first = payload.find('\n', end);
+    if (first == std::string::npos) {
+        return 1;
+    }
+    int lines = 0;
+    bool blank = true;
+    for (size_t i = first; i < payload.size(); ++i) {
+        if (payload[i] == '\n') {
+            lines += blank ? 0 : 1;
+            blank = true;
+        } else if (!std::isspace(static_cast<unsigned char>(payload[i]))) {
+            blank = false;
+        }
+    }
+    lines += blank ? 0 : 1;
+    return qMax(1, lines - 1);
+}
+
+RateBuckets* RateLimitPolicy::userBuckets(AuthTicket& ticket) {
+    // Step 1: Cached for the current grant (the common case).
+    AuthTicket::Rate& rate = ticket.rate();
+    const quint64 grants = ticket.grants();
+    if (rate.userGrant.load(std::memory_order_acquire) == grants) {
+        if (RateBuckets* cached = rate.user.load(std::memory_order_acquire)) {
+            return cached;
+        }
+    }
+
+    // Step 2: First request since AUTH: find (or create) the user's buckets.
+    const QString username = ticket.username();
+    RateBuckets* buckets;
+    {
+        QMutexLocker locker(&m_usersMutex);
+        std::unique_ptr<RateBuckets>& slot = m_users[username];
+        if (!slot) {
+            slot.reset(new RateBuckets());
+        }
+        buckets = slot.get();
+    }
+    rate.user.store(buckets, std::memory_order_release);
+    rate.userGrant.store(grants, std::memory_order_release);
+    return buckets;
+}
+
+bool RateLimitPolicy::admit(RateBuckets& buckets, qint64 requests, qint64 bytes, qint64 nowNs,
+                            qint64 requestsPerSec, qint64 requestBurst, qint64 bytesPerSec, qint64 byteBurst) {
+    if (!buckets.requests.tryTake(requests, requestsPerSec, requestBurst, nowNs)) {
+        return false;
+    }
+    if (!buckets.bytes.tryTake(bytes, bytesPerSec, byteBurst, nowNs)) {
+        buckets.requests.giveBack(requests, requestsPerSec);
+        return false;
+    }
+    return true;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
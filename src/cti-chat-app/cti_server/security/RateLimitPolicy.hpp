@@ -0,0 +1,147 @@
+/**
+ * @file RateLimitPolicy.hpp
+ * @brief Definition of the RateLimitPolicy class, per-client throttling and overload shedding.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the security policy that refuses, before any command
+ * runs, the requests of a client going faster than its share and the
+ * requests that would overload a class of commands.
+ */
+
+#ifndef RATELIMITPOLICY_HPP
+#define RATELIMITPOLICY_HPP
+
+// Qt Depends
+#include <QMutex>
+#include <QString>
+
+// Other
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "security/ISecurityPolicy.hpp"
+#include "domain/TokenBucket.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class RateLimitPolicy
+ * @brief Token buckets per session and per user, plus global concurrency caps.
+ *
+ * Decorates another policy (the payload checks): a message it accepts is
+ * then admitted only if
+ * - the session's request and byte buckets hold a token / its payload size,
+ * - once authenticated, the user's buckets (shared by all its sessions) do too,
+ * - fewer than the class limit of requests of its command class (AUTH, read,
+ *   write, search, other) are running server-wide.
+ * Otherwise validate() answers ERR_SERVER_BUSY and the ChatServer replies
+ * "ERROR 503 SERVER_BUSY" without reaching the command handler. Nothing is
+ * charged for a refused message: tokens already taken are given back.
+ *
+ * A MULTI batch costs one request token per sub-command. The batch itself
+ * takes no class slot; each sub-command takes the slot of its own class while
+ * it runs (validateSubCommand()), and is answered busy when that class is
+ * saturated.
+ *
+ * Nothing on that path locks: the buckets are single atomic words (TokenBucket)
+ * stored in the session's AuthTicket, the user's buckets are cached there
+ * too, and the class counters are atomics. Only the first message after a
+ * (re)authentication looks the user up in a mutex-protected table.
+ */
+class RateLimitPolicy : public ISecurityPolicy {
+public:
+    /** @brief Groups of commands sharing a concurrency limit. */
+    enum class CommandClass { Auth, Read, Write, Search, Other, Count };
+
+    /**
+     * @struct Limits
+     * @brief Rates (per second; 0 = unlimited), bursts and concurrency caps.
+     */
+    struct Limits {
+        qint64 sessionRequestsPerSec;
+        qint64 sessionRequestBurst;
+        qint64 sessionBytesPerSec;
+        qint64 sessionByteBurst;
+        qint64 userRequestsPerSec;
+        qint64 userRequestBurst;
+        qint64 userBytesPerSec;
+        qint64 userByteBurst;
+        /** @brief Requests of each CommandClass allowed to run at once (0 = unlimited). */
+        std::array<int, static_cast<int>(CommandClass::Count)> maxConcurrent;
+
+        /** @brief Limits from constants.hpp. */
+        static Limits defaults();
+    };
+
+    /**
+     * @struct Stats
+     * @brief Admission counters.
+     */
+    struct Stats {
+        quint64 admitted = 0;
+        quint64 sessionThrottled = 0;
+        quint64 userThrottled = 0;
+        quint64 shed = 0;
+    };
+
+    /**
+     * @param inner Policy checked first (message content).
+     * @param limits Rates and caps.
+     */
+    explicit RateLimitPolicy(std::shared_ptr<ISecurityPolicy> inner, const Limits& limits = Limits::defaults());
+
+    ErrorCode validate(const Message& msg) override;
+    void release(const Message& msg) override;
+    ErrorCode validateSubCommand(const Message& msg) override;
+    void releaseSubCommand(const Message& msg) override;
+
+    /** @brief Returns the admission counters. */
+    Stats stats() const;
+
+    /** @brief Command class of a frame, from its verb. */
+    static CommandClass classify(const std::string& payload);
+
+    /** @brief Requests a frame stands for: its sub-commands for MULTI, otherwise 1. */
+    static int requestCount(const std::string& payload);
+
+private:
+    /** @brief The user's buckets, resolved once per grant of the ticket. */
+    RateBuckets* userBuckets(AuthTicket& ticket);
+
+    /** @brief Takes @p requests and @p bytes from @p buckets, or nothing. */
+    static bool admit(RateBuckets& buckets, qint64 requests, qint64 bytes, qint64 nowNs,
+                      qint64 requestsPerSec, qint64 requestBurst, qint64 bytesPerSec, qint64 byteBurst);
+
+    /** @brief Takes a running slot of @p cls; false if the class is saturated. */
+    bool enter(CommandClass cls);
+
+    /** @brief Frees a slot taken by enter(). */
+    void leave(CommandClass cls);
+
+    const std::shared_ptr<ISecurityPolicy> m_inner;
+    const Limits m_limits;
+
+    /** @brief Protects m_users (slow path only). */
+    QMutex m_usersMutex;
+
+    /** @brief Buckets per user name; entries live as long as the policy. */
+    std::unordered_map<QString, std::unique_ptr<RateBuckets>> m_users;
+
+    /** @brief Running requests per command class. */
+    std::array<std::atomic<int>, static_cast<int>(CommandClass::Count)> m_running{};
+
+    std::atomic<quint64> m_admitted{0};
+    std::atomic<quint64> m_sessionThrottled{0};
+    std::atomic<quint64> m_userThrottled{0};
+    std::atomic<quint64> m_shed{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* RATELIMITPOLICY_HPP */
@@ -9,6 +9,7 @@
 #include "ChatServer.hpp"
 #include "error/error_codes.hpp"
 #include "error/error_emitter.hpp"
+#include "metrics/Metrics.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -34,51 +35,68 @@ ChatServer::ChatServer(std::shared_ptr<IMessageParser> parser,
 /**
  * @brief Internal pipeline to transform raw input into a processed response.
  * @param data Raw byte array from a client.
- * @return QByteArray The serialized response. Returns empty array on security failure.
+ * @return The serialized response. Returns an empty list on security failure.
  */
-QByteArray ChatServer::process(const QByteArray& data, const std::string& clientId) {
+QByteArrayList ChatServer::process(const QByteArray& data, const std::string& clientId,
+                                   const std::shared_ptr<AuthTicket>& auth) {
     EMIT_DEBUG() << "Processing incoming data bundle.";
+    Metrics::add(Metrics::Counter::Requests);
+    Metrics::Stopwatch watch;
 
     // 1. Parsing
     Message msg = m_parser->parse(data);
     msg.senderId = clientId;
+    msg.auth = auth;
+    watch.lap(Metrics::Histogram::Parse);
 
     // 2. Security Validation
-    if (ErrorCode::SUCCESS != m_security->validate(msg)) {
+    const ErrorCode verdict = m_security->validate(msg);
+    watch.lap(Metrics::Histogram::Validate);
+    if (ErrorCode::ERR_SERVER_BUSY == verdict) {
+        // Throttled or shed: tell the client to back off, before any work is done.
+        Metrics::add(Metrics::Counter::Busy);
+        return m_parser->serialize(Message{"ERROR 503 SERVER_BUSY", "Server"});
+    }
+    if (ErrorCode::SUCCESS != verdict) {
         EMIT_ERROR() << "Security validation failed. Dropping packet.";
-        return QByteArray(); 
+        Metrics::add(Metrics::Counter::Rejected);
+        return QByteArrayList(); 
     }
 
     // 3. Business Logic Handling
     EMIT_DEBUG() << "Executing message command handler.";
     Message out = m_handler->handle(msg);
+    m_security->release(msg);
+    watch.lap(Metrics::Histogram::Handle);
 
     // 4. Serialization
-    return m_parser->serialize(out);
+    QByteArrayList parts = m_parser->serialize(out);
+    watch.lap(Metrics::Histogram::Serialize);
+    return parts;
 }
 
 /**
  * @brief Sends a specific data packet to a single client.
- * @param data Serialized message bytes.
+ * @param parts Serialized message buffers.
  * @param clientId Unique identifier for the target session.
  */
-void ChatServer::sendTo(const QByteArray& data, const std::string& clientId) {
-    if (data.isEmpty()) return;
-    m_sessions->broadcast(data, clientId);
+void ChatServer::sendTo(const QByteArrayList& parts, const std::string& clientId) {
+    if (parts.isEmpty()) return;
+    m_sessions->broadcast(parts, clientId);
 }
 
 /**
  * @brief Broadcasts a data packet to all currently connected clients.
- * @param data Serialized message bytes.
+ * @param parts Serialized message buffers.
  */
-void ChatServer::broadcast(const QByteArray& data, const std::string& clientId) {
-    if (data.isEmpty()) {
+void ChatServer::broadcast(const QByteArrayList& parts, const std::string& clientId) {
+    if (parts.isEmpty()) {
         EMIT_DEBUG() << "Broadcast skipped: Data is empty.";
         return;
     }
     
     EMIT_INFO() << "Broadcasting message to specific client.";
-    m_sessions->broadcast(data, clientId);
+    m_sessions->broadcast(parts, clientId);
 }
 
 /**
@@ -87,14 +105,36 @@ void ChatServer::broadcast(const QByteArray& data, const std::string& clientId)
  * Pipeline: Parse -> Security Check -> Handle Logic -> Serialize -> Broadcast.
  * 
  * @param data The raw byte array received from a ClientSession.
+ * @param clientId Unique identifier of the sending session.
+ * @param auth Authentication ticket of the sending session.
+ * @param requestId Request id to echo, empty for untagged frames.
  */
-void ChatServer::processAndBroadcast(const QByteArray& data, const std::string& clientId) {
-    QByteArray processedData = process(data, clientId);
+void ChatServer::processAndBroadcast(const QByteArray& data, const std::string& clientId,
+                                     const std::shared_ptr<AuthTicket>& auth,
+                                     const QByteArray& requestId) {
+    QByteArrayList processedData = process(data, clientId, auth);
+
+    // A tagged request always gets its (tagged) answer, so the client can retire it.
+    if (!requestId.isEmpty()) {
+        if (processedData.isEmpty()) {
+            processedData.append(QByteArrayLiteral("ERROR 400 REJECTED"));
+        }
+        processedData.first().prepend('#' + requestId + ' ');
+    }
     
     if (!processedData.isEmpty()) {
         broadcast(processedData, clientId);
     }
 }
 
+/**
+ * @brief Serializes a server-initiated message and sends it to one client.
+ * @param msg The message to push.
+ * @param clientId Unique identifier for the target session.
+ */
+void ChatServer::notify(const Message& msg, const std::string& clientId) {
+    sendTo(m_parser->serialize(msg), clientId);
+}
+
 } // namespace Chat
 } // namespace CTI
\ No newline at end of file
@@ -55,29 +55,49 @@ public:
      * Orchestrates the internal pipeline: Parse -> Validate -> Handle -> Serialize -> Broadcast.
      * 
      * @param data The raw byte array received from the network.
+     * @param clientId The unique identifier of the sending session.
+     * @param auth Authentication ticket of the sending session.
+     * @param requestId Request id of a pipelined frame; when set, the response
+     *        is prefixed with "#<requestId> " and is always sent, even for a
+     *        frame dropped by the security policy.
      */
-    void processAndBroadcast(const QByteArray& data, const std::string& clientId);
+    void processAndBroadcast(const QByteArray& data, const std::string& clientId,
+                             const std::shared_ptr<AuthTicket>& auth,
+                             const QByteArray& requestId = QByteArray());
+
+    /**
+     * @brief Pushes a server-initiated message (e.g. a WATCH event) to one client.
+     *
+     * Safe to call from any thread; delivery happens on the session's thread.
+     *
+     * @param msg The message to serialize and send.
+     * @param clientId The unique identifier for the target session.
+     */
+    void notify(const Message& msg, const std::string& clientId);
 
 private:
     /**
      * @brief Internal method to run the message through the parsing and logic pipeline.
      * @param data Raw byte array.
-     * @return QByteArray Serialized result message.
+     * @param clientId The unique identifier of the sending session.
+     * @param auth Authentication ticket of the sending session.
+     * @return Serialized result message (its buffers); empty if the frame was dropped.
      */
-    QByteArray process(const QByteArray& data, const std::string& clientId);
+    QByteArrayList process(const QByteArray& data, const std::string& clientId,
+                           const std::shared_ptr<AuthTicket>& auth);
 
     /**
      * @brief Internal method to distribute data to all connected clients.
-     * @param data The serialized byte array to broadcast.
+     * @param parts The serialized message to broadcast.
      */
-    void broadcast(const QByteArray& data, const std::string& clientId);
+    void broadcast(const QByteArrayList& parts, const std::string& clientId);
 
     /**
      * @brief Internal method to send data to a specific client.
-     * @param data The serialized byte array.
+     * @param parts The serialized message.
      * @param clientId The unique identifier for the target session.
      */
-    void sendTo(const QByteArray& data, const std::string& clientId);
+    void sendTo(const QByteArrayList& parts, const std::string& clientId);
 
 private:
     /** @brief Component responsible for data transformation. */
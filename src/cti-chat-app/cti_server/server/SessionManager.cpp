@@ -51,6 +51,8 @@ void SessionManager::remove(IClientSession* session) {
     QMutexLocker lock(&m_mutex);
     
     EMIT_DEBUG() << "Removing session.";
+    const ClientInfo* info = session->getClientInfo();
+    const std::string clientId = info ? info->id : std::string();
     
     // Step 2: Locate and remove the specific pointer using std::remove
     // remove takes start -> end and searches for element and delete it.
@@ -63,6 +65,24 @@ void SessionManager::remove(IClientSession* session) {
         std::remove(m_sessions.begin(), m_sessions.end(), session),
         m_sessions.end()
     );
+
+    // Step 3: Let per-client services release their state (outside the lock)
+    const auto listeners = m_removeListeners;
+    lock.unlock();
+    if (!clientId.empty()) {
+        for (const auto& listener : listeners) {
+            listener(clientId);
+        }
+    }
+}
+
+/**
+ * @brief Registers a callback invoked with the id of each removed session.
+ * @param listener The callback.
+ */
+void SessionManager::addRemoveListener(std::function<void(const std::string&)> listener) {
+    QMutexLocker lock(&m_mutex);
+    m_removeListeners.append(std::move(listener));
 }
 
 /**
@@ -72,9 +92,9 @@ void SessionManager::remove(IClientSession* session) {
  * The method maintains a lock on the container throughout the iteration to 
  * prevent modification by other threads during the broadcast.
  * 
- * @param data The QByteArray containing the message to broadcast.
+ * @param parts The buffers of the message to broadcast.
  */
-void SessionManager::broadcast(const QByteArray& data, const std::string& clientId) {
+void SessionManager::broadcast(const QByteArrayList& parts, const std::string& clientId) {
     // Step 1: Acquire lock to protect the container during iteration
     QMutexLocker lock(&m_mutex);
     
@@ -99,8 +119,8 @@ void SessionManager::broadcast(const QByteArray& data, const std::string& client
         QObject* obj = dynamic_cast<QObject*>(session);
         if (obj) {
             // QMetaObject::invokeMethod(obj, "send", Qt::QueuedConnection, Q_ARG(QByteArray, data));
-            QMetaObject::invokeMethod(obj, [session, data]() {
-                session->send(data);
+            QMetaObject::invokeMethod(obj, [session, parts]() {
+                session->send(parts);
             }, Qt::QueuedConnection);
         }
     }
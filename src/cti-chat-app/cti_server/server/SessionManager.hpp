@@ -17,8 +17,11 @@
 #include <QMutex>
 #include <QMetaObject>
 #include <QByteArray>
+#include <QByteArrayList>
 // Other
 #include "core/IClientSession.hpp"
+#include <functional>
+#include <string>
 
 namespace CTI {
 namespace Chat {
@@ -64,9 +67,19 @@ public:
      * A lock is held during the entire duration of the broadcast to ensure 
      * no sessions are added or removed while sending.
      * 
-     * @param data The data packet to be transmitted to every client.
+     * @param parts The buffers of the frame to be transmitted.
      */
-    void broadcast(const QByteArray& data, const std::string& clientId);
+    void broadcast(const QByteArrayList& parts, const std::string& clientId);
+
+    /**
+     * @brief Registers a callback run after a session has been removed.
+     *
+     * Used by services that keep per-client state (e.g. WATCH subscriptions)
+     * to release it when the client goes away.
+     *
+     * @param listener Receives the id of the removed client.
+     */
+    void addRemoveListener(std::function<void(const std::string&)> listener);
 
     /**
      * @brief Returns the current active sessions.
@@ -88,6 +101,9 @@ private:
      * Used for iterating during broadcasts.
      */
     QVector<IClientSession*> m_sessions;
+
+    /** @brief Callbacks notified with the client id of every removed session. */
+    QVector<std::function<void(const std::string&)>> m_removeListeners;
 };
 
 } /* namespace Chat */
@@ -18,7 +18,10 @@
 #include <memory>
 
 #include "core/IMessageHandler.hpp"
+#include "security/ISecurityPolicy.hpp"
+#include "constants.hpp"
 #include "cmd_message_handler/CommandFactory.hpp"
+#include "metrics/Metrics.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -33,13 +36,33 @@ namespace Chat {
  * 
  * This class ensures that the ChatServer remains decoupled from the specific 
  * implementation of file operations, authentication, or administrative tasks.
+ *
+ * Batches: a frame of the form
+ *
+ *     MULTI [STOP]\n<command>\n<command>\n...\nEXEC
+ *
+ * runs its sub-commands in order and answers with a single frame:
+ * "OK MULTI executed=<n> total=<m>[ stopped]\n" followed, per executed
+ * sub-command, by "RESULT <i> <bytes>\n" and exactly <bytes> bytes of its
+ * response plus "\n". With STOP the batch ends at the first ERROR response.
+ * The frame passes the security policy once as a whole (paying one request
+ * per sub-command); each sub-command then holds its own class slot through
+ * ISecurityPolicy::validateSubCommand() while it runs, and is answered
+ * "ERROR 503 SERVER_BUSY" when its class is saturated. The sub-commands'
+ * authorization checks read the session's ticket (no shared lookup), so a
+ * batch may also start with AUTH.
  */
 class CmdMessageHandler : public IMessageHandler {
 public:
     /**
      * @brief Constructs the handler and initializes the command registry factory.
+     * @param fs Shared storage services used by the file commands.
+     * @param policy Security policy admitting the sub-commands of a batch (optional).
      */
-    CmdMessageHandler() : m_factory(std::make_unique<CommandFactory>()) {}
+    explicit CmdMessageHandler(std::shared_ptr<FileServices> fs,
+                               std::shared_ptr<ISecurityPolicy> policy = nullptr)
+        : m_factory(std::make_unique<CommandFactory>(std::move(fs))),
+          m_policy(std::move(policy)) {}
 
     /**
      * @brief Orchestrates the command execution lifecycle.
@@ -63,7 +86,24 @@ public:
     Message handle(const Message& msg) override {
         // Prepare payload for processing
         QString payload = QString::fromStdString(msg.payload).trimmed();
-        
+
+        // Commands check authorization against the sender's own ticket.
+        SecurityState::RequestScope scope(msg.auth);
+
+        if (isBatch(payload)) {
+            return handleBatch(payload, msg);
+        }
+
+        return dispatch(payload, msg.senderId);
+    }
+
+private:
+    /**
+     * @brief Resolves and executes a single command line.
+     * @param payload The trimmed command line ("VERB arg,arg").
+     * @param senderId The connection the command came from.
+     */
+    Message dispatch(const QString& payload, const std::string& senderId) {
         // 1. Tokenize Command Verb
         /**
          * payload: AUTH admin,password
@@ -83,22 +123,123 @@ public:
 
         // 3. Inject Sender Identity
         // We prepend it so the command always knows args[0] is the SenderID
-        args.prepend(QString::fromStdString(msg.senderId)); 
+        args.prepend(QString::fromStdString(senderId)); 
 
-        // 4. Command Resolution and Execution
-        auto command = m_factory->create(cmdName);
+        // 4. Command Resolution and Execution (timed per verb)
+        const Metrics::Stopwatch watch;
+        int verb = Metrics::UNKNOWN_VERB;
+        auto command = m_factory->create(cmdName, &verb);
+
+        // File arguments are canonicalized once, here; invalid ones become "".
         if (command) {
-            return command->execute(args);
+            for (int index : command->pathArguments(args)) {
+                if (index < args.size()) {
+                    args[index] = ICommand::canonicalPath(args[index]);
+                }
+            }
         }
 
         // 5. Fallback for Unrecognized Commands
-        return Message("ERROR 404 COMMAND_NOT_FOUND", "Server");
+        Message result = command ? command->execute(args)
+                                 : Message("ERROR 404 COMMAND_NOT_FOUND", "Server");
+        Metrics::recordVerb(verb, watch.elapsed(), result.payload.rfind("ERROR", 0) == 0);
+        return result;
     }
-private:
+
+    /**
+     * @brief Runs one sub-command of a batch inside its own policy slot.
+     * @param line The trimmed sub-command.
+     * @param msg The batch message (sender and ticket).
+     */
+    Message dispatchAdmitted(const QString& line, const Message& msg) {
+        if (!m_policy) {
+            return dispatch(line, msg.senderId);
+        }
+
+        Message request{line.toStdString(), msg.senderId};
+        request.auth = msg.auth;
+        if (m_policy->validateSubCommand(request) != ErrorCode::SUCCESS) {
+            return Message("ERROR 503 SERVER_BUSY", "Server");
+        }
+        Message result = dispatch(line, msg.senderId);
+        m_policy->releaseSubCommand(request);
+        return result;
+    }
+
+    /** @brief True if the line starts with the MULTI verb. */
+    static bool isBatch(const QString& payload) {
+        return payload.startsWith(QLatin1String("MULTI"), Qt::CaseInsensitive)
+               && (payload.size() == 5 || payload.at(5).isSpace());
+    }
+
+    /**
+     * @brief Executes a MULTI ... EXEC frame (see class description).
+     * @param payload The trimmed batch frame.
+     * @param msg The batch message (sender and ticket).
+     */
+    Message handleBatch(const QString& payload, const Message& msg) {
+        // Step 1: Split into the MULTI line, the sub-commands and EXEC.
+        QStringList lines = payload.split('\n', Qt::SkipEmptyParts);
+        for (QString& line : lines) {
+            line = line.trimmed();
+        }
+        lines.removeAll(QString());
+
+        const QStringList options = lines.takeFirst().split(' ', Qt::SkipEmptyParts).mid(1);
+        bool stopOnError = false;
+        for (const QString& option : options) {
+            if (option.compare(QLatin1String("STOP"), Qt::CaseInsensitive) != 0) {
+                return Message("ERROR 400 BAD_REQUEST", "Server");
+            }
+            stopOnError = true;
+        }
+        if (lines.isEmpty() || lines.last().compare(QLatin1String("EXEC"), Qt::CaseInsensitive) != 0) {
+            EMIT_WARN() << "MULTI rejected: Batch not terminated by EXEC.";
+            return Message("ERROR 400 BAD_REQUEST", "Server");
+        }
+        lines.removeLast();
+        if (lines.size() > Constants::MULTI_MAX_COMMANDS) {
+            EMIT_WARN() << "MULTI rejected:" << lines.size() << "sub-commands.";
+            return Message("ERROR 413 BATCH_TOO_LARGE", "Server");
+        }
+
+        // Step 2: Run in order, collecting each serialized response.
+        QByteArray results;
+        int executed = 0;
+        bool stopped = false;
+        for (const QString& line : lines) {
+            Message sub = isBatch(line)
+                              ? Message("ERROR 400 NESTED_MULTI", "Server")
+                              : dispatchAdmitted(line, msg);
+
+            const qsizetype bytes = static_cast<qsizetype>(sub.payload.size()) + sub.body.size();
+            results.append("RESULT ").append(QByteArray::number(executed))
+                   .append(' ').append(QByteArray::number(bytes)).append('\n');
+            results.append(sub.payload.data(), static_cast<qsizetype>(sub.payload.size()));
+            results.append(sub.body).append('\n');
+            ++executed;
+
+            if (stopOnError && sub.payload.rfind("ERROR", 0) == 0) {
+                stopped = executed < lines.size();
+                break;
+            }
+        }
+
+        EMIT_INFO() << "MULTI executed" << executed << "of" << lines.size() << "sub-commands.";
+        QString header = QString("OK MULTI executed=%1 total=%2%3\n")
+                         .arg(executed).arg(lines.size()).arg(stopped ? " stopped" : "");
+        Message res{header.toStdString(), "Server"};
+        res.body = std::move(results);
+        return res;
+    }
+
     /** 
      * @brief The factory used to resolve string-based verbs into command objects. 
      */
     std::unique_ptr<CommandFactory> m_factory;
+
+    /** @brief Admits the sub-commands of a batch; null admits them all. */
+    std::shared_ptr<ISecurityPolicy> m_policy;
 };
 
 } /* namespace Chat */
@@ -0,0 +1,296 @@
+/**
+ * @file AdminCommands.hpp
+ * @brief Operational commands exposing server internals to authenticated clients.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file contains commands that do not touch user files but report on
+ * the state of the server itself (caches, counters, ...).
+ */
+
+#ifndef ADMINCOMMANDS_HPP
+#define ADMINCOMMANDS_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include "FileCommands.hpp"
+#include "error/log_backend.hpp"
+#include "metrics/Metrics.hpp"
+#include "network/RequestPipeline.hpp"
+#include "transport/TlsContext.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class StatsCommand
+ * @brief Reports runtime counters of the storage services.
+ * @details args: [0] senderId, [1] optional section ("locks")
+ *
+ * Response: "OK" followed by space-separated key=value pairs, e.g.
+ * "OK cache_hits=10 cache_misses=2 ... append_batches=3 lock_contended=1".
+ *
+ * "STATS locks" lists the per-stripe lock counters instead, one line per
+ * stripe that has been used: "stripe=<i> acquired=<n> contended=<m>".
+ */
+class StatsCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() > 1 && args[1].trimmed().compare("locks", Qt::CaseInsensitive) == 0) {
+            return lockStats();
+        }
+
+        const ContentCache::Stats cache = m_fs->cache().stats();
+        const AppendWriter::Stats appends = m_fs->appender().stats();
+
+        QString res = QString("OK cache_hits=%1 cache_misses=%2 cache_evictions=%3 "
+                              "cache_entries=%4 cache_bytes=%5")
+                      .arg(cache.hits)
+                      .arg(cache.misses)
+                      .arg(cache.evictions)
+                      .arg(cache.entries)
+                      .arg(cache.bytes);
+        res += QString(" append_requests=%1 append_batches=%2 append_writes=%3 "
+                       "append_syncs=%4 append_bytes=%5")
+               .arg(appends.appends)
+               .arg(appends.batches)
+               .arg(appends.writes)
+               .arg(appends.syncs)
+               .arg(appends.bytes);
+
+        quint64 acquisitions = 0;
+        quint64 contended = 0;
+        for (const auto& stripe : m_fs->locks().stats()) {
+            acquisitions += stripe.acquisitions;
+            contended += stripe.contended;
+        }
+        res += QString(" lock_acquisitions=%1 lock_contended=%2").arg(acquisitions).arg(contended);
+
+        const ContentDigest::Stats digests = m_fs->digests().stats();
+        res += QString(" digest_hits=%1 digest_misses=%2 digest_bytes=%3")
+               .arg(digests.hits)
+               .arg(digests.misses)
+               .arg(digests.bytesHashed);
+
+        const DeltaSync::Stats delta = m_fs->delta().stats();
+        res += QString(" delta_signatures=%1 delta_signature_blocks=%2 delta_applied=%3 "
+                       "delta_rejected=%4 delta_literal_bytes=%5 delta_copied_bytes=%6 delta_cpu_us=%7")
+               .arg(delta.signatures)
+               .arg(delta.signatureBlocks)
+               .arg(delta.deltas)
+               .arg(delta.rejected)
+               .arg(delta.literalBytes)
+               .arg(delta.copiedBytes)
+               .arg(delta.cpuMicros);
+
+        const AuthSessionTable::Stats auth = SecurityState::sessions().stats();
+        res += QString(" auth_active=%1 auth_capacity=%2 auth_logins=%3 auth_evicted=%4 "
+                       "auth_expired=%5 auth_logged_out=%6")
+               .arg(auth.active)
+               .arg(auth.capacity)
+               .arg(auth.logins)
+               .arg(auth.evicted)
+               .arg(auth.expired)
+               .arg(auth.loggedOut);
+
+        const CredentialStore::Stats creds = SecurityState::credentials().stats();
+        res += QString(" cred_users=%1 cred_reloads=%2 cred_verified=%3 cred_denied=%4 cred_busy=%5")
+               .arg(creds.users)
+               .arg(creds.reloads)
+               .arg(creds.verified)
+               .arg(creds.denied)
+               .arg(creds.busy);
+
+        const TlsContext::Stats tls = TlsContext::stats();
+        const quint64 tlsHandshakes = tls.full + tls.resumed;
+        res += QString(" tls_full=%1 tls_resumed=%2 tls_failed=%3 tls_resume_ratio=%4 "
+                       "tls_handshake_avg_us=%5 tls_cached_sessions=%6")
+               .arg(tls.full)
+               .arg(tls.resumed)
+               .arg(tls.failed)
+               .arg(tlsHandshakes ? double(tls.resumed) / tlsHandshakes : 0.0, 0, 'f', 3)
+               .arg(tlsHandshakes ? tls.handshakeMicros / tlsHandshakes : 0)
+               .arg(tls.cachedSessions);
+
+        const WatchRegistry::Stats watches = m_fs->watches().stats();
+        res += QString(" watch_paths=%1 watch_subscriptions=%2 watch_pushes=%3")
+               .arg(watches.paths)
+               .arg(watches.subscriptions)
+               .arg(watches.pushes);
+
+        if (FullTextIndex* fulltext = m_fs->fulltext()) {
+            const FullTextIndex::Stats fts = fulltext->stats();
+            res += QString(" fts_docs=%1 fts_terms=%2 fts_overlay=%3 fts_tombstones=%4 fts_rebuilds=%5")
+                   .arg(fts.baseDocs)
+                   .arg(fts.baseTerms)
+                   .arg(fts.overlayDocs)
+                   .arg(fts.tombstones)
+                   .arg(fts.rebuilds);
+        }
+
+        EMIT_DEBUG() << "STATS served to:" << args[0];
+        return Message{res.toStdString(), "Server"};
+    }
+
+private:
+    /** @brief Builds the per-stripe contention report. */
+    Message lockStats() {
+        const auto stripes = m_fs->locks().stats();
+
+        QStringList lines;
+        for (int i = 0; i < stripes.size(); ++i) {
+            if (stripes[i].acquisitions == 0) {
+                continue;
+            }
+            lines << QString("stripe=%1 acquired=%2 contended=%3")
+                     .arg(i)
+                     .arg(stripes[i].acquisitions)
+                     .arg(stripes[i].contended);
+        }
+
+        QString res = QString("OK %1\n%2").arg(lines.size()).arg(lines.join("\n"));
+        return Message{res.toStdString(), "Server"};
+    }
+};
+
+/**
+ * @class LogLevelCommand
+ * @brief Reads or changes the runtime log level of each server module.
+ * @details args: [0] senderId, [1..] optional settings, "<level>" or "<module>=<level>"
+ *
+ * Modules: core, transport, session, security, commands, storage (or "all");
+ * levels: critical, error, warn, info, debug. A bare level applies to every
+ * module; "default" restores the startup levels. The settings are checked
+ * before any is applied. Administrators only (ERROR 403 FORBIDDEN otherwise).
+ *
+ * Response: the resulting levels, e.g. "OK core=error transport=error
+ * session=error security=debug commands=error storage=error".
+ */
+class LogLevelCommand : public ICommand {
+public:
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+        if (!SecurityState::isAdmin(args[0]))
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        // Step 1: Validate every setting first, so a typo changes nothing.
+        const QStringList settings = args.mid(1);
+        for (const QString& setting : settings) {
+            if (!Log::isValidSetting(setting))
+                return Message{"ERROR 400 BAD_REQUEST", "Server"};
+        }
+
+        // Step 2: Apply them in order.
+        for (const QString& setting : settings) {
+            Log::configure(setting);
+        }
+
+        if (!settings.isEmpty()) {
+            EMIT_WARN() << "Log levels changed by" << args[0] << "to:" << Log::describeLevels();
+        }
+        return Message{("OK " + Log::describeLevels()).toStdString(), "Server"};
+    }
+};
+
+/**
+ * @class MetricsCommand
+ * @brief Reports the Metrics registry: request stages, verbs, traffic and queues.
+ * @details args: [0] senderId, [1] optional section ("sessions")
+ *
+ * Response: "OK" followed by space-separated key=value pairs:
+ * - counters: requests, rejected, busy, bytes_in, bytes_out;
+ * - gauges: queue_pending, queue_running, pool_active (busy worker threads),
+ *   offload_active (busy AUTH threads);
+ * - per histogram (parse, validate, handle, serialize in ns; queue_depth in
+ *   requests): <name>_count, _mean, _p50, _p90, _p99, _p999, _max, with an
+ *   "_ns" suffix for latencies, e.g. "handle_p99_ns=183500";
+ * - per verb that ran: verb_<VERB>=<count>, verb_<VERB>_errors, verb_<VERB>_avg_us.
+ *
+ * "METRICS sessions" lists the traffic of each open connection instead, one
+ * line per connection: "session=<id> bytes_in=<n> bytes_out=<m>".
+ *
+ * Administrators only, like LOGLEVEL (ERROR 403 FORBIDDEN otherwise).
+ */
+class MetricsCommand : public ICommand {
+public:
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+        if (!SecurityState::isAdmin(args[0]))
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        if (args.size() > 1 && args[1].trimmed().compare("sessions", Qt::CaseInsensitive) == 0) {
+            return sessionTraffic();
+        }
+
+        const Metrics::Snapshot snap = Metrics::snapshot();
+
+        QString res = "OK";
+        for (int c = 0; c < Metrics::COUNTER_COUNT; ++c) {
+            res += QString(" %1=%2").arg(QLatin1String(Metrics::name(static_cast<Metrics::Counter>(c)))).arg(snap.counters[c]);
+        }
+        for (int g = 0; g < Metrics::GAUGE_COUNT; ++g) {
+            res += QString(" %1=%2").arg(QLatin1String(Metrics::name(static_cast<Metrics::Gauge>(g)))).arg(snap.gauges[g]);
+        }
+        res += QString(" pool_active=%1 offload_active=%2 metric_threads=%3")
+               .arg(RequestPipeline::pool().activeThreadCount())
+               .arg(RequestPipeline::offloadPool().activeThreadCount())
+               .arg(snap.threads);
+
+        for (int h = 0; h < Metrics::HISTOGRAM_COUNT; ++h) {
+            const auto histogram = static_cast<Metrics::Histogram>(h);
+            const Metrics::Distribution& d = snap.histograms[h];
+            const QString name = QLatin1String(Metrics::name(histogram));
+            const QString unit = (histogram == Metrics::Histogram::QueueDepth) ? "" : "_ns";
+            res += QString(" %1_count=%2").arg(name).arg(d.count);
+            res += QString(" %1_mean%2=%3").arg(name, unit).arg(d.count ? d.sum / d.count : 0);
+            res += QString(" %1_p50%2=%3").arg(name, unit).arg(d.percentile(0.50));
+            res += QString(" %1_p90%2=%3").arg(name, unit).arg(d.percentile(0.90));
+            res += QString(" %1_p99%2=%3").arg(name, unit).arg(d.percentile(0.99));
+            res += QString(" %1_p999%2=%3").arg(name, unit).arg(d.percentile(0.999));
+            res += QString(" %1_max%2=%3").arg(name, unit).arg(d.max);
+        }
+
+        for (const Metrics::Verb& verb : snap.verbs) {
+            if (verb.count == 0) {
+                continue;
+            }
+            res += QString(" verb_%1=%2 verb_%1_errors=%3 verb_%1_avg_us=%4")
+                   .arg(verb.name)
+                   .arg(verb.count)
+                   .arg(verb.errors)
+                   .arg(verb.nanos / verb.count / 1000);
+        }
+
+        EMIT_DEBUG() << "METRICS served to:" << args[0];
+        return Message{res.toStdString(), "Server"};
+    }
+
+private:
+    /** @brief Builds the per-connection traffic report. */
+    Message sessionTraffic() {
+        QStringList lines;
+        for (const Metrics::SessionTraffic& session : Metrics::sessions()) {
+            lines << QString("session=%1 bytes_in=%2 bytes_out=%3")
+                     .arg(session.id)
+                     .arg(session.bytesIn)
+                     .arg(session.bytesOut);
+        }
+
+        QString res = QString("OK %1\n%2").arg(lines.size()).arg(lines.join("\n"));
+        return Message{res.toStdString(), "Server"};
+    }
+};
+
+} // namespace Chat
+} // namespace CTI
+
+#endif // ADMINCOMMANDS_HPP
@@ -16,6 +16,10 @@
 #include <memory>
 #include <QString>
 #include "FileCommands.hpp"
+#include "AdminCommands.hpp"
+#include "SearchCommands.hpp"
+#include "SyncCommands.hpp"
+#include "metrics/Metrics.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -37,17 +41,36 @@ public:
      * The constructor pre-allocates and stores shared instances of every 
      * command defined in the protocol (AUTH, CREATE, WRITE, etc.) into 
      * an internal registry.
+     *
+     * @param fs Shared storage services handed to every file command.
      */
-    CommandFactory() {
+    explicit CommandFactory(std::shared_ptr<FileServices> fs) {
         m_registry["AUTH"]   = std::make_shared<AuthCommand>();
-        m_registry["CREATE"] = std::make_shared<CreateCommand>();
-        m_registry["WRITE"]  = std::make_shared<WriteCommand>();
-        m_registry["APPEND"] = std::make_shared<AppendCommand>();
-        m_registry["READ"]   = std::make_shared<ReadCommand>();
-        m_registry["DELETE"] = std::make_shared<DeleteCommand>();
-        m_registry["RENAME"] = std::make_shared<RenameCommand>();
-        m_registry["LIST"]   = std::make_shared<ListCommand>();
-        m_registry["INFO"]   = std::make_shared<InfoCommand>();
+        m_registry["CREATE"] = std::make_shared<CreateCommand>(fs);
+        m_registry["WRITE"]  = std::make_shared<WriteCommand>(fs);
+        m_registry["TXN"]    = std::make_shared<TxnCommand>(fs);
+        m_registry["APPEND"] = std::make_shared<AppendCommand>(fs);
+        m_registry["READ"]   = std::make_shared<ReadCommand>(fs);
+        m_registry["DELETE"] = std::make_shared<DeleteCommand>(fs);
+        m_registry["RENAME"] = std::make_shared<RenameCommand>(fs);
+        m_registry["COPY"]   = std::make_shared<CopyCommand>(fs);
+        m_registry["LIST"]   = std::make_shared<ListCommand>(fs);
+        m_registry["INFO"]   = std::make_shared<InfoCommand>(fs);
+        m_registry["CHECKSUM"] = std::make_shared<ChecksumCommand>(fs);
+        m_registry["SIGNATURE"] = std::make_shared<SignatureCommand>(fs);
+        m_registry["DELTA"]  = std::make_shared<DeltaCommand>(fs);
+        m_registry["WATCH"]  = std::make_shared<WatchCommand>(fs);
+        m_registry["UNWATCH"] = std::make_shared<UnwatchCommand>(fs);
+        m_registry["GREP"]   = std::make_shared<GrepCommand>(fs);
+        m_registry["SEARCH"] = std::make_shared<SearchCommand>(fs);
+        m_registry["STATS"]  = std::make_shared<StatsCommand>(fs);
+        m_registry["LOGLEVEL"] = std::make_shared<LogLevelCommand>();
+        m_registry["METRICS"] = std::make_shared<MetricsCommand>();
+
+        // Every verb gets its own metrics slot.
+        for (const auto& entry : m_registry) {
+            m_verbIds[entry.first] = Metrics::registerVerb(entry.first);
+        }
     }
 
     /**
@@ -56,11 +79,17 @@ public:
      * Performs a case-insensitive lookup in the registry.
      * 
      * @param name The command keyword received from the client (e.g., "auth", "CREATE").
+     * @param verb Optional; receives the verb's metrics id (Metrics::UNKNOWN_VERB if not found).
      * @return std::shared_ptr<ICommand> A shared pointer to the command object if found; 
      *         otherwise, @c nullptr.
      */
-    std::shared_ptr<ICommand> create(const QString& name) {
-        auto it = m_registry.find(name.toUpper());
+    std::shared_ptr<ICommand> create(const QString& name, int* verb = nullptr) {
+        const QString key = name.toUpper();
+        auto it = m_registry.find(key);
+        if (verb) {
+            auto id = m_verbIds.find(key);
+            *verb = (id != m_verbIds.end()) ? id->second : Metrics::UNKNOWN_VERB;
+        }
         return (it != m_registry.end()) ? it->second : nullptr;
     }
 
@@ -69,6 +98,9 @@ private:
      * @brief Internal registry mapping command keywords to their implementations. 
      */
     std::map<QString, std::shared_ptr<ICommand>> m_registry;
+
+    /** @brief Metrics id of every registered verb. */
+    std::map<QString, int> m_verbIds;
 };
 
 } // namespace Chat
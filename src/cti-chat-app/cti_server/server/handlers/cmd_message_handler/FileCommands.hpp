@@ -8,6 +8,13 @@
  * This file implements the Command Pattern for a multi-threaded TCP server.
  * It includes a thread-safe circular buffer for session management and 
  * mandatory authorization checks for every file operation.
+ *
+ * Locking rules (FileLockManager): CREATE, WRITE and DELETE take the target
+ * exclusively, RENAME and TXN take all their paths exclusively in one call,
+ * COPY takes its source shared and its destination exclusively in one call,
+ * READ takes a shared lock when it has to go to disk, and APPEND takes a
+ * shared lock so appends from many sessions can still be group-committed
+ * together while being excluded from truncation, replacement and removal.
  */
 
 #ifndef FILECOMMANDS_HPP
@@ -19,11 +26,21 @@
 #include <QDir>
 #include <QDateTime>
 #include <QMap>
-#include <QQueue>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSet>
+#include <QVector>
+#include <memory>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 #include "error/error_emitter.hpp"
 #include "constants.hpp"
+#include "storage/FileServices.hpp"
+#include "storage/AtomicWriter.hpp"
+#include "domain/AuthTicket.hpp"
+#include "security/AuthSessionTable.hpp"
+#include "security/CredentialStore.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -32,38 +49,104 @@ namespace Chat {
  * @class SecurityState
  * @brief Manages global authentication state and session lifecycle.
  * 
- * Uses a FIFO (Circular Buffer) logic to limit active sessions.
  * Provides thread-safe methods to authorize requests across multiple handler threads.
+ *
+ * The authenticated identity lives on the session (AuthTicket in ClientInfo)
+ * and is attached to each Message; CmdMessageHandler exposes it to the
+ * commands through a RequestScope, so isAuthorized() is a field read. The
+ * shared AuthSessionTable is only touched on login, logout (disconnect) and
+ * by the periodic idle sweep; it bounds the number of authenticated sessions
+ * (least recently active evicted first) and expires idle ones. Passwords are
+ * checked against the CredentialStore, whose KDF runs on its own workers.
  */
 class SecurityState {
 public:
-    /** @brief Map of active sessions: <SenderID (Socket GUID), Username> */
-    inline static QMap<QString, QString> m_authUsers;
-    
-    /** @brief Queue to maintain the order of logins for circular buffer eviction. */
-    inline static QQueue<QString> m_sessionQueue;
-    
-    /** @brief Mutex to protect shared session maps. */
-    inline static QMutex m_mutex;
-    
-    /** @brief Maximum concurrent sessions allowed before evicting the oldest. */
+    /** @brief Maximum concurrent sessions allowed before evicting the least recently active. */
     static constexpr int MAX_SESSIONS = Constants::MAX_CONNECTED_CLIENTS;
 
-    /** @brief Mock user database for authentication. */
+    /** @brief Authenticated sessions (LRU + idle TTL). */
+    inline static AuthSessionTable m_sessions{MAX_SESSIONS, Constants::IDLE_CLIENT_TIMEOUT_MS};
+
+    /** @brief Ticket of the request running on this thread (see RequestScope). */
+    inline static thread_local const std::shared_ptr<AuthTicket>* m_current = nullptr;
+
+    /** @brief Demo accounts, used by the credential store while its file is missing (--demo-users). */
     inline static const QMap<QString, QString> m_usersDb = {
         {"admin", "password123"},
         {"user1", "securePass"},
         {"guest", "12345"}
     };
 
+    /** @brief Demo accounts holding the administrator role. */
+    inline static const QSet<QString> m_demoAdmins = {"admin"};
+
+    /** @brief Whether the demo accounts are accepted; off unless enabled at startup. */
+    inline static bool m_demoUsers = false;
+
+    /** @brief Credentials file; set at startup (see setCredentialsPath()). */
+    inline static QString m_credentialsPath = Constants::CREDENTIALS_PATH;
+
+    /**
+     * @class RequestScope
+     * @brief Publishes the sender's ticket to the commands run on this thread.
+     */
+    class RequestScope {
+    public:
+        explicit RequestScope(const std::shared_ptr<AuthTicket>& ticket) : m_previous(m_current) {
+            m_current = &ticket;
+        }
+        ~RequestScope() { m_current = m_previous; }
+        RequestScope(const RequestScope&) = delete;
+        RequestScope& operator=(const RequestScope&) = delete;
+
+    private:
+        const std::shared_ptr<AuthTicket>* m_previous;
+    };
+
+    /** @brief Ticket of the current request's session (null outside a request). */
+    static std::shared_ptr<AuthTicket> currentTicket() {
+        return m_current ? *m_current : nullptr;
+    }
+
+    /** @brief The table of authenticated sessions. */
+    static AuthSessionTable& sessions() { return m_sessions; }
+
+    /**
+     * @brief Accepts the demo accounts while the credentials file is missing.
+     * @note Development only; must be called before the first credentials().
+     */
+    static void enableDemoUsers() { m_demoUsers = true; }
+
+    /**
+     * @brief Sets the credentials file (outside the served directory).
+     * @note Must be called before the first credentials().
+     */
+    static void setCredentialsPath(const QString& path) { m_credentialsPath = path; }
+
+    /** @brief The user database AUTH verifies against (built on first use). */
+    static CredentialStore& credentials() {
+        static CredentialStore store(m_credentialsPath, Constants::AUTH_WORKER_THREADS,
+                                     Constants::AUTH_MAX_PENDING, Constants::CREDENTIALS_RELOAD_CHECK_MS,
+                                     m_demoUsers ? m_usersDb : QMap<QString, QString>(), m_demoAdmins);
+        return store;
+    }
+
     /**
      * @brief Verifies if a sender has an active authenticated session.
      * @param senderId The unique ID of the connection.
      * @return true if authorized, false otherwise.
      */
     static bool isAuthorized(const QString& senderId) {
-        QMutexLocker locker(&m_mutex);
-        bool authorized = m_authUsers.contains(senderId);
+        bool authorized = false;
+        if (m_current && *m_current) {
+            // The scope was opened for the Message whose senderId is args[0].
+            authorized = (*m_current)->isAuthorized();
+            if (authorized) {
+                (*m_current)->touch();
+            }
+        } else {
+            authorized = m_sessions.contains(senderId);
+        }
         if (!authorized) {
             EMIT_WARN() << "Unauthorized access attempt blocked from SenderID:" << senderId;
         }
@@ -71,25 +154,50 @@ public:
     }
 
     /**
-     * @brief Registers a new session. Evicts oldest session if buffer is full.
+     * @brief Verifies that the sender is authenticated as an administrator.
+     * @param senderId The unique ID of the connection.
+     * @return true for an administrator session (see CredentialStore), false otherwise.
+     */
+    static bool isAdmin(const QString& senderId) {
+        const bool admin = m_current && *m_current && (*m_current)->isAdmin();
+        if (!admin) {
+            EMIT_WARN() << "Administrative command refused for SenderID:" << senderId;
+        }
+        return admin;
+    }
+
+    /**
+     * @brief Registers a new session. Evicts the least recently active one if full.
      * @param senderId The connection identifier.
      * @param username The authenticated username.
+     * @param ticket The session's ticket, granted here (may be null).
+     * @param admin Whether the user holds the administrator role.
      */
-    static void addSession(const QString& senderId, const QString& username) {
-        QMutexLocker locker(&m_mutex);
-
-        if (!m_authUsers.contains(senderId)) {
-            if (m_sessionQueue.size() >= MAX_SESSIONS) {
-                QString oldest = m_sessionQueue.dequeue();
-                m_authUsers.remove(oldest);
-                EMIT_INFO() << "Circular buffer full. Evicted oldest session:" << oldest;
-            }
-            m_sessionQueue.enqueue(senderId);
-        }
-        m_authUsers[senderId] = username;
+    static void addSession(const QString& senderId, const QString& username,
+                           const std::shared_ptr<AuthTicket>& ticket, bool admin = false) {
+        m_sessions.login(senderId, username, ticket, admin);
     }
 };
 
+/**
+ * @class FileCommand
+ * @brief Common base for commands that operate on the served directory.
+ *
+ * Holds the shared storage services so commands can answer from the
+ * in-memory views and report the mutations they perform.
+ */
+class FileCommand : public ICommand {
+public:
+    explicit FileCommand(std::shared_ptr<FileServices> fs) : m_fs(std::move(fs)) {}
+
+protected:
+    /** @brief True if the last failed open was refused for leaving the served directory. */
+    static bool escapesRoot() { return errno == EXDEV || errno == ELOOP; }
+
+    /** @brief Shared storage services (metadata index, mutation hooks). */
+    std::shared_ptr<FileServices> m_fs;
+};
+
 /**
  * @class AuthCommand
  * @brief Authenticates a client and generates a session.
@@ -109,11 +217,17 @@ public:
         QString username = args[1];
         QString password = args[2];
 
-        auto it = SecurityState::m_usersDb.find(username);
-        if (it != SecurityState::m_usersDb.end() && it.value() == password) {
-            SecurityState::addSession(senderId, username);
+        // The KDF runs on the credential store's workers; this thread only waits.
+        bool admin = false;
+        switch (SecurityState::credentials().verify(username, password, &admin)) {
+        case CredentialStore::Result::Ok:
+            SecurityState::addSession(senderId, username, SecurityState::currentTicket(), admin);
             EMIT_INFO() << "User [" << username << "] successfully authenticated from Sender:" << senderId;
             return Message{"OK AUTHORIZED", "Server"};
+        case CredentialStore::Result::Busy:
+            return Message{"ERROR 503 AUTH_BUSY", "Server"};
+        case CredentialStore::Result::Denied:
+            break;
         }
 
         EMIT_WARN() << "Authentication failed for user [" << username << "] from Sender:" << senderId;
@@ -126,8 +240,12 @@ public:
  * @brief Creates a new empty file.
  * @details args: [0] senderId, [1] filename
  */
-class CreateCommand : public ICommand {
+class CreateCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -137,18 +255,24 @@ public:
             return Message{"ERROR 403 FORBIDDEN", "Server"};
         }
 
-        QFile file(args[1]);
-        if (file.exists()) {
-            EMIT_WARN() << "CREATE conflict: File already exists:" << args[1];
-            return Message{"ERROR 409 CONFLICT", "Server"};
-        }
+        auto guard = m_fs->locks().lockWrite(args[1]);
 
-        if (file.open(QIODevice::WriteOnly)) {
-            file.close();
+        const int fd = m_fs->dir().open(args[1], O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd >= 0) {
+            ::close(fd);
+            m_fs->onFileChanged(args[1]);
             EMIT_INFO() << "File created successfully:" << args[1] << "by" << args[0];
             return Message{"OK", "Server"};
         }
-        
+
+        if (errno == EEXIST) {
+            EMIT_WARN() << "CREATE conflict: File already exists:" << args[1];
+            return Message{"ERROR 409 CONFLICT", "Server"};
+        }
+        if (escapesRoot()) {
+            EMIT_WARN() << "CREATE rejected: Path leaves the served directory:" << args[1] << "Sender:" << args[0];
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+        }
         EMIT_ERROR() << "File creation failed (I/O Error):" << args[1];
         return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
     }
@@ -158,9 +282,16 @@ public:
  * @class WriteCommand
  * @brief Overwrites an existing file.
  * @details args: [0] senderId, [1] filename, [2] content
+ *
+ * The content is written to a temp file next to the target and renamed over
+ * it (AtomicWriter), so readers and crashes never observe a partial file.
  */
-class WriteCommand : public ICommand {
+class WriteCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -170,15 +301,96 @@ public:
             return Message{"ERROR 403 FORBIDDEN", "Server"};
         }
 
-        QFile file(args[1]);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            file.write(args[2].toUtf8());
-            EMIT_INFO() << "WRITE success:" << args[1] << "Size:" << args[2].size();
-            return Message{"OK", "Server"};
+        auto guard = m_fs->locks().lockWrite(args[1]);
+        m_fs->prepareMutation(args[1]);
+
+        AtomicWriter txn(m_fs->dir());
+        if (!txn.stage(args[1], args[2].toUtf8())) {
+            EMIT_ERROR() << "WRITE failed: File not accessible:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
         }
 
-        EMIT_ERROR() << "WRITE failed: File not accessible:" << args[1];
-        return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        const bool published = txn.commit();
+        m_fs->onFileChanged(args[1]);
+        if (!published) {
+            EMIT_ERROR() << "WRITE failed: Cannot publish:" << args[1];
+            return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+        }
+
+        EMIT_INFO() << "WRITE success:" << args[1] << "Size:" << args[2].size();
+        return Message{"OK", "Server"};
+    }
+};
+
+/**
+ * @class TxnCommand
+ * @brief Replaces several files as one batch.
+ * @details args: [0] senderId, [1] filename, [2] content, [3] filename, [4] content, ...
+ *
+ * Every file is staged and flushed first; only when all of them are durable
+ * are they renamed into place, followed by a single directory sync for the
+ * whole batch. If any file cannot be staged, no file is changed.
+ * Responds "OK <count>".
+ */
+class TxnCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList& args) const override {
+        QVector<int> paths;
+        for (int i = 1; i < args.size(); i += 2) {
+            paths.append(i);
+        }
+        return paths;
+    }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        // Step 1: Validate the (path, content) pairs; a path may appear only once.
+        if (args.size() < 3 || (args.size() - 1) % 2 != 0) {
+            EMIT_WARN() << "TXN rejected: Unpaired path/content arguments. Sender:" << args[0];
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+        }
+
+        QVector<FileLockManager::Request> requests;
+        QSet<QString> seen;
+        for (int i = 1; i < args.size(); i += 2) {
+            if (!isValidPath(args[i]) || seen.contains(args[i])) {
+                EMIT_WARN() << "TXN rejected: Invalid or duplicate path" << args[i] << "Sender:" << args[0];
+                return Message{"ERROR 403 FORBIDDEN", "Server"};
+            }
+            seen.insert(args[i]);
+            requests.append({args[i], FileLockManager::Mode::Write});
+        }
+
+        // Step 2: Take every target exclusively in one deadlock-free call.
+        auto guard = m_fs->locks().lock(requests);
+
+        // Step 3: Stage all files; a single failure discards the whole batch.
+        AtomicWriter txn(m_fs->dir());
+        for (int i = 1; i < args.size(); i += 2) {
+            m_fs->prepareMutation(args[i]);
+            if (!txn.stage(args[i], args[i + 1].toUtf8())) {
+                EMIT_ERROR() << "TXN aborted: Cannot stage" << args[i];
+                return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+            }
+        }
+
+        // Step 4: Publish and pay one durability barrier for the batch.
+        const int count = txn.size();
+        const bool published = txn.commit();
+        for (int i = 1; i < args.size(); i += 2) {
+            m_fs->onFileChanged(args[i]);
+        }
+        if (!published) {
+            EMIT_ERROR() << "TXN failed while publishing" << count << "files.";
+            return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+        }
+
+        EMIT_INFO() << "TXN success:" << count << "files replaced by" << args[0];
+        return Message{QString("OK %1").arg(count).toStdString(), "Server"};
     }
 };
 
@@ -186,9 +398,17 @@ public:
  * @class AppendCommand
  * @brief Appends data to an existing file.
  * @details args: [0] senderId, [1] filename, [2] data
+ *
+ * The data goes through the shared AppendWriter, which batches appends from
+ * all sessions. OK is returned once the data reaches the configured
+ * durability point (APPEND_DURABILITY_LEVEL).
  */
-class AppendCommand : public ICommand {
+class AppendCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -196,9 +416,12 @@ public:
         if (args.size() < 3 || !isValidPath(args[1])) 
             return Message{"ERROR 403 FORBIDDEN", "Server"};
 
-        QFile file(args[1]);
-        if (file.open(QIODevice::Append | QIODevice::Text)) {
-            file.write(args[2].toUtf8());
+        auto guard = m_fs->locks().lockRead(args[1]);
+        if (m_fs->appender().append(args[1], args[2].toUtf8())) {
+            // A buffered append is announced by the writer once it is written.
+            if (m_fs->appender().durability() != AppendWriter::Durability::Buffered) {
+                m_fs->onFileChanged(args[1]);
+            }
             EMIT_INFO() << "APPEND success to:" << args[1];
             return Message{"OK", "Server"};
         }
@@ -209,10 +432,21 @@ public:
 /**
  * @class ReadCommand
  * @brief Retrieves the content of a file.
- * @details args: [0] senderId, [1] filename
+ * @details args: [0] senderId, [1] filename, [2] optional crc32c=<hex>
+ *
+ * Small, hot files are served from the shared ContentCache; the cached
+ * buffer is attached to the response body without copying.
+ *
+ * With crc32c= (a value previously returned by CHECKSUM), the read is
+ * conditional: if the file still has that digest the server answers
+ * "OK NOT_MODIFIED" and sends no content.
  */
-class ReadCommand : public ICommand {
+class ReadCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -220,37 +454,172 @@ public:
         if (args.size() < 2 || !isValidPath(args[1])) 
             return Message{"ERROR 403 FORBIDDEN", "Server"};
 
-        QFile file(args[1]);
-        if (file.open(QIODevice::ReadOnly)) {
-            QByteArray content = file.readAll();
+        FileMeta meta;
+        if (!m_fs->index().lookup(args[1], &meta)) {
+            EMIT_WARN() << "READ failed: File not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+
+        if (args.size() > 2) {
+            quint32 known = 0;
+            if (!parseDigest(args[2], &known)) {
+                return Message{"ERROR 400 BAD_REQUEST", "Server"};
+            }
+
+            quint32 crc = 0;
+            auto guard = m_fs->locks().lockRead(args[1]);
+            if (m_fs->digests().digest(args[1], &crc) && crc == known) {
+                EMIT_DEBUG() << "READ not modified:" << args[1];
+                return Message{"OK NOT_MODIFIED", "Server"};
+            }
+        }
+
+        QByteArray content;
+        if (m_fs->cache().get(args[1], meta, &content)) {
+            EMIT_DEBUG() << "READ cache hit:" << args[1];
+            return response(content);
+        }
+
+        // Miss: read from disk under a shared lock, against fresh metadata.
+        auto guard = m_fs->locks().lockRead(args[1]);
+        if (!m_fs->index().lookup(args[1], &meta)) {
+            EMIT_WARN() << "READ failed: File not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+
+        QFile file;
+        if (m_fs->dir().openRead(args[1], &file)) {
+            content = file.readAll();
+            if (content.size() == meta.size) {
+                m_fs->cache().put(args[1], meta, content);
+            }
             EMIT_INFO() << "READ success:" << args[1] << "Bytes sent:" << content.size();
-            std::string res = "OK " + std::to_string(content.size()) + "\n" + content.toStdString();
-            return Message{res, "Server"};
+            return response(content);
         }
 
         EMIT_WARN() << "READ failed: File not found:" << args[1];
         return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
     }
+
+private:
+    /** @brief Parses the "crc32c=<hex>" condition. */
+    static bool parseDigest(const QString& option, quint32* crc) {
+        const QString prefix = QStringLiteral("crc32c=");
+        if (!option.trimmed().startsWith(prefix, Qt::CaseInsensitive)) {
+            return false;
+        }
+        bool ok = false;
+        *crc = option.trimmed().mid(prefix.size()).toUInt(&ok, 16);
+        return ok;
+    }
+
+    /** @brief Builds "OK <size>\n" followed by the shared content buffer. */
+    static Message response(const QByteArray& content) {
+        Message res{"OK " + std::to_string(content.size()) + "\n", "Server"};
+        res.body = content;
+        return res;
+    }
 };
 
 /**
  * @class ListCommand
- * @brief Lists all files in the server directory.
- * @details args: [0] senderId
+ * @brief Lists the files in the server directory (served from the metadata index).
+ * @details args: [0] senderId, [1..] optional key=value options:
+ *          - limit=<n>      page size (default LIST_DEFAULT_PAGE_SIZE)
+ *          - sort=name|size|mtime
+ *          - prefix=<text>  only names starting with text
+ *          - filter=<glob>  wildcard filter, e.g. *.log
+ *          - cursor=<token> value of next= from the previous page
+ *
+ * Without options the whole listing is returned in one response (legacy form).
+ * With options the response is "OK <count> [next=<cursor>]\n<names>", where
+ * next= is present only while more entries remain.
  */
-class ListCommand : public ICommand {
+class ListCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
 
-        QDir dir(".");
-        QStringList files = dir.entryList(QDir::Files | QDir::NoDotAndDotDot);
-        EMIT_INFO() << "LIST command executed. Files found:" << files.size();
+        // Legacy form: full listing.
+        if (args.size() < 2) {
+            QStringList files = m_fs->index().names();
+            EMIT_INFO() << "LIST command executed. Files found:" << files.size();
+
+            QString response = QString("OK %1\n%2").arg(files.size()).arg(files.join("\n"));
+            return Message{response.toStdString(), "Server"};
+        }
+
+        ListQuery query;
+        if (!parseQuery(args, &query)) {
+            EMIT_WARN() << "LIST rejected: Invalid option. Sender:" << args[0];
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+        }
+
+        ListPage page;
+        if (!m_fs->index().list(query, &page)) {
+            EMIT_WARN() << "LIST rejected: Invalid cursor. Sender:" << args[0];
+            return Message{"ERROR 400 INVALID_CURSOR", "Server"};
+        }
+        EMIT_INFO() << "LIST page served. Entries:" << page.names.size();
 
-        QString response = QString("OK %1\n%2").arg(files.size()).arg(files.join("\n"));
+        QString response = QString("OK %1").arg(page.names.size());
+        if (!page.nextCursor.isEmpty()) {
+            response += " next=" + page.nextCursor;
+        }
+        response += "\n" + page.names.join("\n");
         return Message{response.toStdString(), "Server"};
     }
+
+private:
+    /**
+     * @brief Translates key=value arguments into a ListQuery.
+     * @return false on unknown keys or invalid values.
+     */
+    static bool parseQuery(const QStringList& args, ListQuery* query) {
+        query->limit = Constants::LIST_DEFAULT_PAGE_SIZE;
+
+        for (int i = 1; i < args.size(); ++i) {
+            const QString option = args[i].trimmed();
+            const int eq = option.indexOf('=');
+            if (eq <= 0) {
+                return false;
+            }
+
+            const QString key = option.left(eq).toLower();
+            const QString value = option.mid(eq + 1);
+
+            if (key == "limit") {
+                bool ok = false;
+                query->limit = value.toInt(&ok);
+                if (!ok || query->limit <= 0 || query->limit > Constants::LIST_MAX_PAGE_SIZE) {
+                    return false;
+                }
+            } else if (key == "sort") {
+                const QString sort = value.toLower();
+                if (sort == "name") {
+                    query->sort = ListQuery::SortKey::Name;
+                } else if (sort == "size") {
+                    query->sort = ListQuery::SortKey::Size;
+                } else if (sort == "mtime") {
+                    query->sort = ListQuery::SortKey::Mtime;
+                } else {
+                    return false;
+                }
+            } else if (key == "prefix") {
+                query->prefix = value;
+            } else if (key == "filter") {
+                query->glob = value;
+            } else if (key == "cursor") {
+                query->cursor = value;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 
 /**
@@ -258,8 +627,12 @@ public:
  * @brief Permanently removes a file.
  * @details args: [0] senderId, [1] filename
  */
-class DeleteCommand : public ICommand {
+class DeleteCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -267,7 +640,11 @@ public:
         if (args.size() < 2 || !isValidPath(args[1])) 
             return Message{"ERROR 403 FORBIDDEN", "Server"};
 
-        if (QFile::remove(args[1])) {
+        auto guard = m_fs->locks().lockWrite(args[1]);
+        m_fs->prepareMutation(args[1]);
+
+        if (m_fs->dir().remove(args[1])) {
+            m_fs->onFileRemoved(args[1]);
             EMIT_INFO() << "DELETE success: File removed:" << args[1] << "by" << args[0];
             return Message{"OK", "Server"};
         }
@@ -282,8 +659,12 @@ public:
  * @brief Renames a file from source to destination.
  * @details args: [0] senderId, [1] oldName, [2] newName
  */
-class RenameCommand : public ICommand {
+class RenameCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1, 2}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -291,7 +672,13 @@ public:
         if (args.size() < 3 || !isValidPath(args[1]) || !isValidPath(args[2])) 
             return Message{"ERROR 403 FORBIDDEN", "Server"};
 
-        if (QFile::rename(args[1], args[2])) {
+        auto guard = m_fs->locks().lock({{args[1], FileLockManager::Mode::Write},
+                                         {args[2], FileLockManager::Mode::Write}});
+        m_fs->prepareMutation(args[1]);
+        m_fs->prepareMutation(args[2]);
+
+        if (m_fs->dir().rename(args[1], args[2])) {
+            m_fs->onFileRenamed(args[1], args[2]);
             EMIT_INFO() << "RENAME success:" << args[1] << "->" << args[2];
             return Message{"OK", "Server"};
         }
@@ -301,13 +688,72 @@ public:
     }
 };
 
+/**
+ * @class CopyCommand
+ * @brief Duplicates a file on the server without sending it over the network.
+ * @details args: [0] senderId, [1] source, [2] destination
+ *
+ * The copy is made inside the kernel (reflink or copy_file_range) into a temp
+ * file that is renamed into place, so the destination appears complete or
+ * not at all. Like RENAME, an existing destination is never overwritten: the
+ * temp file is published with RENAME_NOREPLACE, so a destination created
+ * while the copy runs still yields 409.
+ */
+class CopyCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1, 2}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 3 || !isValidPath(args[1]) || !isValidPath(args[2])) 
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        auto guard = m_fs->locks().lock({{args[1], FileLockManager::Mode::Read},
+                                         {args[2], FileLockManager::Mode::Write}});
+        m_fs->prepareMutation(args[1]);
+        m_fs->prepareMutation(args[2]);
+
+        if (!m_fs->dir().stat(args[1], nullptr)) {
+            EMIT_WARN() << "COPY failed: Source not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+        if (m_fs->dir().stat(args[2], nullptr)) {
+            EMIT_WARN() << "COPY conflict: Destination already exists:" << args[2];
+            return Message{"ERROR 409 CONFLICT", "Server"};
+        }
+
+        AtomicWriter txn(m_fs->dir());
+        qint64 bytes = 0;
+        if (txn.stageCopy(args[1], args[2], &bytes) && txn.commit(false)) {
+            m_fs->onFileChanged(args[2]);
+            EMIT_INFO() << "COPY success:" << args[1] << "->" << args[2] << "Bytes:" << bytes;
+            return Message{"OK", "Server"};
+        }
+        if (txn.error() == EEXIST) {
+            EMIT_WARN() << "COPY conflict: Destination already exists:" << args[2];
+            return Message{"ERROR 409 CONFLICT", "Server"};
+        }
+
+        EMIT_ERROR() << "COPY failed for path:" << args[1];
+        return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+    }
+};
+
 /**
  * @class InfoCommand
- * @brief Retrieves metadata (size and timestamp).
+ * @brief Retrieves metadata (size and timestamp) from the metadata index.
  * @details args: [0] senderId, [1] filename
  */
-class InfoCommand : public ICommand {
+class InfoCommand : public FileCommand {
 public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
     Message execute(const QStringList& args) override {
         if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
             return Message{"ERROR 401 UNAUTHORIZED", "Server"};
@@ -315,21 +761,125 @@ public:
         if (args.size() < 2 || !isValidPath(args[1])) 
             return Message{"ERROR 403 FORBIDDEN", "Server"};
 
-        QFileInfo info(args[1]);
-        if (!info.exists()) {
+        FileMeta meta;
+        if (!m_fs->index().lookup(args[1], &meta)) {
             EMIT_WARN() << "INFO failed: File not found:" << args[1];
             return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
         }
 
         EMIT_DEBUG() << "INFO retrieved for:" << args[1];
         QString res = QString("OK size=%1 modified=%2")
-                      .arg(info.size())
-                      .arg(info.lastModified().toString(Qt::ISODate));
+                      .arg(meta.size)
+                      .arg(QDateTime::fromMSecsSinceEpoch(meta.mtimeMs).toString(Qt::ISODate));
                       
         return Message{res.toStdString(), "Server"};
     }
 };
 
+/**
+ * @class ChecksumCommand
+ * @brief Returns the CRC32C digest of a file.
+ * @details args: [0] senderId, [1] filename
+ *
+ * Response: "OK crc32c=<8 hex digits> size=<bytes>". Digests are cached per
+ * file version, so checking an unchanged file does not re-read it.
+ */
+class ChecksumCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 2 || !isValidPath(args[1])) 
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        auto guard = m_fs->locks().lockRead(args[1]);
+
+        quint32 crc = 0;
+        FileMeta meta;
+        if (!m_fs->digests().digest(args[1], &crc, &meta)) {
+            EMIT_WARN() << "CHECKSUM failed: File not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+
+        EMIT_DEBUG() << "CHECKSUM computed for:" << args[1];
+        QString res = QString("OK crc32c=%1 size=%2").arg(ContentDigest::toHex(crc)).arg(meta.size);
+        return Message{res.toStdString(), "Server"};
+    }
+};
+
+/**
+ * @class WatchCommand
+ * @brief Subscribes the session to change notifications for a file.
+ * @details args: [0] senderId, [1] filename
+ *
+ * Instead of polling INFO, the client receives "EVENT ..." frames whenever
+ * the file is created, appended to, modified or deleted (see WatchRegistry).
+ * Appends carry the new byte range, so the client can READ just that part.
+ *
+ * Only top-level, non-hidden files can be watched: those are the files the
+ * MetadataIndex watches for external changes. Other paths get
+ * "ERROR 400 UNWATCHABLE_PATH".
+ */
+class WatchCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 2 || !isValidPath(args[1])) 
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        if (!MetadataIndex::isIndexable(args[1])) {
+            EMIT_WARN() << "WATCH rejected: Nested or hidden path:" << args[1];
+            return Message{"ERROR 400 UNWATCHABLE_PATH", "Server"};
+        }
+
+        if (!m_fs->watches().watch(args[0].toStdString(), args[1])) {
+            EMIT_WARN() << "WATCH rejected: Subscription limit reached. Sender:" << args[0];
+            return Message{"ERROR 429 TOO_MANY_WATCHES", "Server"};
+        }
+
+        EMIT_INFO() << "WATCH registered:" << args[1] << "by" << args[0];
+        return Message{"OK", "Server"};
+    }
+};
+
+/**
+ * @class UnwatchCommand
+ * @brief Cancels one subscription, or all of them when no file is given.
+ * @details args: [0] senderId, [1] optional filename
+ */
+class UnwatchCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0])) 
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 2) {
+            m_fs->watches().unwatchAll(args[0].toStdString());
+            return Message{"OK", "Server"};
+        }
+
+        if (!m_fs->watches().unwatch(args[0].toStdString(), args[1])) {
+            return Message{"ERROR 404 NOT_WATCHED", "Server"};
+        }
+        return Message{"OK", "Server"};
+    }
+};
+
 } // namespace Chat
 } // namespace CTI
 
@@ -11,7 +11,9 @@
 
 #include <QStringList>
 #include <QDir>
+#include <QVector>
 #include "domain/Message.hpp"
+#include "constants.hpp"
 
 namespace CTI {
 namespace Chat {
@@ -30,14 +32,46 @@ public:
      */
     virtual Message execute(const QStringList& args) = 0;
 
-protected:
     /**
-     * @brief Security utility to prevent path traversal and root access.
+     * @brief Indices of the arguments that name files (args[0] is the sender).
+     *
+     * The handler replaces each of them with canonicalPath() before execute(),
+     * so locks, caches, indexes and watches all see one name per file.
+     */
+    virtual QVector<int> pathArguments(const QStringList& args) const {
+        Q_UNUSED(args);
+        return {};
+    }
+
+    /**
+     * @brief Canonical form of a client path, or "" if it cannot name a file.
+     *
+     * "." components, ".." and repeated separators are folded, so "x/../a",
+     * "./a" and "a" are the same name. Paths that are absolute, still climb
+     * out ("..", "../...") or name the root itself are refused, and so is any
+     * path through the server's own index directory (FULLTEXT_INDEX_DIR) or
+     * with a component carrying the temp-file marker (ATOMIC_TEMP_MARKER).
+     * Containment is enforced again when the path is resolved beneath the
+     * served directory (RootDirectory), where the kernel also refuses symlinks.
      */
+    static QString canonicalPath(const QString& path) {
+        if (path.isEmpty() || path.contains(QChar(0))) {
+            return QString();
+        }
+        const QString clean = QDir::cleanPath(path);
+        if (QDir::isAbsolutePath(clean) || clean == QLatin1String(".") || clean == QLatin1String("..")
+            || clean.startsWith(QLatin1String("../"))
+            || clean.split(QLatin1Char('/')).contains(Constants::FULLTEXT_INDEX_DIR)
+            || clean.contains(Constants::ATOMIC_TEMP_MARKER)) {
+            return QString();
+        }
+        return clean;
+    }
+
+protected:
+    /** @brief True if @p path is a usable, canonical client path (see canonicalPath()). */
     bool isValidPath(const QString& path) {
-        if (path.isEmpty()) return false;
-        if (path.contains("..") || path.startsWith("/") || path.contains(":/")) return false;
-        return true;
+        return !path.isEmpty() && canonicalPath(path) == path;
     }
 };
 
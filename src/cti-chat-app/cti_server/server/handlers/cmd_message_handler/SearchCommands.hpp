@@ -0,0 +1,168 @@
+/**
+ * @file SearchCommands.hpp
+ * @brief Commands that search file content on the server.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file contains the content-search commands. They let clients find
+ * text in the served directory without downloading whole files with READ:
+ * GREP scans file content directly, SEARCH answers from the full-text index.
+ */
+
+#ifndef SEARCHCOMMANDS_HPP
+#define SEARCHCOMMANDS_HPP
+
+#include <QString>
+#include <QStringList>
+#include "FileCommands.hpp"
+#include "storage/ContentSearch.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class GrepCommand
+ * @brief Returns the lines of one or more files that contain a pattern.
+ * @details args: [0] senderId, [1] pattern, [2] path or glob (e.g. *.log)
+ *
+ * The pattern is a literal string; several alternatives may be given
+ * separated by '|' ("error|fatal"). Files are scanned in parallel, each under
+ * its shared lock.
+ *
+ * Response: "OK <count>[ truncated]\n" followed by one
+ * "<file>:<offset>:<line>" entry per matching line, where offset is the byte
+ * position of the line in the file. "truncated" means GREP_MAX_RESULT_BYTES
+ * was reached and further matches were dropped.
+ */
+class GrepCommand : public FileCommand {
+public:
+    explicit GrepCommand(std::shared_ptr<FileServices> fs)
+        : FileCommand(std::move(fs)),
+          m_search(m_fs->dirHandle(), Constants::GREP_MAX_RESULT_BYTES, Constants::GREP_MAX_LINE_BYTES) {}
+
+    QVector<int> pathArguments(const QStringList&) const override { return {2}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 3 || !isValidPath(args[2]))
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        // Step 1: Split the alternatives.
+        QList<QByteArray> patterns;
+        for (const QString& pattern : args[1].split('|', Qt::SkipEmptyParts)) {
+            patterns.append(pattern.toUtf8());
+        }
+        if (patterns.isEmpty()) {
+            EMIT_WARN() << "GREP rejected: Empty pattern. Sender:" << args[0];
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+        }
+
+        // Step 2: Resolve the target, either one file or a glob over the index.
+        QStringList files;
+        if (!resolveTargets(args[2], &files)) {
+            EMIT_WARN() << "GREP failed: File not found:" << args[2];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+
+        // Step 3: Scan.
+        auto guard = [this](const QString& path, const std::function<void()>& scan) {
+            auto lock = m_fs->locks().lockRead(path);
+            scan();
+        };
+        const ContentSearch::Result result = m_search.search(patterns, files, guard);
+        EMIT_INFO() << "GREP done:" << files.size() << "files," << result.lines.size()
+                    << "matching lines" << (result.truncated ? "(truncated)" : "");
+
+        QString header = QString("OK %1").arg(result.lines.size());
+        if (result.truncated) {
+            header += " truncated";
+        }
+        Message res{(header + "\n").toStdString(), "Server"};
+        for (const QByteArray& line : result.lines) {
+            res.body.append(line).append('\n');
+        }
+        return res;
+    }
+
+private:
+    /**
+     * @brief Expands @p target into the list of files to scan.
+     * @return false if a plain path does not name an existing file.
+     */
+    bool resolveTargets(const QString& target, QStringList* files) {
+        static const QRegularExpression wildcard(QStringLiteral("[*?\\[]"));
+        if (!target.contains(wildcard)) {
+            FileMeta meta;
+            if (!m_fs->index().lookup(target, &meta)) {
+                return false;
+            }
+            files->append(target);
+            return true;
+        }
+
+        ListQuery query;
+        query.glob = target;
+        query.limit = Constants::LIST_MAX_PAGE_SIZE;
+        ListPage page;
+        do {
+            page = ListPage();
+            if (!m_fs->index().list(query, &page)) {
+                break;
+            }
+            files->append(page.names);
+            query.cursor = page.nextCursor;
+        } while (!query.cursor.isEmpty());
+        return true;
+    }
+
+    /** @brief The search engine (stateless apart from its limits). */
+    ContentSearch m_search;
+};
+
+/**
+ * @class SearchCommand
+ * @brief Finds the files containing all given words, using the full-text index.
+ * @details args: [0] senderId, [1..] words (also split on whitespace)
+ *
+ * Matching is case-insensitive on whole tokens (see FullTextIndex). Response:
+ * "OK <count>[ truncated]\n" followed by the file names, sorted; at most
+ * LIST_MAX_PAGE_SIZE names are returned.
+ */
+class SearchCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 2)
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+
+        FullTextIndex* index = m_fs->fulltext();
+        if (!index || !index->isReady()) {
+            EMIT_WARN() << "SEARCH refused: Full-text index" << (index ? "still building." : "disabled.");
+            return Message{"ERROR 503 SERVICE_UNAVAILABLE", "Server"};
+        }
+
+        bool truncated = false;
+        const QString query = args.mid(1).join(' ');
+        const QStringList names = index->search(query, Constants::LIST_MAX_PAGE_SIZE, &truncated);
+        EMIT_INFO() << "SEARCH served. Files found:" << names.size();
+
+        QString res = QString("OK %1").arg(names.size());
+        if (truncated) {
+            res += " truncated";
+        }
+        res += "\n" + names.join("\n");
+        return Message{res.toStdString(), "Server"};
+    }
+};
+
+} // namespace Chat
+} // namespace CTI
+
+#endif // SEARCHCOMMANDS_HPP
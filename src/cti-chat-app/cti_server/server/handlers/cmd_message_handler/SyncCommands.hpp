@@ -0,0 +1,201 @@
+/**
+ * @file SyncCommands.hpp
+ * @brief Commands implementing delta uploads (SIGNATURE / DELTA).
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file contains the rsync-style synchronization commands. A client that
+ * changed a few KB of a large file sends only those bytes instead of the
+ * whole file with WRITE.
+ */
+
+#ifndef SYNCCOMMANDS_HPP
+#define SYNCCOMMANDS_HPP
+
+#include <QString>
+#include <QStringList>
+#include "FileCommands.hpp"
+#include "storage/DeltaSync.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class SignatureCommand
+ * @brief Returns the block signatures of the server's copy of a file.
+ * @details args: [0] senderId, [1] filename, [2] optional block=<bytes>
+ *
+ * Response: "OK block=<B> size=<bytes> count=<n>\n" followed by one
+ * "<weak hex> <crc32c hex>" line per block (see DeltaSync).
+ */
+class SignatureCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 2 || !isValidPath(args[1]))
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        int blockSize = Constants::DELTA_DEFAULT_BLOCK_BYTES;
+        if (args.size() > 2 && !parseBlockSize(args[2], &blockSize))
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+
+        auto guard = m_fs->locks().lockRead(args[1]);
+
+        DeltaSync::Signature sig;
+        if (!m_fs->delta().signature(args[1], blockSize, &sig)) {
+            EMIT_WARN() << "SIGNATURE failed: File not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+
+        QString header = QString("OK block=%1 size=%2 count=%3\n")
+                         .arg(sig.blockSize).arg(sig.size).arg(sig.weak.size());
+        Message res{header.toStdString(), "Server"};
+        res.body.reserve(sig.weak.size() * 18);
+        for (int i = 0; i < sig.weak.size(); ++i) {
+            res.body.append(QByteArray::number(sig.weak[i], 16).rightJustified(8, '0'))
+                    .append(' ')
+                    .append(QByteArray::number(sig.strong[i], 16).rightJustified(8, '0'))
+                    .append('\n');
+        }
+        EMIT_INFO() << "SIGNATURE served:" << args[1] << "Blocks:" << sig.weak.size();
+        return res;
+    }
+
+    /** @brief Parses "block=<bytes>" within the allowed range. */
+    static bool parseBlockSize(const QString& option, int* blockSize) {
+        const QString prefix = QStringLiteral("block=");
+        if (!option.trimmed().startsWith(prefix, Qt::CaseInsensitive)) {
+            return false;
+        }
+        bool ok = false;
+        *blockSize = option.trimmed().mid(prefix.size()).toInt(&ok);
+        return ok && *blockSize >= Constants::DELTA_MIN_BLOCK_BYTES
+                  && *blockSize <= Constants::DELTA_MAX_BLOCK_BYTES;
+    }
+};
+
+/**
+ * @class DeltaCommand
+ * @brief Rewrites a file from block references to its current content plus literals.
+ * @details args: [0] senderId, [1] filename, [2..] options:
+ *          - block=<bytes>    block size of the SIGNATURE the delta is based on
+ *          - base=<crc32c>    digest of the server copy the signature was taken from
+ *          - result=<crc32c>  digest of the client's new content
+ *          - ops=<operations> "C<i>[-<j>]" and "L<base64>" tokens, space-separated
+ *
+ * The new content is rebuilt into a temp file and renamed into place, like
+ * WRITE. If the server copy changed since the signature (base mismatch) the
+ * delta is refused with 409 and the client should request a new signature.
+ *
+ * Response: "OK size=<n> literal=<bytes> copied=<bytes> ops=<n> cpu_us=<t>",
+ * the per-transfer numbers used to tune the block size.
+ */
+class DeltaCommand : public FileCommand {
+public:
+    using FileCommand::FileCommand;
+
+    QVector<int> pathArguments(const QStringList&) const override { return {1}; }
+
+    Message execute(const QStringList& args) override {
+        if (args.isEmpty() || !SecurityState::isAuthorized(args[0]))
+            return Message{"ERROR 401 UNAUTHORIZED", "Server"};
+
+        if (args.size() < 3 || !isValidPath(args[1]))
+            return Message{"ERROR 403 FORBIDDEN", "Server"};
+
+        // Step 1: Parse the options.
+        int blockSize = Constants::DELTA_DEFAULT_BLOCK_BYTES;
+        quint32 baseCrc = 0;
+        quint32 resultCrc = 0;
+        bool haveBase = false;
+        bool haveResult = false;
+        QByteArray ops;
+        for (int i = 2; i < args.size(); ++i) {
+            const QString option = args[i].trimmed();
+            bool ok = true;
+            if (option.startsWith("block=", Qt::CaseInsensitive)) {
+                ok = SignatureCommand::parseBlockSize(option, &blockSize);
+            } else if (option.startsWith("base=", Qt::CaseInsensitive)) {
+                baseCrc = option.mid(5).toUInt(&haveBase, 16);
+                ok = haveBase;
+            } else if (option.startsWith("result=", Qt::CaseInsensitive)) {
+                resultCrc = option.mid(7).toUInt(&haveResult, 16);
+                ok = haveResult;
+            } else if (option.startsWith("ops=", Qt::CaseInsensitive)) {
+                ops = option.mid(4).toLatin1();
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                return Message{"ERROR 400 BAD_REQUEST", "Server"};
+            }
+        }
+        if (!haveBase || !haveResult) {
+            return Message{"ERROR 400 BAD_REQUEST", "Server"};
+        }
+
+        // Step 2: The delta only makes sense against the copy it was computed for.
+        auto guard = m_fs->locks().lockWrite(args[1]);
+        m_fs->prepareMutation(args[1]);
+
+        quint32 currentCrc = 0;
+        if (!m_fs->digests().digest(args[1], &currentCrc)) {
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        }
+        if (currentCrc != baseCrc) {
+            EMIT_WARN() << "DELTA refused: Base changed since signature:" << args[1];
+            return Message{"ERROR 409 CONFLICT", "Server"};
+        }
+
+        // Step 3: Rebuild into a temp file and verify.
+        AtomicWriter txn(m_fs->dir());
+        DeltaSync::Transfer transfer;
+        switch (m_fs->delta().apply(args[1], blockSize, ops, resultCrc, &txn, &transfer)) {
+        case DeltaSync::Status::NotFound:
+            EMIT_WARN() << "DELTA failed: File not found:" << args[1];
+            return Message{"ERROR 404 FILE_NOT_FOUND", "Server"};
+        case DeltaSync::Status::IoError:
+            EMIT_ERROR() << "DELTA failed: Cannot stage:" << args[1];
+            return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+        case DeltaSync::Status::Malformed:
+            EMIT_WARN() << "DELTA rejected: Malformed operations for:" << args[1];
+            return Message{"ERROR 400 BAD_DELTA", "Server"};
+        case DeltaSync::Status::Mismatch:
+            EMIT_WARN() << "DELTA rejected: Result digest mismatch for:" << args[1];
+            return Message{"ERROR 422 DELTA_MISMATCH", "Server"};
+        case DeltaSync::Status::Ok:
+            break;
+        }
+
+        // Step 4: Publish atomically.
+        if (!txn.commit()) {
+            m_fs->onFileChanged(args[1]);
+            EMIT_ERROR() << "DELTA failed: Cannot publish:" << args[1];
+            return Message{"ERROR 500 INTERNAL_ERROR", "Server"};
+        }
+        m_fs->onFileChanged(args[1]);
+
+        EMIT_INFO() << "DELTA applied:" << args[1] << "block=" << blockSize
+                    << "size=" << transfer.resultBytes << "literal=" << transfer.literalBytes
+                    << "copied=" << transfer.copiedBytes << "cpu_us=" << transfer.cpuMicros;
+        QString res = QString("OK size=%1 literal=%2 copied=%3 ops=%4 cpu_us=%5")
+                      .arg(transfer.resultBytes)
+                      .arg(transfer.literalBytes)
+                      .arg(transfer.copiedBytes)
+                      .arg(transfer.operations)
+                      .arg(transfer.cpuMicros);
+        return Message{res.toStdString(), "Server"};
+    }
+};
+
+} // namespace Chat
+} // namespace CTI
+
+#endif // SYNCCOMMANDS_HPP
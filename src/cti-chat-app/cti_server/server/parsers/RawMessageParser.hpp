@@ -48,16 +48,22 @@ public:
     }
 
     /**
-     * @brief Serializes a Message object back into a raw byte array.
+     * @brief Serializes a Message object back into raw bytes.
      * 
-     * Optimization: Uses QByteArray::fromStdString to leverage move-aware 
-     * construction if the compiler supports it.
+     * The body is returned as its own buffer, sharing the Message's data: a
+     * file served from the ContentCache reaches the socket without being
+     * copied into a combined header + body array.
      * 
      * @param msg The Message object to be sent over the wire.
-     * @return QByteArray containing the message payload.
+     * @return The message payload, followed by its body when there is one.
      */
-    QByteArray serialize(const Message& msg) override {
-        return QByteArray::fromStdString(msg.payload);
+    QByteArrayList serialize(const Message& msg) override {
+        QByteArrayList parts;
+        parts.append(QByteArray::fromStdString(msg.payload));
+        if (!msg.body.isEmpty()) {
+            parts.append(msg.body);
+        }
+        return parts;
     }
 };
 
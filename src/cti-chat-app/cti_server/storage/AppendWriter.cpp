@@ -0,0 +1,279 @@
+/**
+ * @file AppendWriter.cpp
+ * @brief Implementation of the group-commit write-behind appender.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QFile>
+#include <QMutexLocker>
+
+// Other
+#include "AppendWriter.hpp"
+#include "error/error_emitter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace CTI {
+namespace Chat {
+
+AppendWriter::AppendWriter(std::shared_ptr<const RootDirectory> root, Durability durability, int windowMs,
+                           int maxOpenFiles, QObject* parent)
+    : QThread(parent),
+      m_root(std::move(root)),
+      m_durability(durability),
+      m_windowMs(windowMs),
+      m_maxOpenFiles(qMax(1, maxOpenFiles)) {
+    EMIT_DEBUG() << "Append writer initiated. Durability level:" << static_cast<int>(durability);
+    start();
+}
+
+AppendWriter::~AppendWriter() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_workAvailable.wakeOne();
+    }
+    wait();
+}
+
+bool AppendWriter::append(const QString& path, const QByteArray& data) {
+    auto req = std::make_shared<Request>();
+    req->path = path;
+    req->data = data;
+    req->notify = (m_durability == Durability::Buffered);
+    m_appends.fetch_add(1, std::memory_order_relaxed);
+    return submit(req, m_durability != Durability::Buffered);
+}
+
+void AppendWriter::release(const QString& path) {
+    auto req = std::make_shared<Request>();
+    req->path = path;
+    req->closeAfter = true;
+    submit(req, true);
+}
+
+void AppendWriter::setWrittenHook(std::function<void(const QString&)> hook) {
+    m_writtenHook = std::move(hook);
+}
+
+AppendWriter::Stats AppendWriter::stats() const {
+    Stats s;
+    s.appends = m_appends.load(std::memory_order_relaxed);
+    s.batches = m_batches.load(std::memory_order_relaxed);
+    s.writes  = m_writes.load(std::memory_order_relaxed);
+    s.syncs   = m_syncs.load(std::memory_order_relaxed);
+    s.bytes   = m_bytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+bool AppendWriter::submit(const RequestPtr& req, bool wait) {
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping) {
+        return false;
+    }
+
+    m_queue.append(req);
+    m_workAvailable.wakeOne();
+
+    if (!wait) {
+        return true;
+    }
+    while (!req->done) {
+        m_batchDone.wait(&m_mutex);
+    }
+    return req->ok;
+}
+
+void AppendWriter::run() {
+    EMIT_DEBUG() << "Append writer thread running.";
+
+    while (true) {
+        QVector<RequestPtr> batch;
+
+        // Step 1: Wait for work.
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stopping) {
+                m_workAvailable.wait(&m_mutex);
+            }
+            if (m_queue.isEmpty() && m_stopping) {
+                break;
+            }
+        }
+
+        // Step 2: Optionally hold the batch open so concurrent appends can join it.
+        if (m_windowMs > 0) {
+            QThread::msleep(static_cast<unsigned long>(m_windowMs));
+        }
+
+        // Step 3: Take everything queued so far as one batch.
+        {
+            QMutexLocker locker(&m_mutex);
+            batch.swap(m_queue);
+        }
+
+        // Step 4: Group by file, keeping arrival order within each file.
+        QList<QString> order;
+        QHash<QString, QVector<RequestPtr>> byPath;
+        for (const RequestPtr& req : batch) {
+            auto& group = byPath[req->path];
+            if (group.isEmpty()) {
+                order.append(req->path);
+            }
+            group.append(req);
+        }
+
+        // Step 5: One write (and one sync) per file.
+        QHash<QString, bool> results;
+        for (const QString& path : order) {
+            results.insert(path, commitFile(path, byPath.value(path)));
+        }
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+
+        // Step 6: Acknowledge every request of the batch at once.
+        {
+            QMutexLocker locker(&m_mutex);
+            for (const RequestPtr& req : batch) {
+                req->ok = results.value(req->path);
+                req->done = true;
+            }
+            m_batchDone.wakeAll();
+        }
+
+        // Step 7: Announce files whose buffered appends are now written.
+        if (m_writtenHook) {
+            for (const QString& path : order) {
+                const QVector<RequestPtr>& group = byPath.value(path);
+                const bool buffered = std::any_of(group.cbegin(), group.cend(),
+                                                  [](const RequestPtr& r) { return r->notify; });
+                if (buffered && results.value(path)) {
+                    m_writtenHook(path);
+                }
+            }
+        }
+    }
+
+    // Shutdown: release every descriptor.
+    const QList<QString> open = m_fds.keys();
+    for (const QString& path : open) {
+        closeDescriptor(path);
+    }
+}
+
+bool AppendWriter::commitFile(const QString& path, const QVector<RequestPtr>& requests) {
+    bool ok = true;
+    bool closeAfter = false;
+
+    // Step 1: Gather the payload of every append into one iovec list.
+    std::vector<struct iovec> iov;
+    qint64 total = 0;
+    for (const RequestPtr& req : requests) {
+        closeAfter = closeAfter || req->closeAfter;
+        if (!req->data.isEmpty()) {
+            iov.push_back({const_cast<char*>(req->data.constData()),
+                           static_cast<size_t>(req->data.size())});
+            total += req->data.size();
+        }
+    }
+
+    if (!iov.empty()) {
+        int fd = descriptorFor(path);
+        if (fd < 0) {
+            EMIT_ERROR() << "APPEND failed: Cannot open" << path << "errno:" << errno;
+            return false;
+        }
+
+        // Step 2: writev() in IOV_MAX slices, resuming after partial writes.
+        size_t index = 0;
+        while (ok && index < iov.size()) {
+            const int count = static_cast<int>(std::min<size_t>(iov.size() - index, IOV_MAX));
+            ssize_t written = ::writev(fd, &iov[index], count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                break;
+            }
+            m_writes.fetch_add(1, std::memory_order_relaxed);
+
+            // Advance past fully written buffers and trim a partially written one.
+            while (written > 0 && index < iov.size()) {
+                if (static_cast<size_t>(written) >= iov[index].iov_len) {
+                    written -= static_cast<ssize_t>(iov[index].iov_len);
+                    ++index;
+                } else {
+                    iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + written;
+                    iov[index].iov_len -= static_cast<size_t>(written);
+                    written = 0;
+                }
+            }
+        }
+
+        // Step 3: Group commit — one fdatasync covers every append of the batch.
+        if (ok && m_durability == Durability::Synced) {
+            ok = (::fdatasync(fd) == 0);
+            m_syncs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (ok) {
+            m_bytes.fetch_add(static_cast<quint64>(total), std::memory_order_relaxed);
+        } else {
+            EMIT_ERROR() << "APPEND failed: I/O error on" << path << "errno:" << errno;
+            closeDescriptor(path);
+        }
+    }
+
+    if (closeAfter) {
+        closeDescriptor(path);
+    }
+    return ok;
+}
+
+int AppendWriter::descriptorFor(const QString& path) {
+    auto it = m_fds.constFind(path);
+    if (it != m_fds.constEnd()) {
+        // Reopen if the file was unlinked or replaced behind our back.
+        struct stat st;
+        if (::fstat(it.value(), &st) == 0 && st.st_nlink > 0) {
+            m_fdOrder.removeOne(path);
+            m_fdOrder.append(path);
+            return it.value();
+        }
+        closeDescriptor(path);
+    }
+
+    // Evict the least recently used descriptor when at capacity.
+    if (m_fds.size() >= m_maxOpenFiles && !m_fdOrder.isEmpty()) {
+        const QString victim = m_fdOrder.first();
+        closeDescriptor(victim);
+    }
+
+    int fd = m_root->open(path, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (fd >= 0) {
+        m_fds.insert(path, fd);
+        m_fdOrder.append(path);
+    }
+    return fd;
+}
+
+void AppendWriter::closeDescriptor(const QString& path) {
+    auto it = m_fds.find(path);
+    if (it == m_fds.end()) {
+        return;
+    }
+    ::close(it.value());
+    m_fds.erase(it);
+    m_fdOrder.removeOne(path);
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
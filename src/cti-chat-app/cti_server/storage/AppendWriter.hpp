@@ -0,0 +1,205 @@
+/**
+ * @file AppendWriter.hpp
+ * @brief Definition of the AppendWriter class, a group-commit write-behind appender.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the background writer used by the APPEND command. It keeps
+ * hot files open and turns many small appends from many sessions into a few
+ * batched writes (and, optionally, a single fdatasync per file per batch).
+ */
+
+#ifndef APPENDWRITER_HPP
+#define APPENDWRITER_HPP
+
+// Qt Depends
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QList>
+
+// Other
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class AppendWriter
+ * @brief Dedicated thread that coalesces appends and commits them in groups.
+ *
+ * Sessions call append(), which queues the data and blocks until the data
+ * is covered by the configured durability point:
+ * - Buffered: accepted into the in-memory queue (no waiting).
+ * - Written:  handed to the kernel with write(2); survives a server crash.
+ * - Synced:   additionally flushed with fdatasync(2); survives a power loss.
+ *
+ * The writer drains the whole queue per cycle, groups the requests by file
+ * (preserving per-file order), issues one writev() per file and, for Synced,
+ * one fdatasync() per file. Requests arriving while a batch is in flight form
+ * the next batch, so the sync cost is shared by everyone waiting on it. An
+ * optional collection window lengthens batches further under load.
+ *
+ * File descriptors stay open between batches, bounded by an LRU of size
+ * maxOpenFiles.
+ *
+ * A Buffered append returns before its data is written, so the caller cannot
+ * announce the change itself; the writer calls the written hook instead, once
+ * per file and batch, after the data has been handed to the kernel.
+ */
+class AppendWriter : public QThread {
+    Q_OBJECT
+public:
+    /** @brief Point at which an append is acknowledged to the client. */
+    enum class Durability { Buffered = 0, Written = 1, Synced = 2 };
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the writer counters.
+     */
+    struct Stats {
+        quint64 appends = 0;
+        quint64 batches = 0;
+        quint64 writes = 0;
+        quint64 syncs = 0;
+        quint64 bytes = 0;
+    };
+
+    /**
+     * @brief Creates and starts the writer thread.
+     * @param root Directory the appended paths are resolved beneath.
+     * @param durability Acknowledgement point for append().
+     * @param windowMs Extra time a batch is held open to collect more appends (0 = none).
+     * @param maxOpenFiles Maximum number of descriptors kept open.
+     * @param parent Optional QObject parent.
+     */
+    AppendWriter(std::shared_ptr<const RootDirectory> root, Durability durability, int windowMs,
+                 int maxOpenFiles, QObject* parent = nullptr);
+
+    /** @brief Flushes all pending appends, closes every descriptor and joins the thread. */
+    ~AppendWriter() override;
+
+    /**
+     * @brief Appends data to a file.
+     *
+     * Blocks the calling (session) thread until the data reaches the
+     * configured durability point.
+     *
+     * @param path Path of the file relative to the root (created if missing).
+     * @param data Bytes to append.
+     * @return true on success, false on an I/O error.
+     */
+    bool append(const QString& path, const QByteArray& data);
+
+    /**
+     * @brief Writes out pending appends for a path and closes its descriptor.
+     *
+     * Must be called before the file is truncated, replaced, renamed or
+     * deleted, so queued data lands in the right file and no descriptor keeps
+     * pointing at an unlinked inode.
+     *
+     * @param path Path of the file relative to the root.
+     */
+    void release(const QString& path);
+
+    /**
+     * @brief Sets the hook called after buffered appends to a file were written.
+     *
+     * Runs on the writer thread. Must be set before the first append().
+     *
+     * @param hook Receives the path relative to the root.
+     */
+    void setWrittenHook(std::function<void(const QString&)> hook);
+
+    /** @brief Returns the acknowledgement point in use. */
+    Durability durability() const { return m_durability; }
+
+    /** @brief Returns a snapshot of the writer counters. */
+    Stats stats() const;
+
+protected:
+    /** @brief Writer loop: drain, group, write, sync, acknowledge. */
+    void run() override;
+
+private:
+    /**
+     * @struct Request
+     * @brief One queued append (or a release barrier when data is empty).
+     */
+    struct Request {
+        QString path;
+        QByteArray data;
+        bool closeAfter = false;
+        bool notify = false;
+        bool done = false;
+        bool ok = false;
+    };
+    using RequestPtr = std::shared_ptr<Request>;
+
+    /** @brief Queues a request and, unless @p wait is false, blocks until it completes. */
+    bool submit(const RequestPtr& req, bool wait);
+
+    /** @brief Writes one file's share of a batch. Runs on the writer thread. */
+    bool commitFile(const QString& path, const QVector<RequestPtr>& requests);
+
+    /** @brief Returns an open append descriptor for @p path (LRU-cached). */
+    int descriptorFor(const QString& path);
+
+    /** @brief Closes and forgets the descriptor for @p path. */
+    void closeDescriptor(const QString& path);
+
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Acknowledgement point. */
+    const Durability m_durability;
+
+    /** @brief Batch collection window in milliseconds. */
+    const int m_windowMs;
+
+    /** @brief Descriptor cache capacity. */
+    const int m_maxOpenFiles;
+
+    /** @brief Change hook for buffered appends (see setWrittenHook()). */
+    std::function<void(const QString&)> m_writtenHook;
+
+    /** @brief Protects m_queue, m_stopping and the done flags of requests. */
+    QMutex m_mutex;
+
+    /** @brief Signals the writer that work is queued. */
+    QWaitCondition m_workAvailable;
+
+    /** @brief Signals waiting sessions that a batch completed. */
+    QWaitCondition m_batchDone;
+
+    /** @brief Pending requests in arrival order. */
+    QVector<RequestPtr> m_queue;
+
+    /** @brief Set by the destructor to end the writer loop. */
+    bool m_stopping = false;
+
+    /** @brief Open descriptors by path (writer thread only). */
+    QHash<QString, int> m_fds;
+
+    /** @brief Descriptor LRU order, front = least recently used (writer thread only). */
+    QList<QString> m_fdOrder;
+
+    std::atomic<quint64> m_appends{0};
+    std::atomic<quint64> m_batches{0};
+    std::atomic<quint64> m_writes{0};
+    std::atomic<quint64> m_syncs{0};
+    std::atomic<quint64> m_bytes{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* APPENDWRITER_HPP */
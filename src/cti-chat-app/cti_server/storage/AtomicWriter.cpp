@@ -0,0 +1,315 @@
+/**
+ * @file AtomicWriter.cpp
+ * @brief Implementation of the temp-file + rename transaction helper.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QSet>
+
+// Other
+#include "AtomicWriter.hpp"
+#include "error/error_emitter.hpp"
+#include "constants.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Bytes moved per copy_file_range()/read() call in stageCopy(). */
+constexpr size_t COPY_CHUNK = 1 << 20;
+
+/** @brief Writes the whole buffer, retrying on partial writes and EINTR. */
+bool writeAll(int fd, const char* p, qint64 left) {
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, static_cast<size_t>(left));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        left -= n;
+    }
+    return true;
+}
+
+/** @brief Attempts at finding an unused temp name before giving up. */
+constexpr int TEMP_ATTEMPTS = 16;
+
+} /* namespace */
+
+bool AtomicWriter::stage(const QString& path, const QByteArray& data) {
+    return beginStage(path) && endStage(append(data.constData(), data.size()));
+}
+
+bool AtomicWriter::beginStage(const QString& path) {
+    endStage(false);
+
+    Staged staged;
+    staged.target = path;
+    staged.dir = openParent(path, &staged.leaf);
+    if (staged.dir < 0) {
+        EMIT_ERROR() << "Cannot stage" << path << "errno:" << errno;
+        return false;
+    }
+
+    // Step 1: Keep the permissions of the file being replaced.
+    struct stat st;
+    const mode_t mode = (::fstatat(staged.dir, staged.leaf.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0
+                         && S_ISREG(st.st_mode)) ? (st.st_mode & 07777) : 0644;
+
+    // Step 2: Create the temp file next to the target (same filesystem).
+    int fd = openTemp(&staged, mode);
+    if (fd < 0) {
+        ::close(staged.dir);
+        return false;
+    }
+
+    m_stream = staged;
+    m_streamFd = fd;
+    return true;
+}
+
+bool AtomicWriter::append(const char* data, qint64 length) {
+    if (m_streamFd < 0) {
+        return false;
+    }
+    if (!writeAll(m_streamFd, data, length)) {
+        EMIT_ERROR() << "Cannot write staged content for" << m_stream.target << "errno:" << errno;
+        return false;
+    }
+    return true;
+}
+
+bool AtomicWriter::endStage(bool ok) {
+    if (m_streamFd < 0) {
+        return false;
+    }
+    const int fd = m_streamFd;
+    m_streamFd = -1;
+
+    // An abandoned stage is not an error; just drop the temp file.
+    if (!ok) {
+        ::close(fd);
+        discard(m_stream);
+        return false;
+    }
+
+    // Step 3: Flush the data before it can become visible.
+    return finishTemp(fd, true, m_stream);
+}
+
+bool AtomicWriter::stageCopy(const QString& src, const QString& dst, qint64* bytes) {
+    // Step 1: Open the source; the copy inherits its permissions.
+    int in = openSource(src);
+    if (in < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(in, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(in);
+        return false;
+    }
+
+    Staged staged;
+    staged.target = dst;
+    staged.dir = openParent(dst, &staged.leaf);
+    int out = (staged.dir < 0) ? -1 : openTemp(&staged, st.st_mode & 07777);
+    if (out < 0) {
+        EMIT_ERROR() << "Cannot stage" << dst << "errno:" << errno;
+        if (staged.dir >= 0) {
+            ::close(staged.dir);
+        }
+        ::close(in);
+        return false;
+    }
+
+    // Step 2: Reflink shares the extents and finishes in O(1) where supported.
+    bool ok = (::ioctl(out, FICLONE, in) == 0);
+    qint64 copied = ok ? static_cast<qint64>(st.st_size) : 0;
+
+    // Step 3: Otherwise let the kernel move the bytes with copy_file_range().
+    if (!ok) {
+        ok = true;
+        bool fallback = false;
+        while (true) {
+            ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, COPY_CHUNK, 0);
+            if (n > 0) { copied += n; continue; }
+            if (n == 0) break;
+            if (errno == EINTR) continue;
+            // Cross-device on old kernels, or unsupported by the filesystem.
+            fallback = (copied == 0 && (errno == EXDEV || errno == ENOSYS
+                                        || errno == EINVAL || errno == EOPNOTSUPP));
+            ok = false;
+            break;
+        }
+
+        // Step 4: Last resort, a user-space read/write loop.
+        if (fallback) {
+            ok = true;
+            QByteArray buffer(static_cast<int>(COPY_CHUNK), Qt::Uninitialized);
+            while (true) {
+                ssize_t n = ::read(in, buffer.data(), static_cast<size_t>(buffer.size()));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) { ok = (n == 0); break; }
+                if (!writeAll(out, buffer.constData(), n)) {
+                    ok = false;
+                    break;
+                }
+                copied += n;
+            }
+        }
+    }
+    ::close(in);
+
+    if (bytes) {
+        *bytes = copied;
+    }
+    return finishTemp(out, ok, staged);
+}
+
+int AtomicWriter::openParent(const QString& path, QByteArray* leaf) const {
+    if (m_root) {
+        return m_root->openParent(path, leaf);
+    }
+    const QFileInfo target(path);
+    *leaf = QFile::encodeName(target.fileName());
+    return ::open(QFile::encodeName(target.path()).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+int AtomicWriter::openSource(const QString& path) const {
+    if (m_root) {
+        return m_root->open(path, O_RDONLY);
+    }
+    return ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+}
+
+int AtomicWriter::openTemp(Staged* staged, mode_t mode) {
+    static const char ALPHABET[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    const QByteArray prefix = '.' + staged->leaf + QFile::encodeName(Constants::ATOMIC_TEMP_MARKER);
+
+    for (int attempt = 0; attempt < TEMP_ATTEMPTS; ++attempt) {
+        QByteArray name = prefix;
+        for (int i = 0; i < 6; ++i) {
+            name += ALPHABET[QRandomGenerator::global()->bounded(static_cast<int>(sizeof(ALPHABET) - 1))];
+        }
+        int fd = ::openat(staged->dir, name.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd >= 0) {
+            ::fchmod(fd, mode);
+            staged->temp = name;
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    EMIT_ERROR() << "Cannot stage" << staged->target << "errno:" << errno;
+    return -1;
+}
+
+bool AtomicWriter::finishTemp(int fd, bool ok, const Staged& staged) {
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+
+    if (!ok) {
+        EMIT_ERROR() << "Cannot write staged content for" << staged.target << "errno:" << errno;
+        discard(staged);
+        return false;
+    }
+
+    m_staged.append(staged);
+    return true;
+}
+
+void AtomicWriter::discard(const Staged& staged) {
+    ::unlinkat(staged.dir, staged.temp.constData(), 0);
+    ::close(staged.dir);
+}
+
+bool AtomicWriter::commit(bool replace) {
+    bool ok = true;
+    QSet<QString> synced;
+    m_error = 0;
+
+    // Step 1: Publish every file; each rename is atomic for readers.
+    QVector<int> dirs;
+    for (const Staged& staged : m_staged) {
+        const int rc = replace
+            ? ::renameat(staged.dir, staged.temp.constData(), staged.dir, staged.leaf.constData())
+            : RootDirectory::renameNoReplace(staged.dir, staged.temp.constData(),
+                                             staged.dir, staged.leaf.constData());
+        if (rc != 0) {
+            if (m_error == 0) {
+                m_error = errno;
+            }
+            if (m_error == EEXIST) {
+                EMIT_WARN() << "Not publishing" << staged.target << ": target already exists";
+            } else {
+                EMIT_ERROR() << "Cannot publish" << staged.target << "errno:" << errno;
+            }
+            discard(staged);
+            ok = false;
+            continue;
+        }
+
+        // Step 2: One durability barrier per directory for the whole batch.
+        const QString dir = QFileInfo(staged.target).path();
+        if (!synced.contains(dir)) {
+            synced.insert(dir);
+            dirs.append(staged.dir);
+        } else {
+            ::close(staged.dir);
+        }
+    }
+    m_staged.clear();
+
+    for (int dir : dirs) {
+        ok = (::fsync(dir) == 0) && ok;
+        ::close(dir);
+    }
+    return ok;
+}
+
+void AtomicWriter::rollback() {
+    endStage(false);
+    for (const Staged& staged : m_staged) {
+        discard(staged);
+    }
+    m_staged.clear();
+}
+
+int AtomicWriter::removeStaleTemps(const QString& dir) {
+    // Temps sit next to their targets, so every subdirectory is searched; client
+    // paths cannot contain the marker (ICommand::canonicalPath), so a match is ours.
+    QDirIterator it(dir, QStringList{"*" + Constants::ATOMIC_TEMP_MARKER + "*"},
+                    QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    int removed = 0;
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (it.fileName().startsWith('.') && QFile::remove(path)) {
+            ++removed;
+        }
+    }
+    if (removed > 0) {
+        EMIT_WARN() << "Removed" << removed << "stale temp files from an interrupted write.";
+    }
+    return removed;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
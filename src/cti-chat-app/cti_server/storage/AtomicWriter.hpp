@@ -0,0 +1,182 @@
+/**
+ * @file AtomicWriter.hpp
+ * @brief Definition of the AtomicWriter class for crash-safe file replacement.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the staging/publishing helper behind WRITE and TXN. New
+ * content is written to a temporary file next to its target and moved into
+ * place with rename(2), so readers and crashes only ever see the old or the
+ * new file, never a partially written one.
+ */
+
+#ifndef ATOMICWRITER_HPP
+#define ATOMICWRITER_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Other
+#include <sys/types.h>
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class AtomicWriter
+ * @brief A short-lived transaction replacing one or more files atomically.
+ *
+ * Usage:
+ * 1. stage() every target: the data is written to a hidden temp file in the
+ *    target's directory and flushed with fdatasync(). Content produced
+ *    piecewise can be streamed instead: beginStage(), append()..., endStage().
+ * 2. commit(): every temp file is renamed over its target, then each distinct
+ *    parent directory is fsync'ed once, making all renames durable together.
+ *
+ * A batch therefore pays one directory sync instead of one per file. If any
+ * stage() fails, nothing is published. Files that were staged but not
+ * committed are removed when the writer is destroyed.
+ *
+ * A writer built on a RootDirectory takes client paths and resolves each
+ * target's directory beneath it once; the temp file, the rename and the
+ * directory sync then all go through that directory descriptor
+ * (openat/renameat), never through the path again.
+ *
+ * @note rename(2) is atomic per file. A failure in the middle of commit()
+ *       (e.g. the disk vanishing) can leave a prefix of the batch published.
+ */
+class AtomicWriter {
+public:
+    /** @brief Writer for plain filesystem paths (files the server owns). */
+    AtomicWriter() = default;
+
+    /** @brief Writer for paths relative to the served directory. */
+    explicit AtomicWriter(const RootDirectory& root) : m_root(&root) {}
+
+    AtomicWriter(const AtomicWriter&) = delete;
+    AtomicWriter& operator=(const AtomicWriter&) = delete;
+
+    /** @brief Removes temp files of an uncommitted transaction. */
+    ~AtomicWriter() { rollback(); }
+
+    /**
+     * @brief Writes the new content of @p path to a durable temp file.
+     * @param path Path of the target file.
+     * @param data Complete new content.
+     * @return false if the temp file could not be created or written.
+     */
+    bool stage(const QString& path, const QByteArray& data);
+
+    /**
+     * @brief Starts staging @p path; its content is then passed to append().
+     * @return false if the temp file could not be created.
+     */
+    bool beginStage(const QString& path);
+
+    /**
+     * @brief Writes the next piece of the content started with beginStage().
+     * @return false on a write error (the stage should be ended with ok = false).
+     */
+    bool append(const char* data, qint64 length);
+
+    /**
+     * @brief Finishes the file started with beginStage().
+     * @param ok false to discard the temp file instead of staging it.
+     * @return true if the file is now staged.
+     */
+    bool endStage(bool ok);
+
+    /**
+     * @brief Stages a copy of @p src as the new content of @p dst.
+     *
+     * The data never leaves the kernel: a reflink (FICLONE) is tried first,
+     * which shares the extents on filesystems that support it (btrfs, XFS),
+     * then copy_file_range(2), then a plain read/write loop as last resort.
+     *
+     * @param src Path of the source file.
+     * @param dst Path of the target file.
+     * @param bytes Optional output for the number of bytes copied.
+     * @return false if the source cannot be opened or the copy failed.
+     */
+    bool stageCopy(const QString& src, const QString& dst, qint64* bytes = nullptr);
+
+    /**
+     * @brief Renames every staged file into place and syncs their directories.
+     * @param replace false to fail (error() == EEXIST) instead of replacing an
+     *        existing target; the check is atomic with the rename.
+     * @return false if a rename or directory sync failed.
+     */
+    bool commit(bool replace = true);
+
+    /** @brief errno of the first failed publish of the last commit(), or 0. */
+    int error() const { return m_error; }
+
+    /** @brief Discards all staged temp files. */
+    void rollback();
+
+    /** @brief Returns the number of staged files. */
+    int size() const { return m_staged.size(); }
+
+    /**
+     * @brief Deletes temp files left behind by a crash during a transaction.
+     * @param dir Directory to clean, subdirectories included.
+     * @return Number of files removed.
+     */
+    static int removeStaleTemps(const QString& dir);
+
+private:
+    /**
+     * @struct Staged
+     * @brief A temp file waiting to replace its target.
+     */
+    struct Staged {
+        QString target;
+        /** @brief Target's directory (owned), used for renameat() and fsync(). */
+        int dir = -1;
+        QByteArray leaf;
+        QByteArray temp;
+    };
+
+    /** @brief Opens the directory of @p path; @p leaf receives its last component. */
+    int openParent(const QString& path, QByteArray* leaf) const;
+
+    /** @brief Opens a source file for reading. */
+    int openSource(const QString& path) const;
+
+    /**
+     * @brief Creates the hidden temp file for @p staged in its directory.
+     * @param mode Permission bits for the temp file.
+     * @return Open descriptor, or -1 on error.
+     */
+    static int openTemp(Staged* staged, mode_t mode);
+
+    /** @brief Flushes and closes a temp descriptor; records it on success, discards it otherwise. */
+    bool finishTemp(int fd, bool ok, const Staged& staged);
+
+    /** @brief Unlinks a staged temp file and closes its directory. */
+    static void discard(const Staged& staged);
+
+    /** @brief Served directory, or nullptr for plain paths. */
+    const RootDirectory* m_root = nullptr;
+
+    /** @brief Files staged by this transaction, in staging order. */
+    QVector<Staged> m_staged;
+
+    /** @brief File between beginStage() and endStage(). */
+    Staged m_stream;
+
+    /** @brief Temp descriptor of m_stream, or -1. */
+    int m_streamFd = -1;
+
+    /** @brief See error(). */
+    int m_error = 0;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* ATOMICWRITER_HPP */
@@ -0,0 +1,129 @@
+/**
+ * @file ContentCache.cpp
+ * @brief Implementation of the sharded LRU file content cache.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QMutexLocker>
+
+// Other
+#include "ContentCache.hpp"
+#include "error/error_emitter.hpp"
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Returns true if two metadata records describe the same file version. */
+bool sameVersion(const FileMeta& a, const FileMeta& b) {
+    return a.size == b.size && a.mtimeMs == b.mtimeMs && a.inode == b.inode;
+}
+
+} /* namespace */
+
+ContentCache::ContentCache(qint64 budgetBytes, qint64 maxEntryBytes)
+    : m_shardBudget(budgetBytes / SHARD_COUNT),
+      m_maxEntryBytes(qMin(maxEntryBytes, budgetBytes / SHARD_COUNT)) {
+    EMIT_DEBUG() << "Content cache initiated. Budget:" << budgetBytes << "bytes.";
+}
+
+bool ContentCache::get(const QString& path, const FileMeta& meta, QByteArray* out) {
+    Shard& shard = shardOf(path);
+    QMutexLocker locker(&shard.mutex);
+
+    auto found = shard.map.constFind(path);
+    if (found == shard.map.constEnd()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto it = found.value();
+    if (!sameVersion(it->meta, meta)) {
+        // The file changed behind our back: the entry can never hit again.
+        eraseLocked(shard, it);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Move to the front of the LRU list (O(1), iterators stay valid).
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    *out = it->data;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ContentCache::put(const QString& path, const FileMeta& meta, const QByteArray& data) {
+    if (!admits(data.size())) {
+        return;
+    }
+
+    Shard& shard = shardOf(path);
+    QMutexLocker locker(&shard.mutex);
+
+    // Step 1: Replace any previous version of the file.
+    auto found = shard.map.find(path);
+    if (found != shard.map.end()) {
+        eraseLocked(shard, found.value());
+    }
+
+    // Step 2: Evict from the cold end until the new entry fits the shard budget.
+    while (!shard.lru.empty() && shard.bytes + data.size() > m_shardBudget) {
+        eraseLocked(shard, std::prev(shard.lru.end()));
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Step 3: Insert as most recently used.
+    shard.lru.push_front(Entry{path, meta, data});
+    shard.map.insert(path, shard.lru.begin());
+    shard.bytes += data.size();
+}
+
+void ContentCache::invalidate(const QString& path) {
+    Shard& shard = shardOf(path);
+    QMutexLocker locker(&shard.mutex);
+
+    auto found = shard.map.find(path);
+    if (found != shard.map.end()) {
+        eraseLocked(shard, found.value());
+    }
+}
+
+void ContentCache::clear() {
+    for (Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.map.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+ContentCache::Stats ContentCache::stats() const {
+    Stats s;
+    s.hits      = m_hits.load(std::memory_order_relaxed);
+    s.misses    = m_misses.load(std::memory_order_relaxed);
+    s.evictions = m_evictions.load(std::memory_order_relaxed);
+
+    for (const Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        s.entries += static_cast<quint64>(shard.map.size());
+        s.bytes   += static_cast<quint64>(shard.bytes);
+    }
+    return s;
+}
+
+ContentCache::Shard& ContentCache::shardOf(const QString& path) {
+    return m_shards[qHash(path) & (SHARD_COUNT - 1)];
+}
+
+void ContentCache::eraseLocked(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->data.size();
+    shard.map.remove(it->path);
+    shard.lru.erase(it);
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,149 @@
+/**
+ * @file ContentCache.hpp
+ * @brief Definition of the ContentCache class, a sharded LRU cache of file contents.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the hot-file cache consulted by the READ command so that
+ * frequently read files are served from memory instead of being reopened and
+ * read on every request.
+ */
+
+#ifndef CONTENTCACHE_HPP
+#define CONTENTCACHE_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+// Other
+#include <array>
+#include <atomic>
+#include <list>
+#include "storage/MetadataIndex.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class ContentCache
+ * @brief Thread-safe, byte-budgeted LRU cache of whole file contents.
+ *
+ * Entries are keyed by path and validated against the file's metadata
+ * (size, mtime, inode): a lookup only hits if the caller's current metadata
+ * matches the metadata recorded when the content was cached, so a replaced
+ * or modified file is never served stale even before it is invalidated.
+ *
+ * Cached buffers are QByteArray instances, which are implicitly shared and
+ * reference counted. The cache never modifies a buffer after insertion, so
+ * handing one to a response shares it without copying the data.
+ *
+ * The key space is split into SHARD_COUNT shards, each with its own mutex,
+ * LRU list and an equal slice of the total byte budget, so concurrent READs
+ * of different files rarely contend on the same lock.
+ */
+class ContentCache {
+public:
+    /** @brief Number of independent shards (power of two). */
+    static constexpr int SHARD_COUNT = 16;
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the cache counters.
+     */
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        quint64 entries = 0;
+        quint64 bytes = 0;
+    };
+
+    /**
+     * @brief Creates a cache.
+     * @param budgetBytes Total bytes of content kept across all shards.
+     * @param maxEntryBytes Files larger than this are never cached.
+     */
+    ContentCache(qint64 budgetBytes, qint64 maxEntryBytes);
+
+    /**
+     * @brief Looks up the content of a file.
+     * @param path Path relative to the served root.
+     * @param meta Current metadata of the file.
+     * @param out Receives a shared reference to the cached content on a hit.
+     * @return true on a hit with matching metadata.
+     */
+    bool get(const QString& path, const FileMeta& meta, QByteArray* out);
+
+    /**
+     * @brief Inserts (or replaces) the content of a file, evicting LRU entries as needed.
+     * @param path Path relative to the served root.
+     * @param meta Metadata the content corresponds to.
+     * @param data The file content; stored as a shared, never-modified buffer.
+     */
+    void put(const QString& path, const FileMeta& meta, const QByteArray& data);
+
+    /**
+     * @brief Drops the entry for a path, if any.
+     * @param path Path relative to the served root.
+     */
+    void invalidate(const QString& path);
+
+    /** @brief Drops every entry. */
+    void clear();
+
+    /** @brief Returns true if content of @p size bytes may be cached. */
+    bool admits(qint64 size) const { return size <= m_maxEntryBytes; }
+
+    /** @brief Returns a snapshot of the hit/miss/eviction counters and occupancy. */
+    Stats stats() const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief One cached file.
+     */
+    struct Entry {
+        QString path;
+        FileMeta meta;
+        QByteArray data;
+    };
+
+    /**
+     * @struct Shard
+     * @brief An independently locked LRU partition (front = most recent).
+     */
+    struct Shard {
+        mutable QMutex mutex;
+        std::list<Entry> lru;
+        QHash<QString, std::list<Entry>::iterator> map;
+        qint64 bytes = 0;
+    };
+
+    /** @brief Returns the shard responsible for @p path. */
+    Shard& shardOf(const QString& path);
+
+    /** @brief Removes an entry from a shard. Caller holds the shard lock. */
+    void eraseLocked(Shard& shard, std::list<Entry>::iterator it);
+
+    /** @brief Byte budget of a single shard. */
+    qint64 m_shardBudget;
+
+    /** @brief Largest content size admitted into the cache. */
+    qint64 m_maxEntryBytes;
+
+    /** @brief The shards. */
+    std::array<Shard, SHARD_COUNT> m_shards;
+
+    std::atomic<quint64> m_hits{0};
+    std::atomic<quint64> m_misses{0};
+    std::atomic<quint64> m_evictions{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* CONTENTCACHE_HPP */
@@ -0,0 +1,264 @@
+/**
+ * @file ContentDigest.cpp
+ * @brief Implementation of the cached, hardware-accelerated CRC32C service.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QFile>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+// Other
+#include "ContentDigest.hpp"
+#include "error/error_emitter.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define CTI_HAVE_CRC32C_HW 1
+#endif
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Bytes read per pread() while hashing (1 MB). */
+constexpr qint64 CHUNK_READ_BYTES = 1024 * 1024;
+
+/** @brief CRC32C polynomial, bit-reflected. */
+constexpr quint32 CRC32C_POLY = 0x82F63B78u;
+
+/** @brief Byte-at-a-time lookup table for the portable implementation. */
+const std::array<quint32, 256>& crcTable() {
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+/** @brief Portable CRC32C. */
+quint32 crc32cTable(quint32 crc, const uchar* p, size_t n) {
+    const auto& table = crcTable();
+    crc = ~crc;
+    while (n--) {
+        crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#if defined(CTI_HAVE_CRC32C_HW)
+/** @brief CRC32C with the SSE4.2 crc32 instruction, 8 bytes per step. */
+__attribute__((target("sse4.2")))
+quint32 crc32cHardware(quint32 crc, const uchar* p, size_t n) {
+    quint64 c = ~crc;
+    while (n > 0 && (reinterpret_cast<quintptr>(p) & 7) != 0) {
+        c = _mm_crc32_u8(static_cast<quint32>(c), *p++);
+        --n;
+    }
+#if defined(__x86_64__)
+    while (n >= 8) {
+        quint64 word;
+        std::memcpy(&word, p, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        n -= 8;
+    }
+#endif
+    while (n > 0) {
+        c = _mm_crc32_u8(static_cast<quint32>(c), *p++);
+        --n;
+    }
+    return ~static_cast<quint32>(c);
+}
+#endif
+
+/** @brief Picks the implementation once, based on the running CPU. */
+using CrcFunction = quint32 (*)(quint32, const uchar*, size_t);
+CrcFunction selectCrc() {
+#if defined(CTI_HAVE_CRC32C_HW)
+    if (__builtin_cpu_supports("sse4.2")) {
+        EMIT_DEBUG() << "CRC32C: using SSE4.2.";
+        return crc32cHardware;
+    }
+#endif
+    EMIT_DEBUG() << "CRC32C: using the portable table implementation.";
+    return crc32cTable;
+}
+
+/** @brief Multiplies two polynomials modulo the CRC polynomial (GF(2)). */
+quint32 multModP(quint32 a, quint32 b) {
+    quint32 m = 1u << 31;
+    quint32 p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : (b >> 1);
+    }
+    return p;
+}
+
+/** @brief Returns x^(n * 2^k) modulo the CRC polynomial. */
+quint32 xPowModP(quint64 n, unsigned k) {
+    static const std::array<quint32, 32> powers = [] {
+        std::array<quint32, 32> t{};
+        quint32 p = 1u << 30; // x^1
+        t[0] = p;
+        for (int i = 1; i < 32; ++i) {
+            t[i] = p = multModP(p, p);
+        }
+        return t;
+    }();
+
+    quint32 p = 1u << 31; // x^0
+    while (n) {
+        if (n & 1) {
+            p = multModP(powers[k & 31], p);
+        }
+        n >>= 1;
+        ++k;
+    }
+    return p;
+}
+
+} /* namespace */
+
+ContentDigest::ContentDigest(std::shared_ptr<const RootDirectory> root, int maxEntries,
+                             qint64 parallelThreshold, qint64 chunkBytes)
+    : m_root(std::move(root)),
+      m_maxEntries(qMax(1, maxEntries)),
+      m_parallelThreshold(parallelThreshold),
+      m_chunkBytes(qMax<qint64>(4096, chunkBytes)) {}
+
+quint32 ContentDigest::crc32c(quint32 crc, const char* data, size_t size) {
+    static const CrcFunction impl = selectCrc();
+    return impl(crc, reinterpret_cast<const uchar*>(data), size);
+}
+
+quint32 ContentDigest::combine(quint32 crcA, quint32 crcB, quint64 lengthB) {
+    // Shift crc(A) over lengthB zero bytes (x^(8 * lengthB)), then add crc(B).
+    return multModP(xPowModP(lengthB, 3), crcA) ^ crcB;
+}
+
+QString ContentDigest::toHex(quint32 crc) {
+    return QString("%1").arg(crc, 8, 16, QLatin1Char('0'));
+}
+
+bool ContentDigest::digest(const QString& path, quint32* crc, FileMeta* meta) {
+    // Step 1: Open once and identify the version of what was opened.
+    QFile file;
+    FileMeta current;
+    if (!m_root->openRead(path, &file) || !MetadataIndex::statDescriptor(file.handle(), &current)) {
+        return false;
+    }
+    if (meta) {
+        *meta = current;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.constFind(current.inode);
+        if (it != m_entries.constEnd() && it->size == current.size && it->mtimeMs == current.mtimeMs) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            *crc = it->crc;
+            return true;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Step 2: Hash exactly the bytes covered by that version.
+    quint32 value = 0;
+    if (!hash(file.handle(), current.size, &value)) {
+        EMIT_WARN() << "Cannot digest" << path << ": file changed while it was read.";
+        return false;
+    }
+    m_bytesHashed.fetch_add(static_cast<quint64>(current.size), std::memory_order_relaxed);
+
+    // Step 3: Remember it (bounded; any entry can go, they are cheap to recompute).
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_entries.size() >= m_maxEntries && !m_entries.contains(current.inode)) {
+            m_entries.erase(m_entries.begin());
+        }
+        m_entries.insert(current.inode, Entry{current.size, current.mtimeMs, value});
+    }
+
+    *crc = value;
+    return true;
+}
+
+ContentDigest::Stats ContentDigest::stats() const {
+    Stats s;
+    s.hits        = m_hits.load(std::memory_order_relaxed);
+    s.misses      = m_misses.load(std::memory_order_relaxed);
+    s.bytesHashed = m_bytesHashed.load(std::memory_order_relaxed);
+    return s;
+}
+
+bool ContentDigest::hash(int fd, qint64 size, quint32* crc) const {
+    /** One chunk of the file and its independent CRC. */
+    struct Chunk {
+        qint64 offset;
+        qint64 length;
+        quint32 crc;
+        bool ok;
+    };
+    auto hashChunk = [fd](Chunk& chunk) {
+        QByteArray buffer(static_cast<int>(qMin<qint64>(chunk.length, CHUNK_READ_BYTES)),
+                          Qt::Uninitialized);
+        chunk.crc = 0;
+        chunk.ok = true;
+        for (qint64 done = 0; done < chunk.length && chunk.ok;) {
+            const qint64 want = qMin<qint64>(buffer.size(), chunk.length - done);
+            chunk.ok = (RootDirectory::readAt(fd, chunk.offset + done, buffer.data(), want) == want);
+            chunk.crc = crc32c(chunk.crc, buffer.constData(), static_cast<size_t>(want));
+            done += want;
+        }
+    };
+
+    if (size < m_parallelThreshold) {
+        Chunk whole{0, size, 0, true};
+        hashChunk(whole);
+        *crc = whole.crc;
+        return whole.ok;
+    }
+
+    // Step 1: Hash fixed-size chunks concurrently.
+    QVector<Chunk> chunks;
+    for (qint64 offset = 0; offset < size; offset += m_chunkBytes) {
+        chunks.append(Chunk{offset, qMin(m_chunkBytes, size - offset), 0, true});
+    }
+    QtConcurrent::blockingMap(chunks, hashChunk);
+
+    // Step 2: Fold them in order into the CRC of the whole file.
+    quint32 value = chunks.first().crc;
+    bool ok = chunks.first().ok;
+    for (int i = 1; i < chunks.size(); ++i) {
+        value = combine(value, chunks[i].crc, static_cast<quint64>(chunks[i].length));
+        ok = ok && chunks[i].ok;
+    }
+    *crc = value;
+    return ok;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,137 @@
+/**
+ * @file ContentDigest.hpp
+ * @brief Definition of the ContentDigest class, cached CRC32C digests of served files.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the hashing service behind CHECKSUM and conditional
+ * READ. Clients compare digests to decide whether a transfer is needed at all.
+ */
+
+#ifndef CONTENTDIGEST_HPP
+#define CONTENTDIGEST_HPP
+
+// Qt Depends
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+// Other
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include "storage/MetadataIndex.hpp"
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class ContentDigest
+ * @brief CRC32C (Castagnoli) of whole files, cached by inode + mtime + size.
+ *
+ * - The checksum uses the SSE4.2 crc32 instruction when the CPU has it
+ *   (checked once at runtime) and a table-driven loop otherwise; both give
+ *   identical results.
+ * - Files above a threshold are split into fixed chunks that are hashed in
+ *   parallel on the global thread pool; the chunk CRCs are then merged with
+ *   combine(), which gives the same value as one sequential pass.
+ * - Results are cached per inode and reused while the file keeps the same
+ *   size and mtime, so repeated CHECKSUMs of unchanged files cost one stat().
+ *   Replacing a file (WRITE/TXN rename) gives it a new inode, appending
+ *   changes its size.
+ */
+class ContentDigest {
+public:
+    /**
+     * @struct Stats
+     * @brief Snapshot of the digest counters.
+     */
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 bytesHashed = 0;
+    };
+
+    /**
+     * @param root Directory the digested paths are resolved beneath.
+     * @param maxEntries Maximum number of cached digests.
+     * @param parallelThreshold Files at least this large are hashed in parallel chunks.
+     * @param chunkBytes Chunk size for parallel hashing.
+     */
+    ContentDigest(std::shared_ptr<const RootDirectory> root, int maxEntries,
+                  qint64 parallelThreshold, qint64 chunkBytes);
+
+    /**
+     * @brief Returns the CRC32C of a file, from the cache when still valid.
+     * @param path Path of the file relative to the root.
+     * @param crc Output digest.
+     * @param meta Optional output for the metadata the digest belongs to.
+     * @return false if the file does not exist or cannot be read (or shrank while
+     *         it was being hashed).
+     */
+    bool digest(const QString& path, quint32* crc, FileMeta* meta = nullptr);
+
+    /** @brief Returns a snapshot of the digest counters. */
+    Stats stats() const;
+
+    /** @brief Formats a digest as 8 lowercase hex digits. */
+    static QString toHex(quint32 crc);
+
+    /**
+     * @brief Continues a CRC32C over more data.
+     * @param crc Value returned for the preceding data (0 to start).
+     */
+    static quint32 crc32c(quint32 crc, const char* data, size_t size);
+
+    /**
+     * @brief Returns the CRC32C of A+B given crc(A), crc(B) and the length of B.
+     */
+    static quint32 combine(quint32 crcA, quint32 crcB, quint64 lengthB);
+
+private:
+    /**
+     * @struct Entry
+     * @brief Cached digest and the file version it was computed for.
+     */
+    struct Entry {
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+        quint32 crc = 0;
+    };
+
+    /**
+     * @brief Hashes the first @p size bytes of an open file, in parallel chunks
+     *        when it is large. Read with pread(), never mapped (see RootDirectory::readAt()).
+     * @return false if the file could not be read in full (e.g. truncated meanwhile).
+     */
+    bool hash(int fd, qint64 size, quint32* crc) const;
+
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Cache capacity. */
+    const int m_maxEntries;
+
+    /** @brief Size from which files are split across threads. */
+    const qint64 m_parallelThreshold;
+
+    /** @brief Chunk size for parallel hashing. */
+    const qint64 m_chunkBytes;
+
+    /** @brief Protects m_entries. */
+    mutable QMutex m_mutex;
+
+    /** @brief Digests by inode. */
+    QHash<quint64, Entry> m_entries;
+
+    std::atomic<quint64> m_hits{0};
+    std::atomic<quint64> m_misses{0};
+    std::atomic<quint64> m_bytesHashed{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* CONTENTDIGEST_HPP */
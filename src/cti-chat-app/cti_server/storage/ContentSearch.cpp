@@ -0,0 +1,214 @@
+/**
+ * @file ContentSearch.cpp
+ * @brief Implementation of the vectorized, parallel content search.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QFile>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+// Other
+#include "ContentSearch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Bytes read from a file at a time by scanFile() (1 MB). */
+constexpr qint64 READ_CHUNK = 1024 * 1024;
+
+} /* namespace */
+
+const char* SubstringMatcher::find(const char* data, size_t size) const {
+    const char* needle = m_needle.constData();
+    const size_t k = static_cast<size_t>(m_needle.size());
+
+    if (k == 0 || size < k) {
+        return nullptr;
+    }
+    if (k == 1) {
+        return static_cast<const char*>(std::memchr(data, needle[0], size));
+    }
+
+#if defined(__SSE2__)
+    // Step 1: Test 16 candidate positions per iteration on first and last byte.
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last  = _mm_set1_epi8(needle[k - 1]);
+
+    size_t i = 0;
+    for (; i + k - 1 + 16 <= size; i += 16) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i blockLast  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + k - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+
+        // Step 2: Verify the inner bytes of each candidate.
+        while (mask != 0) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(data + i + bit + 1, needle + 1, k - 2) == 0) {
+                return data + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    // Step 3: Scalar tail shorter than one block.
+    for (; i + k <= size; ++i) {
+        if (data[i] == needle[0] && std::memcmp(data + i + 1, needle + 1, k - 1) == 0) {
+            return data + i;
+        }
+    }
+    return nullptr;
+#else
+    return static_cast<const char*>(::memmem(data, size, needle, k));
+#endif
+}
+
+ContentSearch::Result ContentSearch::search(const QList<QByteArray>& patterns,
+                                            const QStringList& files,
+                                            const FileGuard& guard) const {
+    QList<SubstringMatcher> matchers;
+    for (const QByteArray& pattern : patterns) {
+        matchers.append(SubstringMatcher(pattern));
+    }
+
+    /** Per-file output, kept apart so the result stays in file order. */
+    struct Task {
+        QString path;
+        QList<QByteArray> lines;
+    };
+    QVector<Task> tasks;
+    tasks.reserve(files.size());
+    for (const QString& path : files) {
+        tasks.append(Task{path, {}});
+    }
+
+    std::atomic<qint64> budget{m_maxResultBytes};
+    std::atomic<bool> exhausted{false};
+
+    // Step 1: Scan all files on the global thread pool.
+    QtConcurrent::blockingMap(tasks, [&](Task& task) {
+        if (exhausted.load(std::memory_order_relaxed)) {
+            return;
+        }
+        auto scan = [&]() {
+            if (!scanFile(task.path, matchers, budget, &task.lines)) {
+                exhausted.store(true, std::memory_order_relaxed);
+            }
+        };
+        if (guard) {
+            guard(task.path, scan);
+        } else {
+            scan();
+        }
+    });
+
+    // Step 2: Concatenate in request order.
+    Result result;
+    result.truncated = exhausted.load();
+    for (const Task& task : tasks) {
+        result.lines.append(task.lines);
+    }
+    return result;
+}
+
+bool ContentSearch::scanFile(const QString& path, const QList<SubstringMatcher>& matchers,
+                             std::atomic<qint64>& budget, QList<QByteArray>* out) const {
+    QFile file;
+    if (!m_root->openRead(path, &file)) {
+        return true;
+    }
+
+    // Step 1: Read blocks (up to the size at open) and hand over the whole lines
+    // they contain; a line longer than a block grows the buffer until it is complete.
+    const qint64 size = file.size();
+    const QByteArray prefix = path.toUtf8() + ':';
+    QByteArray buffer;
+    qint64 bufferOffset = 0;
+    bool atEnd = false;
+    while (!atEnd) {
+        const int filled = buffer.size();
+        const qint64 want = qMin(READ_CHUNK, size - bufferOffset - filled);
+        buffer.resize(filled + static_cast<int>(want));
+        const qint64 got = RootDirectory::readAt(file.handle(), bufferOffset + filled,
+                                                 buffer.data() + filled, want);
+        buffer.resize(filled + static_cast<int>(qMax<qint64>(got, 0)));
+        atEnd = (got < READ_CHUNK);
+
+        const int lines = atEnd ? buffer.size() : buffer.lastIndexOf('\n') + 1;
+        if (lines == 0) {
+            continue;
+        }
+        if (!scanBlock(prefix, buffer.constData(), static_cast<size_t>(lines), bufferOffset,
+                       matchers, budget, out)) {
+            return false;
+        }
+        buffer.remove(0, lines);
+        bufferOffset += lines;
+    }
+    return true;
+}
+
+bool ContentSearch::scanBlock(const QByteArray& prefix, const char* data, size_t size, qint64 offset,
+                              const QList<SubstringMatcher>& matchers, std::atomic<qint64>& budget,
+                              QList<QByteArray>* out) const {
+    // Step 1: Collect the start of every line holding a match (once per pattern per line).
+    std::vector<size_t> starts;
+    for (const SubstringMatcher& matcher : matchers) {
+        size_t pos = 0;
+        while (pos < size) {
+            const char* hit = matcher.find(data + pos, size - pos);
+            if (!hit) {
+                break;
+            }
+            const size_t at = static_cast<size_t>(hit - data);
+            const char* prev = (at > 0) ? static_cast<const char*>(::memrchr(data, '\n', at)) : nullptr;
+            const char* next = static_cast<const char*>(std::memchr(hit, '\n', size - at));
+
+            starts.push_back(prev ? static_cast<size_t>(prev - data) + 1 : 0);
+            pos = next ? static_cast<size_t>(next - data) + 1 : size;
+        }
+    }
+    if (matchers.size() > 1) {
+        std::sort(starts.begin(), starts.end());
+        starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    }
+
+    // Step 2: Format "<file>:<offset>:<line>" while the shared budget lasts.
+    for (size_t start : starts) {
+        const char* next = static_cast<const char*>(std::memchr(data + start, '\n', size - start));
+        size_t length = (next ? static_cast<size_t>(next - data) : size) - start;
+        if (length > 0 && data[start + length - 1] == '\r') {
+            --length;
+        }
+        length = std::min(length, static_cast<size_t>(m_maxLineBytes));
+
+        QByteArray line;
+        line.reserve(prefix.size() + 21 + static_cast<int>(length));
+        line.append(prefix).append(QByteArray::number(offset + static_cast<qint64>(start)))
+            .append(':').append(data + start, static_cast<int>(length));
+
+        const qint64 cost = line.size() + 1;
+        if (budget.fetch_sub(cost, std::memory_order_relaxed) < cost) {
+            return false;
+        }
+        out->append(line);
+    }
+    return true;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,136 @@
+/**
+ * @file ContentSearch.hpp
+ * @brief Definition of the ContentSearch class used by the GREP command.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the server-side content search. Files are memory-mapped
+ * and scanned with a vectorized substring matcher; only the matching lines
+ * travel back to the client.
+ */
+
+#ifndef CONTENTSEARCH_HPP
+#define CONTENTSEARCH_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Other
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class SubstringMatcher
+ * @brief Finds occurrences of one fixed byte string.
+ *
+ * On SSE2 targets every 16-byte block is tested against the first and the
+ * last byte of the needle at once; only positions where both match are
+ * verified with memcmp(). Other targets use memmem().
+ */
+class SubstringMatcher {
+public:
+    /** @param needle Non-empty byte string to search for. */
+    explicit SubstringMatcher(const QByteArray& needle) : m_needle(needle) {}
+
+    /**
+     * @brief Returns the first occurrence in [data, data + size), or nullptr.
+     */
+    const char* find(const char* data, size_t size) const;
+
+private:
+    /** @brief The byte string searched for. */
+    QByteArray m_needle;
+};
+
+/**
+ * @class ContentSearch
+ * @brief Parallel, result-bounded line search over many files.
+ *
+ * A search takes a set of alternative patterns (a line matches if it contains
+ * any of them) and a list of files. Files are processed concurrently on the
+ * global thread pool; each one is read in blocks of whole lines with pread()
+ * (never mapped, so a file truncated meanwhile cannot raise SIGBUS).
+ *
+ * Output is capped by a byte budget shared by all workers. Once it is used
+ * up the remaining work stops and the result is flagged as truncated.
+ */
+class ContentSearch {
+public:
+    /**
+     * @struct Result
+     * @brief Formatted search output.
+     */
+    struct Result {
+        /** @brief One "<file>:<offset>:<line>" entry per matching line, in file order. */
+        QList<QByteArray> lines;
+        /** @brief true if the byte budget cut the output short. */
+        bool truncated = false;
+    };
+
+    /**
+     * @brief Hook run around the scan of each file (e.g. to hold its read lock).
+     *
+     * Receives the path and a callable performing the scan.
+     */
+    using FileGuard = std::function<void(const QString&, const std::function<void()>&)>;
+
+    /**
+     * @param root Directory the scanned paths are resolved beneath.
+     * @param maxResultBytes Upper bound on the total size of the returned lines.
+     * @param maxLineBytes Matching lines longer than this are clipped.
+     */
+    ContentSearch(std::shared_ptr<const RootDirectory> root, qint64 maxResultBytes, int maxLineBytes)
+        : m_root(std::move(root)), m_maxResultBytes(maxResultBytes), m_maxLineBytes(maxLineBytes) {}
+
+    /**
+     * @brief Searches @p files for lines containing any of @p patterns.
+     * @param patterns Alternative, non-empty patterns.
+     * @param files Paths to scan, relative to the root.
+     * @param guard Optional hook wrapping the scan of each file.
+     */
+    Result search(const QList<QByteArray>& patterns, const QStringList& files,
+                  const FileGuard& guard = FileGuard()) const;
+
+private:
+    /**
+     * @brief Scans one file and appends its matching lines.
+     * @param budget Remaining result bytes shared by all workers.
+     * @return false if the budget was exhausted.
+     */
+    bool scanFile(const QString& path, const QList<SubstringMatcher>& matchers,
+                  std::atomic<qint64>& budget, QList<QByteArray>* out) const;
+
+    /**
+     * @brief Scans a block of whole lines and appends its matching lines.
+     * @param prefix "<file>:" of every output line.
+     * @param offset File offset of @p data.
+     * @return false if the budget was exhausted.
+     */
+    bool scanBlock(const QByteArray& prefix, const char* data, size_t size, qint64 offset,
+                   const QList<SubstringMatcher>& matchers, std::atomic<qint64>& budget,
+                   QList<QByteArray>* out) const;
+
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Total output budget per search. */
+    const qint64 m_maxResultBytes;
+
+    /** @brief Clip length for a single line. */
+    const int m_maxLineBytes;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* CONTENTSEARCH_HPP */
@@ -0,0 +1,240 @@
+/**
+ * @file DeltaSync.cpp
+ * @brief Implementation of the rsync-style signature and delta engine.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QFile>
+#include <QList>
+
+// Other
+#include "DeltaSync.hpp"
+#include "AtomicWriter.hpp"
+#include "ContentDigest.hpp"
+#include "error/error_emitter.hpp"
+
+#include <ctime>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Small operations are gathered into writes of about this size. */
+constexpr int WRITE_CHUNK = 1024 * 256;
+
+/** @brief CPU time consumed by the calling thread, in microseconds. */
+qint64 threadCpuMicros() {
+    struct timespec ts;
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<qint64>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+/** @brief Bytes read from the base file at a time (whole blocks in signature()). */
+constexpr qint64 READ_CHUNK = 1024 * 1024;
+
+} /* namespace */
+
+quint32 DeltaSync::weakChecksum(const char* data, int length) {
+    quint32 a = 0;
+    quint32 b = 0;
+    for (int i = 0; i < length; ++i) {
+        const quint32 x = static_cast<uchar>(data[i]);
+        a += x;
+        b += static_cast<quint32>(length - i) * x;
+    }
+    return (a & 0xFFFF) | ((b & 0xFFFF) << 16);
+}
+
+quint32 DeltaSync::roll(quint32 weak, uchar out, uchar in, int blockSize) {
+    const quint32 a = ((weak & 0xFFFF) - out + in) & 0xFFFF;
+    const quint32 b = ((weak >> 16) - static_cast<quint32>(blockSize) * out + a) & 0xFFFF;
+    return a | (b << 16);
+}
+
+bool DeltaSync::signature(const QString& path, int blockSize, Signature* out) {
+    QFile file;
+    if (!m_root->openRead(path, &file)) {
+        return false;
+    }
+
+    // Step 1: One weak and one strong checksum per block, reading whole blocks
+    // with pread() (a mapping would SIGBUS if the file were truncated meanwhile).
+    const qint64 size = file.size();
+    const qint64 blocksPerRead = qMax<qint64>(1, READ_CHUNK / blockSize);
+    QByteArray buffer(static_cast<int>(blocksPerRead * blockSize), Qt::Uninitialized);
+    out->blockSize = blockSize;
+    out->weak.clear();
+    out->strong.clear();
+    qint64 offset = 0;
+    while (offset < size) {
+        const qint64 got = RootDirectory::readAt(file.handle(), offset, buffer.data(),
+                                                 qMin<qint64>(buffer.size(), size - offset));
+        if (got <= 0) {
+            break; // Truncated meanwhile: the signature covers what is left.
+        }
+        for (qint64 at = 0; at < got; at += blockSize) {
+            const int length = static_cast<int>(qMin<qint64>(blockSize, got - at));
+            out->weak.append(weakChecksum(buffer.constData() + at, length));
+            out->strong.append(ContentDigest::crc32c(0, buffer.constData() + at,
+                                                     static_cast<size_t>(length)));
+        }
+        offset += got;
+    }
+    out->size = offset;
+    const int count = out->weak.size();
+
+    m_signatures.fetch_add(1, std::memory_order_relaxed);
+    m_signatureBlocks.fetch_add(static_cast<quint64>(count), std::memory_order_relaxed);
+    return true;
+}
+
+DeltaSync::Status DeltaSync::apply(const QString& path, int blockSize, const QByteArray& ops,
+                                   quint32 expectedCrc, AtomicWriter* out, Transfer* transfer) {
+    const qint64 cpuStart = threadCpuMicros();
+    *transfer = Transfer();
+
+    QFile file;
+    if (!m_root->openRead(path, &file)) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return Status::NotFound;
+    }
+    const qint64 size = file.size();
+    const qint64 blockCount = (size + blockSize - 1) / blockSize;
+
+    if (!out->beginStage(path)) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return Status::IoError;
+    }
+
+    // Output goes to the temp file as it is produced; the CRC follows along.
+    Status status = Status::Ok;
+    quint32 crc = 0;
+    QByteArray pending;
+    auto flush = [&]() {
+        if (!pending.isEmpty() && status == Status::Ok
+            && !out->append(pending.constData(), pending.size())) {
+            status = Status::IoError;
+        }
+        pending.clear();
+    };
+    auto emitBytes = [&](const char* data, qint64 length) {
+        crc = ContentDigest::crc32c(crc, data, static_cast<size_t>(length));
+        transfer->resultBytes += length;
+        if (length >= WRITE_CHUNK) {
+            flush();
+            if (status == Status::Ok && !out->append(data, length)) {
+                status = Status::IoError;
+            }
+            return;
+        }
+        pending.append(data, static_cast<int>(length));
+        if (pending.size() >= WRITE_CHUNK) {
+            flush();
+        }
+    };
+
+    // Copied ranges are read with pread() (see RootDirectory::readAt()); a base
+    // file truncated meanwhile makes the result differ from what the client has.
+    QByteArray buffer;
+    auto copyRange = [&](qint64 offset, qint64 length) {
+        buffer.resize(static_cast<int>(qMin(length, READ_CHUNK)));
+        while (length > 0 && status == Status::Ok) {
+            const qint64 want = qMin<qint64>(length, buffer.size());
+            if (RootDirectory::readAt(file.handle(), offset, buffer.data(), want) != want) {
+                status = Status::Mismatch;
+                return;
+            }
+            emitBytes(buffer.constData(), want);
+            offset += want;
+            length -= want;
+        }
+    };
+
+    // Step 1: Replay the operations against the current content.
+    const QList<QByteArray> tokens = ops.split(' ');
+    for (const QByteArray& token : tokens) {
+        if (status != Status::Ok) {
+            break;
+        }
+        if (token.isEmpty()) {
+            continue;
+        }
+
+        if (token.at(0) == 'C') {
+            const QByteArray range = token.mid(1);
+            const int dash = range.indexOf('-');
+            bool okFirst = false;
+            bool okLast = true;
+            const qint64 first = (dash < 0 ? range : range.left(dash)).toLongLong(&okFirst);
+            const qint64 last = (dash < 0) ? first : range.mid(dash + 1).toLongLong(&okLast);
+            if (!okFirst || !okLast || first < 0 || last < first || last >= blockCount) {
+                status = Status::Malformed;
+                break;
+            }
+            const qint64 offset = first * blockSize;
+            const qint64 length = qMin(size, (last + 1) * blockSize) - offset;
+            if (transfer->resultBytes + length > m_maxResultBytes) {
+                status = Status::Malformed;
+                break;
+            }
+            copyRange(offset, length);
+            transfer->copiedBytes += length;
+        } else if (token.at(0) == 'L') {
+            auto decoded = QByteArray::fromBase64Encoding(token.mid(1),
+                                                          QByteArray::AbortOnBase64DecodingErrors);
+            if (!decoded || transfer->resultBytes + decoded.decoded.size() > m_maxResultBytes) {
+                status = Status::Malformed;
+                break;
+            }
+            emitBytes(decoded.decoded.constData(), decoded.decoded.size());
+            transfer->literalBytes += decoded.decoded.size();
+        } else {
+            status = Status::Malformed;
+            break;
+        }
+        ++transfer->operations;
+    }
+    flush();
+
+    // Step 2: The rebuilt content must be exactly what the client has.
+    if (status == Status::Ok && crc != expectedCrc) {
+        status = Status::Mismatch;
+    }
+    if (!out->endStage(status == Status::Ok) && status == Status::Ok) {
+        status = Status::IoError;
+    }
+
+    transfer->cpuMicros = threadCpuMicros() - cpuStart;
+
+    // Step 3: Account.
+    m_cpuMicros.fetch_add(static_cast<quint64>(transfer->cpuMicros), std::memory_order_relaxed);
+    if (status != Status::Ok) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return status;
+    }
+    m_deltas.fetch_add(1, std::memory_order_relaxed);
+    m_literalBytes.fetch_add(static_cast<quint64>(transfer->literalBytes), std::memory_order_relaxed);
+    m_copiedBytes.fetch_add(static_cast<quint64>(transfer->copiedBytes), std::memory_order_relaxed);
+    return status;
+}
+
+DeltaSync::Stats DeltaSync::stats() const {
+    Stats s;
+    s.signatures      = m_signatures.load(std::memory_order_relaxed);
+    s.signatureBlocks = m_signatureBlocks.load(std::memory_order_relaxed);
+    s.deltas          = m_deltas.load(std::memory_order_relaxed);
+    s.rejected        = m_rejected.load(std::memory_order_relaxed);
+    s.literalBytes    = m_literalBytes.load(std::memory_order_relaxed);
+    s.copiedBytes     = m_copiedBytes.load(std::memory_order_relaxed);
+    s.cpuMicros       = m_cpuMicros.load(std::memory_order_relaxed);
+    return s;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
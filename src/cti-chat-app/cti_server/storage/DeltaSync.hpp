@@ -0,0 +1,160 @@
+/**
+ * @file DeltaSync.hpp
+ * @brief Definition of the DeltaSync class, an rsync-style block delta engine.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the server side of delta uploads: the block signatures a
+ * client uses to find unchanged data, and the reconstruction of a file from
+ * block references plus literal bytes.
+ */
+
+#ifndef DELTASYNC_HPP
+#define DELTASYNC_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Other
+#include <atomic>
+#include <memory>
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+class AtomicWriter;
+
+/**
+ * @class DeltaSync
+ * @brief Block signatures and delta application for SIGNATURE/DELTA.
+ *
+ * Protocol:
+ * 1. SIGNATURE splits the server's copy into blocks of B bytes (the last one
+ *    may be shorter) and returns, per block, a weak rolling checksum and a
+ *    strong CRC32C.
+ * 2. The client slides a B-byte window over its new version, rolling the
+ *    weak checksum one byte at a time (roll()); on a weak hit it confirms with
+ *    CRC32C and emits a block reference, otherwise the byte becomes literal.
+ * 3. DELTA sends the references and literals. The server streams the new
+ *    content from its copy into a temp file, checks the CRC32C of the result
+ *    against the one the client announced, and only then replaces the file.
+ *    The rebuilt content is never held in memory, and a delta expanding past
+ *    the configured maximum file size is rejected while it is replayed.
+ *
+ * Weak checksum (rsync): a = sum(x_i) mod 2^16, b = sum((B - i) * x_i) mod 2^16
+ * for i = 0..B-1, value = a | (b << 16).
+ *
+ * Delta operations are space-separated tokens:
+ * - "C<i>" or "C<i>-<j>": copy server blocks i..j (inclusive),
+ * - "L<base64>": literal bytes.
+ */
+class DeltaSync {
+public:
+    /**
+     * @struct Signature
+     * @brief Per-block checksums of one file.
+     */
+    struct Signature {
+        int blockSize = 0;
+        qint64 size = 0;
+        QVector<quint32> weak;
+        QVector<quint32> strong;
+    };
+
+    /**
+     * @struct Transfer
+     * @brief Accounting of one applied delta.
+     */
+    struct Transfer {
+        qint64 resultBytes = 0;
+        qint64 literalBytes = 0;
+        qint64 copiedBytes = 0;
+        int operations = 0;
+        qint64 cpuMicros = 0;
+    };
+
+    /** @brief Outcome of apply(). */
+    enum class Status { Ok, NotFound, Malformed, Mismatch, IoError };
+
+    /**
+     * @struct Stats
+     * @brief Aggregate counters over all transfers.
+     */
+    struct Stats {
+        quint64 signatures = 0;
+        quint64 signatureBlocks = 0;
+        quint64 deltas = 0;
+        quint64 rejected = 0;
+        quint64 literalBytes = 0;
+        quint64 copiedBytes = 0;
+        quint64 cpuMicros = 0;
+    };
+
+    /**
+     * @param root Directory the signed and patched paths are resolved beneath.
+     * @param maxResultBytes Largest content apply() will rebuild.
+     */
+    DeltaSync(std::shared_ptr<const RootDirectory> root, qint64 maxResultBytes)
+        : m_root(std::move(root)), m_maxResultBytes(maxResultBytes) {}
+
+    /** @brief Weak checksum of one block. */
+    static quint32 weakChecksum(const char* data, int length);
+
+    /**
+     * @brief Slides a weak checksum one byte forward.
+     * @param weak Checksum of the current window.
+     * @param out Byte leaving the window.
+     * @param in Byte entering the window.
+     * @param blockSize Window length.
+     */
+    static quint32 roll(quint32 weak, uchar out, uchar in, int blockSize);
+
+    /**
+     * @brief Computes the block signatures of a file.
+     * @return false if the file cannot be read.
+     */
+    bool signature(const QString& path, int blockSize, Signature* out);
+
+    /**
+     * @brief Rebuilds a file's new content from its current content and a delta.
+     *
+     * The content is staged for @p path in @p out; the caller publishes it
+     * with commit() when the result is Ok. Otherwise nothing is staged.
+     *
+     * @param path Path of the file relative to the root (the base of the delta).
+     * @param blockSize Block size the client's signature request used.
+     * @param ops Delta operations (see class description).
+     * @param expectedCrc CRC32C the client computed for the new content.
+     * @param out Transaction receiving the new content.
+     * @param transfer Output for the accounting of this transfer.
+     */
+    Status apply(const QString& path, int blockSize, const QByteArray& ops,
+                 quint32 expectedCrc, AtomicWriter* out, Transfer* transfer);
+
+    /** @brief Returns the aggregate counters. */
+    Stats stats() const;
+
+private:
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Upper bound on a rebuilt file. */
+    const qint64 m_maxResultBytes;
+
+    std::atomic<quint64> m_signatures{0};
+    std::atomic<quint64> m_signatureBlocks{0};
+    std::atomic<quint64> m_deltas{0};
+    std::atomic<quint64> m_rejected{0};
+    std::atomic<quint64> m_literalBytes{0};
+    std::atomic<quint64> m_copiedBytes{0};
+    std::atomic<quint64> m_cpuMicros{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* DELTASYNC_HPP */
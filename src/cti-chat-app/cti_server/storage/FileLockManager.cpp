@@ -0,0 +1,86 @@
+/**
+ * @file FileLockManager.cpp
+ * @brief Implementation of the striped per-path reader/writer lock table.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QHash>
+
+// Other
+#include "FileLockManager.hpp"
+
+#include <map>
+
+namespace CTI {
+namespace Chat {
+
+FileLockManager::Guard& FileLockManager::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        unlock();
+        m_locks = std::move(other.m_locks);
+        other.m_locks.clear();
+    }
+    return *this;
+}
+
+void FileLockManager::Guard::unlock() {
+    for (auto it = m_locks.crbegin(); it != m_locks.crend(); ++it) {
+        (*it)->unlock();
+    }
+    m_locks.clear();
+}
+
+FileLockManager::Guard FileLockManager::acquire(const Request* first, const Request* last) {
+    // Step 1: Merge requests per stripe (Write dominates) in ascending stripe order.
+    std::map<int, Mode> wanted;
+    for (const Request* it = first; it != last; ++it) {
+        const Request& req = *it;
+        auto result = wanted.emplace(stripeOf(req.path), req.mode);
+        if (!result.second && req.mode == Mode::Write) {
+            result.first->second = Mode::Write;
+        }
+    }
+
+    // Step 2: Acquire in that global order; count the attempts that had to wait.
+    Guard guard;
+    for (const auto& entry : wanted) {
+        Stripe& stripe = m_stripes[entry.first];
+        const bool write = (entry.second == Mode::Write);
+
+        const bool acquired = write ? stripe.lock.tryLockForWrite()
+                                    : stripe.lock.tryLockForRead();
+        if (!acquired) {
+            stripe.contended.fetch_add(1, std::memory_order_relaxed);
+            if (write) {
+                stripe.lock.lockForWrite();
+            } else {
+                stripe.lock.lockForRead();
+            }
+        }
+
+        stripe.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        guard.m_locks.append(&stripe.lock);
+    }
+    return guard;
+}
+
+QVector<FileLockManager::StripeStats> FileLockManager::stats() const {
+    QVector<StripeStats> out(STRIPE_COUNT);
+    for (int i = 0; i < STRIPE_COUNT; ++i) {
+        out[i].acquisitions = m_stripes[i].acquisitions.load(std::memory_order_relaxed);
+        out[i].contended    = m_stripes[i].contended.load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+int FileLockManager::stripeOf(const QString& path) {
+    // "a.txt" and "./a.txt" must share a stripe.
+    return static_cast<int>(qHash(QDir::cleanPath(path)) & (STRIPE_COUNT - 1));
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,143 @@
+/**
+ * @file FileLockManager.hpp
+ * @brief Definition of the FileLockManager class, a striped per-path reader/writer lock table.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the coordination layer between sessions that operate on
+ * the same files. Readers of a file run in parallel, writers are exclusive,
+ * and unrelated files almost never share a lock.
+ */
+
+#ifndef FILELOCKMANAGER_HPP
+#define FILELOCKMANAGER_HPP
+
+// Qt Depends
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+// Other
+#include <array>
+#include <atomic>
+#include <initializer_list>
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class FileLockManager
+ * @brief Fixed table of reader/writer locks indexed by a hash of the file path.
+ *
+ * Instead of one lock object per file (which would need its own registry and
+ * lifetime management), every path maps onto one of STRIPE_COUNT stripes.
+ * Two files sharing a stripe occasionally wait on each other; the table size
+ * keeps that rare while bounding memory.
+ *
+ * Multi-path operations (RENAME, COPY, ...) lock all involved stripes through
+ * a single lock() call, which acquires them in ascending stripe order. All
+ * callers use the same global order, so no two operations can deadlock.
+ *
+ * Every acquisition first tries the lock without blocking; a failed attempt
+ * is counted as contention on that stripe before falling back to a blocking
+ * wait.
+ */
+class FileLockManager {
+public:
+    /** @brief Number of lock stripes (power of two). */
+    static constexpr int STRIPE_COUNT = 64;
+
+    /** @brief Access mode requested for a path. */
+    enum class Mode { Read, Write };
+
+    /**
+     * @struct Request
+     * @brief One path and the access it needs.
+     */
+    struct Request {
+        QString path;
+        Mode mode;
+    };
+
+    /**
+     * @struct StripeStats
+     * @brief Counters of a single stripe.
+     */
+    struct StripeStats {
+        quint64 acquisitions = 0;
+        quint64 contended = 0;
+    };
+
+    /**
+     * @class Guard
+     * @brief RAII handle releasing every stripe acquired by one lock() call.
+     */
+    class Guard {
+    public:
+        Guard() = default;
+        Guard(Guard&& other) noexcept : m_locks(std::move(other.m_locks)) { other.m_locks.clear(); }
+        Guard& operator=(Guard&& other) noexcept;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() { unlock(); }
+
+        /** @brief Releases the stripes early (in reverse acquisition order). */
+        void unlock();
+
+    private:
+        friend class FileLockManager;
+        QVector<QReadWriteLock*> m_locks;
+    };
+
+    /**
+     * @brief Acquires the stripes of all requested paths, deadlock-free.
+     *
+     * Requests falling on the same stripe are merged; Write wins over Read.
+     *
+     * @param requests Paths and modes to lock.
+     * @return A guard that releases everything when destroyed.
+     */
+    Guard lock(std::initializer_list<Request> requests) {
+        return acquire(requests.begin(), requests.end());
+    }
+
+    /** @brief Same as above for a request list built at runtime (e.g. TXN). */
+    Guard lock(const QVector<Request>& requests) {
+        return acquire(requests.constData(), requests.constData() + requests.size());
+    }
+
+    /** @brief Shared access to one path. */
+    Guard lockRead(const QString& path) { return lock({{path, Mode::Read}}); }
+
+    /** @brief Exclusive access to one path. */
+    Guard lockWrite(const QString& path) { return lock({{path, Mode::Write}}); }
+
+    /** @brief Returns the per-stripe counters. */
+    QVector<StripeStats> stats() const;
+
+private:
+    /** @brief Merges and acquires the requests in [first, last). */
+    Guard acquire(const Request* first, const Request* last);
+
+    /**
+     * @struct Stripe
+     * @brief A lock and its counters, padded to its own cache line.
+     */
+    struct alignas(64) Stripe {
+        QReadWriteLock lock;
+        std::atomic<quint64> acquisitions{0};
+        std::atomic<quint64> contended{0};
+    };
+
+    /** @brief Maps a path onto its stripe index. */
+    static int stripeOf(const QString& path);
+
+    /** @brief The stripes. */
+    std::array<Stripe, STRIPE_COUNT> m_stripes;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* FILELOCKMANAGER_HPP */
@@ -0,0 +1,230 @@
+/**
+ * @file FileServices.hpp
+ * @brief Definition of the FileServices aggregate shared by all file commands.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file bundles the storage-layer services (metadata index, content
+ * cache, append writer, lock table, full-text index, watches, digests, ...) into a
+ * single object that is created once in main() and injected into the command
+ * layer, in the same dependency-injection style used for ChatServer.
+ */
+
+#ifndef FILESERVICES_HPP
+#define FILESERVICES_HPP
+
+// Qt Depends
+#include <QString>
+
+// Other
+#include <memory>
+#include "storage/RootDirectory.hpp"
+#include "storage/MetadataIndex.hpp"
+#include "storage/ContentCache.hpp"
+#include "storage/AppendWriter.hpp"
+#include "storage/FileLockManager.hpp"
+#include "storage/AtomicWriter.hpp"
+#include "storage/FullTextIndex.hpp"
+#include "storage/WatchRegistry.hpp"
+#include "storage/ContentDigest.hpp"
+#include "storage/DeltaSync.hpp"
+#include "constants.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class FileServices
+ * @brief Shared storage services and mutation hooks for the file commands.
+ *
+ * Commands never talk to the individual services directly when they change a
+ * file. They report the change through the hook methods below, so every
+ * derived view (index, caches, ...) is updated from one place.
+ *
+ * Every client path is resolved beneath the one RootDirectory created here
+ * (see RootDirectory); nothing opens a client path relative to the CWD.
+ */
+class FileServices {
+public:
+    /**
+     * @brief Creates the storage services for a served directory.
+     * @param root The directory served to clients.
+     */
+    explicit FileServices(const QString& root)
+        : m_dir(std::make_shared<RootDirectory>(root)),
+          m_index(std::make_shared<MetadataIndex>(m_dir)),
+          m_cache(std::make_shared<ContentCache>(Constants::READ_CACHE_BUDGET_BYTES,
+                                                 Constants::READ_CACHE_MAX_ENTRY_BYTES)),
+          m_appender(std::make_shared<AppendWriter>(
+              m_dir,
+              static_cast<AppendWriter::Durability>(Constants::APPEND_DURABILITY_LEVEL),
+              Constants::APPEND_GROUP_COMMIT_WINDOW_MS,
+              Constants::APPEND_MAX_OPEN_FILES)),
+          m_locks(std::make_shared<FileLockManager>()),
+          m_watches(std::make_shared<WatchRegistry>(m_dir, Constants::WATCH_MAX_PER_CLIENT)),
+          m_digests(std::make_shared<ContentDigest>(m_dir, Constants::CHECKSUM_CACHE_MAX_ENTRIES,
+                                                    Constants::CHECKSUM_PARALLEL_THRESHOLD,
+                                                    Constants::CHECKSUM_CHUNK_BYTES)),
+          m_delta(std::make_shared<DeltaSync>(m_dir, Constants::DELTA_MAX_RESULT_BYTES)) {
+        // Temp files of a WRITE/TXN interrupted by a crash are never published.
+        AtomicWriter::removeStaleTemps(m_dir->path());
+
+        // External changes reach the cache through the index's watch events.
+        std::weak_ptr<ContentCache> cache = m_cache;
+        QObject::connect(m_index.get(), &MetadataIndex::entryChanged,
+                         m_index.get(), [cache](const QString& name) {
+            if (auto c = cache.lock()) c->invalidate(name);
+        });
+        QObject::connect(m_index.get(), &MetadataIndex::rebuilt,
+                         m_index.get(), [cache]() {
+            if (auto c = cache.lock()) c->clear();
+        });
+
+        // ... and reach watchers the same way.
+        std::weak_ptr<WatchRegistry> watches = m_watches;
+        QObject::connect(m_index.get(), &MetadataIndex::entryChanged,
+                         m_index.get(), [watches](const QString& name) {
+            if (auto w = watches.lock()) w->notify(name);
+        });
+        QObject::connect(m_index.get(), &MetadataIndex::rebuilt,
+                         m_index.get(), [watches]() {
+            if (auto w = watches.lock()) w->notifyAll();
+        });
+
+        if (Constants::FULLTEXT_INDEX_ENABLED) {
+            m_fulltext = std::make_shared<FullTextIndex>(m_dir, Constants::FULLTEXT_MAX_FILE_BYTES,
+                                                         Constants::FULLTEXT_MAX_OVERLAY_DOCS,
+                                                         Constants::FULLTEXT_UPDATE_DELAY_MS);
+            std::weak_ptr<FullTextIndex> fulltext = m_fulltext;
+            QObject::connect(m_index.get(), &MetadataIndex::entryChanged,
+                             m_index.get(), [fulltext](const QString& name) {
+                if (auto f = fulltext.lock()) f->schedule(name);
+            });
+            QObject::connect(m_index.get(), &MetadataIndex::rebuilt,
+                             m_index.get(), [fulltext]() {
+                if (auto f = fulltext.lock()) f->requestRebuild();
+            });
+        }
+
+        // Buffered appends are announced by the writer once they are written.
+        std::weak_ptr<MetadataIndex> index = m_index;
+        std::weak_ptr<FullTextIndex> fulltext = m_fulltext;
+        m_appender->setWrittenHook([cache, index, fulltext, watches](const QString& name) {
+            if (auto c = cache.lock()) c->invalidate(name);
+            if (auto i = index.lock()) i->refresh(name);
+            if (auto f = fulltext.lock()) f->schedule(name);
+            if (auto w = watches.lock()) w->notify(name);
+        });
+    }
+
+    /** @brief Returns the served directory's absolute path. */
+    const QString& root() const { return m_dir->path(); }
+
+    /** @brief Returns the served directory that client paths are resolved beneath. */
+    const RootDirectory& dir() const { return *m_dir; }
+
+    /** @brief Shared handle on the served directory (for long-lived helpers). */
+    std::shared_ptr<const RootDirectory> dirHandle() const { return m_dir; }
+
+    /** @brief Returns the directory metadata index. */
+    MetadataIndex& index() { return *m_index; }
+
+    /** @brief Returns the hot-file content cache used by READ. */
+    ContentCache& cache() { return *m_cache; }
+
+    /** @brief Returns the group-commit appender used by APPEND. */
+    AppendWriter& appender() { return *m_appender; }
+
+    /** @brief Returns the per-path reader/writer lock table. */
+    FileLockManager& locks() { return *m_locks; }
+
+    /** @brief Returns the WATCH subscription table. */
+    WatchRegistry& watches() { return *m_watches; }
+
+    /** @brief Returns the cached CRC32C service used by CHECKSUM and conditional READ. */
+    ContentDigest& digests() { return *m_digests; }
+
+    /** @brief Returns the signature/delta engine used by SIGNATURE and DELTA. */
+    DeltaSync& delta() { return *m_delta; }
+
+    /** @brief Returns the full-text index, or nullptr when it is disabled. */
+    FullTextIndex* fulltext() { return m_fulltext.get(); }
+
+    /**
+     * @brief Hook: a file is about to be truncated, replaced, renamed or deleted.
+     *
+     * Drains queued appends for the file and closes its append descriptor so
+     * no pending data lands in (or after) the wrong version of the file.
+     *
+     * @param name Path relative to the root.
+     */
+    void prepareMutation(const QString& name) {
+        m_appender->release(name);
+    }
+
+    /**
+     * @brief Hook: a file was created or its content changed.
+     * @param name Path relative to the root.
+     */
+    void onFileChanged(const QString& name) {
+        m_cache->invalidate(name);
+        m_index->refresh(name);
+        if (m_fulltext) m_fulltext->schedule(name);
+        m_watches->notify(name);
+    }
+
+    /**
+     * @brief Hook: a file was removed.
+     * @param name Path relative to the root.
+     */
+    void onFileRemoved(const QString& name) {
+        m_cache->invalidate(name);
+        m_index->remove(name);
+        if (m_fulltext) m_fulltext->schedule(name);
+        m_watches->notify(name);
+    }
+
+    /**
+     * @brief Hook: a file was renamed.
+     * @param from Previous path relative to the root.
+     * @param to New path relative to the root.
+     */
+    void onFileRenamed(const QString& from, const QString& to) {
+        onFileRemoved(from);
+        onFileChanged(to);
+    }
+
+private:
+    /** @brief The served directory (declared first: every service below uses it). */
+    std::shared_ptr<const RootDirectory> m_dir;
+
+    /** @brief In-memory directory/metadata index. */
+    std::shared_ptr<MetadataIndex> m_index;
+
+    /** @brief Hot-file content cache. */
+    std::shared_ptr<ContentCache> m_cache;
+
+    /** @brief Write-behind appender for APPEND. */
+    std::shared_ptr<AppendWriter> m_appender;
+
+    /** @brief Striped per-path reader/writer locks. */
+    std::shared_ptr<FileLockManager> m_locks;
+
+    /** @brief WATCH subscriptions. */
+    std::shared_ptr<WatchRegistry> m_watches;
+
+    /** @brief Cached file digests. */
+    std::shared_ptr<ContentDigest> m_digests;
+
+    /** @brief Delta sync engine and its transfer statistics. */
+    std::shared_ptr<DeltaSync> m_delta;
+
+    /** @brief Inverted index for SEARCH (null when disabled). */
+    std::shared_ptr<FullTextIndex> m_fulltext;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* FILESERVICES_HPP */
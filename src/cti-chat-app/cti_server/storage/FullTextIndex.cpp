@@ -0,0 +1,630 @@
+/**
+ * @file FullTextIndex.cpp
+ * @brief Implementation of the incremental, memory-mapped inverted index.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QtConcurrent/QtConcurrentMap>
+
+// Other
+#include "FullTextIndex.hpp"
+#include "MetadataIndex.hpp"
+#include "AtomicWriter.hpp"
+#include "error/error_emitter.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Identifies a segment file and its format version. */
+const char SEGMENT_MAGIC[8] = {'C', 'T', 'I', 'F', 'T', 'S', '0', '1'};
+
+/** @brief Fixed-size header at offset 0 of the segment. */
+struct SegmentHeader {
+    char magic[8];
+    quint32 docCount;
+    quint32 termCount;
+    quint64 docTableOff;
+    quint64 termTableOff;
+};
+
+/** @brief Document table entry; entries are sorted by name. */
+struct DocEntry {
+    quint64 nameOff;
+    quint32 nameLen;
+    quint32 reserved;
+    qint64 size;
+    qint64 mtimeMs;
+};
+
+/** @brief Term table entry; entries are sorted by term bytes. */
+struct TermEntry {
+    quint64 termOff;
+    quint64 postOff;
+    quint32 termLen;
+    quint32 postLen;
+    quint32 docFreq;
+    quint32 reserved;
+};
+
+static_assert(sizeof(SegmentHeader) == 32, "segment header layout");
+static_assert(sizeof(DocEntry) == 32, "document entry layout");
+static_assert(sizeof(TermEntry) == 32, "term entry layout");
+
+/** @brief Reads a POD value from the (possibly unaligned) mapping. */
+template <typename T>
+T readAt(const uchar* base, quint64 offset) {
+    T value;
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+}
+
+/** @brief Appends @p value as an LEB128 varint. */
+void putVarint(QByteArray* out, quint32 value) {
+    while (value >= 0x80) {
+        out->append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out->append(static_cast<char>(value));
+}
+
+/** @brief Decodes one LEB128 varint; false on truncated input. */
+bool getVarint(const uchar*& p, const uchar* end, quint32* value) {
+    quint32 result = 0;
+    for (int shift = 0; p < end && shift <= 28; shift += 7) {
+        const uchar byte = *p++;
+        result |= static_cast<quint32>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief ASCII letters and digits, plus every byte of a UTF-8 multi-byte sequence. */
+inline bool isTokenByte(uchar c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c >= 0x80;
+}
+
+/** @brief Only top-level, non-hidden files are indexed (same rule as MetadataIndex). */
+inline bool isIndexable(const QString& name) {
+    return !name.isEmpty() && !name.contains('/') && !name.startsWith('.');
+}
+
+} /* namespace */
+
+FullTextIndex::FullTextIndex(std::shared_ptr<const RootDirectory> root, qint64 maxFileBytes,
+                             int maxOverlayDocs, int updateDelayMs, QObject* parent)
+    : QThread(parent),
+      m_root(std::move(root)),
+      m_maxFileBytes(maxFileBytes),
+      m_maxOverlayDocs(qMax(1, maxOverlayDocs)),
+      m_updateDelayMs(qMax(0, updateDelayMs)) {
+    EMIT_DEBUG() << "Full-text index initiated for:" << m_root->path();
+    start(QThread::LowPriority);
+}
+
+FullTextIndex::~FullTextIndex() {
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_stopping = true;
+        m_workAvailable.wakeOne();
+    }
+    wait();
+
+    QWriteLocker locker(&m_lock);
+    unmapSegmentLocked();
+}
+
+QStringList FullTextIndex::search(const QString& query, int limit, bool* truncated) const {
+    const QByteArray text = query.toUtf8();
+    const QVector<QByteArray> tokens = tokenize(text.constData(), text.size());
+    if (truncated) {
+        *truncated = false;
+    }
+    if (tokens.isEmpty()) {
+        return {};
+    }
+
+    // Step 1: Intersect the posting sets of all tokens (base minus tombstones, plus overlay).
+    QSet<QString> result;
+    {
+        QReadLocker locker(&m_lock);
+        bool first = true;
+        for (const QByteArray& token : tokens) {
+            QSet<QString> docs;
+            basePostingsLocked(token, &docs);
+            auto overlay = m_overlayTerms.constFind(token);
+            if (overlay != m_overlayTerms.constEnd()) {
+                docs.unite(overlay.value());
+            }
+
+            if (first) {
+                result = std::move(docs);
+                first = false;
+            } else {
+                result.intersect(docs);
+            }
+            if (result.isEmpty()) {
+                break;
+            }
+        }
+    }
+
+    // Step 2: Stable, bounded output.
+    QStringList names(result.cbegin(), result.cend());
+    std::sort(names.begin(), names.end());
+    if (names.size() > limit) {
+        names.erase(names.begin() + limit, names.end());
+        if (truncated) {
+            *truncated = true;
+        }
+    }
+    return names;
+}
+
+void FullTextIndex::schedule(const QString& name) {
+    if (!isIndexable(name)) {
+        return;
+    }
+    // Later changes of a file already queued fold into its pending re-read.
+    QMutexLocker locker(&m_queueMutex);
+    if (!m_pending.contains(name)) {
+        m_pending.insert(name, QDeadlineTimer(m_updateDelayMs));
+        m_workAvailable.wakeOne();
+    }
+}
+
+void FullTextIndex::requestRebuild() {
+    QMutexLocker locker(&m_queueMutex);
+    m_rebuildRequested = true;
+    m_workAvailable.wakeOne();
+}
+
+FullTextIndex::Stats FullTextIndex::stats() const {
+    Stats s;
+    QReadLocker locker(&m_lock);
+    if (m_segment) {
+        const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+        s.baseDocs  = header.docCount;
+        s.baseTerms = header.termCount;
+    }
+    s.overlayDocs = static_cast<quint64>(m_overlayDocs.size());
+    s.tombstones  = static_cast<quint64>(m_tombstones.size());
+    s.rebuilds    = m_rebuilds.load(std::memory_order_relaxed);
+    return s;
+}
+
+QVector<QByteArray> FullTextIndex::tokenize(const char* data, qint64 size) {
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    QSet<QByteArray> unique;
+
+    qint64 i = 0;
+    while (i < size) {
+        while (i < size && !isTokenByte(p[i])) ++i;
+        const qint64 start = i;
+        while (i < size && isTokenByte(p[i])) ++i;
+
+        const qint64 length = i - start;
+        if (length >= MIN_TOKEN && length <= MAX_TOKEN) {
+            unique.insert(QByteArray(data + start, static_cast<int>(length)).toLower());
+        }
+    }
+
+    QVector<QByteArray> tokens(unique.cbegin(), unique.cend());
+    std::sort(tokens.begin(), tokens.end());
+    return tokens;
+}
+
+void FullTextIndex::run() {
+    // Step 1: Reuse the segment from the previous run, or build one (its stale
+    // temps went with the served directory's, see FileServices).
+    if (!loadAndReconcile()) {
+        rebuild();
+    }
+    m_ready.store(true, std::memory_order_release);
+    EMIT_INFO() << "Full-text index ready.";
+
+    // Step 2: Serve queued updates; compact the overlay when it grows too large.
+    bool lastBuildFailed = false;
+    while (true) {
+        bool compact = false;
+        if (!lastBuildFailed) {
+            QReadLocker locker(&m_lock);
+            compact = (m_overlayDocs.size() + m_tombstones.size()) > m_maxOverlayDocs;
+        }
+
+        QSet<QString> names;
+        bool doRebuild = false;
+        {
+            QMutexLocker locker(&m_queueMutex);
+            if (compact) {
+                m_rebuildRequested = true;
+            }
+            while (!m_stopping && !m_rebuildRequested) {
+                QDeadlineTimer due(QDeadlineTimer::Forever);
+                for (const QDeadlineTimer& deadline : std::as_const(m_pending)) {
+                    due = qMin(due, deadline);
+                }
+                if (due.hasExpired()) {
+                    break;
+                }
+                m_workAvailable.wait(&m_queueMutex, due);
+            }
+            if (m_stopping) {
+                return;
+            }
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if (it.value().hasExpired()) {
+                    names.insert(it.key());
+                    it = m_pending.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            doRebuild = m_rebuildRequested;
+            m_rebuildRequested = false;
+        }
+
+        if (doRebuild) {
+            const quint64 before = m_rebuilds.load(std::memory_order_relaxed);
+            rebuild();
+            lastBuildFailed = (m_rebuilds.load(std::memory_order_relaxed) == before);
+        }
+
+        // Files changed while a rebuild ran are applied on top of the new segment.
+        for (const QString& name : names) {
+            apply(readDocument(name));
+        }
+    }
+}
+
+FullTextIndex::Document FullTextIndex::readDocument(const QString& name) const {
+    Document doc;
+    doc.name = name;
+
+    // One open decides it all: no symlinks, regular files only, and the
+    // metadata of exactly the inode that is read.
+    QFile file;
+    FileMeta meta;
+    if (!m_root->openRead(name, &file) || !MetadataIndex::statDescriptor(file.handle(), &meta)
+        || meta.size > m_maxFileBytes) {
+        return doc;
+    }
+
+    // Read, not mapped: a file truncated by another process meanwhile would
+    // raise SIGBUS in a mapping (the segment, private to the server, is mapped).
+    if (meta.size > 0) {
+        QByteArray content(static_cast<int>(meta.size), Qt::Uninitialized);
+        const qint64 got = RootDirectory::readAt(file.handle(), 0, content.data(), meta.size);
+        doc.tokens = tokenize(content.constData(), qMax<qint64>(got, 0));
+    }
+
+    doc.size = meta.size;
+    doc.mtimeMs = meta.mtimeMs;
+    doc.ok = true;
+    return doc;
+}
+
+void FullTextIndex::apply(const Document& doc) {
+    QWriteLocker locker(&m_lock);
+
+    // Step 1: Nothing to do if the base segment already holds this exact version.
+    const int base = baseDocLocked(doc.name);
+    if (base >= 0 && doc.ok && !m_tombstones.contains(static_cast<quint32>(base))
+        && !m_overlayDocs.contains(doc.name)) {
+        const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+        const DocEntry entry = readAt<DocEntry>(m_segment, header.docTableOff + base * sizeof(DocEntry));
+        if (entry.size == doc.size && entry.mtimeMs == doc.mtimeMs) {
+            return;
+        }
+    }
+
+    // Step 2: Retire the previous version (base document and/or overlay entry).
+    if (base >= 0) {
+        m_tombstones.insert(static_cast<quint32>(base));
+    }
+    auto old = m_overlayDocs.find(doc.name);
+    if (old != m_overlayDocs.end()) {
+        for (const QByteArray& token : old.value()) {
+            auto term = m_overlayTerms.find(token);
+            if (term != m_overlayTerms.end()) {
+                term->remove(doc.name);
+                if (term->isEmpty()) {
+                    m_overlayTerms.erase(term);
+                }
+            }
+        }
+        m_overlayDocs.erase(old);
+    }
+
+    // Step 3: Index the new version, unless the file is gone.
+    if (doc.ok) {
+        for (const QByteArray& token : doc.tokens) {
+            m_overlayTerms[token].insert(doc.name);
+        }
+        m_overlayDocs.insert(doc.name, doc.tokens);
+    }
+}
+
+void FullTextIndex::rebuild() {
+    EMIT_INFO() << "Building full-text index for:" << m_root->path();
+
+    // Step 1: Tokenize every regular file (not symlinks) on the global thread pool.
+    QStringList names = QDir(m_root->path()).entryList(QDir::Files | QDir::NoSymLinks);
+    std::sort(names.begin(), names.end());
+
+    QVector<Document> docs;
+    docs.reserve(names.size());
+    for (const QString& name : names) {
+        Document doc;
+        doc.name = name;
+        docs.append(doc);
+    }
+    QtConcurrent::blockingMap(docs, [this](Document& doc) { doc = readDocument(doc.name); });
+    docs.erase(std::remove_if(docs.begin(), docs.end(),
+                              [](const Document& doc) { return !doc.ok; }), docs.end());
+
+    // Step 2: Invert; document ids follow name order, so postings come out ascending.
+    std::map<QByteArray, std::vector<quint32>> postings;
+    for (int id = 0; id < docs.size(); ++id) {
+        for (const QByteArray& token : docs[id].tokens) {
+            postings[token].push_back(static_cast<quint32>(id));
+        }
+    }
+
+    // Step 3: Serialize: header, names, terms with their delta/varint postings, tables.
+    QByteArray out(sizeof(SegmentHeader), '\0');
+    std::vector<DocEntry> docTable;
+    docTable.reserve(docs.size());
+    for (const Document& doc : docs) {
+        const QByteArray name = doc.name.toUtf8();
+        docTable.push_back(DocEntry{static_cast<quint64>(out.size()),
+                                    static_cast<quint32>(name.size()), 0, doc.size, doc.mtimeMs});
+        out.append(name);
+    }
+
+    std::vector<TermEntry> termTable;
+    termTable.reserve(postings.size());
+    for (const auto& term : postings) {
+        TermEntry entry{};
+        entry.termOff = static_cast<quint64>(out.size());
+        entry.termLen = static_cast<quint32>(term.first.size());
+        out.append(term.first);
+
+        entry.postOff = static_cast<quint64>(out.size());
+        quint32 previous = 0;
+        for (quint32 id : term.second) {
+            putVarint(&out, id - previous);
+            previous = id;
+        }
+        entry.postLen = static_cast<quint32>(out.size() - entry.postOff);
+        entry.docFreq = static_cast<quint32>(term.second.size());
+        termTable.push_back(entry);
+    }
+
+    while (out.size() % 8 != 0) {
+        out.append('\0');
+    }
+    SegmentHeader header{};
+    std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(header.magic));
+    header.docCount = static_cast<quint32>(docTable.size());
+    header.termCount = static_cast<quint32>(termTable.size());
+    header.docTableOff = static_cast<quint64>(out.size());
+    out.append(reinterpret_cast<const char*>(docTable.data()),
+               static_cast<int>(docTable.size() * sizeof(DocEntry)));
+    header.termTableOff = static_cast<quint64>(out.size());
+    out.append(reinterpret_cast<const char*>(termTable.data()),
+               static_cast<int>(termTable.size() * sizeof(TermEntry)));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    // Step 4: Publish the segment atomically, then swap it in and drop the overlay.
+    AtomicWriter writer(*m_root);
+    const bool written = m_root->makeDirectory(QFileInfo(segmentPath()).path())
+                         && writer.stage(segmentPath(), out) && writer.commit();
+
+    QWriteLocker locker(&m_lock);
+    unmapSegmentLocked();
+    m_tombstones.clear();
+    m_overlayDocs.clear();
+    m_overlayTerms.clear();
+
+    if (written && mapSegment()) {
+        m_rebuilds.fetch_add(1, std::memory_order_relaxed);
+        EMIT_INFO() << "Full-text index built:" << header.docCount << "documents,"
+                    << header.termCount << "terms," << out.size() << "bytes.";
+        return;
+    }
+
+    // The segment could not be stored; keep serving everything from memory.
+    EMIT_ERROR() << "Cannot write full-text segment; index kept in memory only.";
+    for (const Document& doc : docs) {
+        for (const QByteArray& token : doc.tokens) {
+            m_overlayTerms[token].insert(doc.name);
+        }
+        m_overlayDocs.insert(doc.name, doc.tokens);
+    }
+}
+
+bool FullTextIndex::loadAndReconcile() {
+    {
+        QWriteLocker locker(&m_lock);
+        if (!mapSegment()) {
+            return false;
+        }
+    }
+
+    // Step 1: Find documents whose file changed or vanished, and files not in the segment.
+    QStringList stale;
+    {
+        QReadLocker locker(&m_lock);
+        const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+        QSet<QString> known;
+        for (quint32 id = 0; id < header.docCount; ++id) {
+            const DocEntry entry = readAt<DocEntry>(m_segment, header.docTableOff + id * sizeof(DocEntry));
+            const QString name = baseNameLocked(id);
+            FileMeta meta;
+            if (!m_root->stat(name, &meta)
+                || meta.size != entry.size || meta.mtimeMs != entry.mtimeMs) {
+                stale.append(name);
+            }
+            known.insert(name);
+        }
+        for (const QString& name : QDir(m_root->path()).entryList(QDir::Files | QDir::NoSymLinks)) {
+            if (!known.contains(name)) {
+                stale.append(name);
+            }
+        }
+    }
+
+    // Step 2: Move them to the overlay; a large backlog triggers compaction in run().
+    for (const QString& name : stale) {
+        apply(readDocument(name));
+    }
+    EMIT_INFO() << "Full-text segment loaded." << stale.size() << "files re-indexed.";
+    return true;
+}
+
+bool FullTextIndex::mapSegment() {
+    auto file = std::make_unique<QFile>();
+    FileMeta meta;
+    if (!m_root->openRead(segmentPath(), file.get()) || !MetadataIndex::statDescriptor(file->handle(), &meta)) {
+        return false;
+    }
+
+    const qint64 size = meta.size;
+    if (size < static_cast<qint64>(sizeof(SegmentHeader))) {
+        return false;
+    }
+    const uchar* map = file->map(0, size);
+    if (!map) {
+        return false;
+    }
+
+    const SegmentHeader header = readAt<SegmentHeader>(map, 0);
+    const quint64 total = static_cast<quint64>(size);
+    const bool valid = std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(header.magic)) == 0
+        && header.docTableOff <= total
+        && header.docCount <= (total - header.docTableOff) / sizeof(DocEntry)
+        && header.termTableOff <= total
+        && header.termCount <= (total - header.termTableOff) / sizeof(TermEntry);
+    if (!valid) {
+        EMIT_WARN() << "Ignoring invalid full-text segment:" << segmentPath();
+        file->unmap(const_cast<uchar*>(map));
+        return false;
+    }
+
+    m_segmentFile = std::move(file);
+    m_segment = map;
+    m_segmentSize = size;
+    return true;
+}
+
+void FullTextIndex::unmapSegmentLocked() {
+    if (m_segmentFile) {
+        m_segmentFile->unmap(const_cast<uchar*>(m_segment));
+        m_segmentFile.reset();
+    }
+    m_segment = nullptr;
+    m_segmentSize = 0;
+}
+
+int FullTextIndex::baseDocLocked(const QString& name) const {
+    if (!m_segment) {
+        return -1;
+    }
+    const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+
+    int lo = 0;
+    int hi = static_cast<int>(header.docCount) - 1;
+    while (lo <= hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const QString candidate = baseNameLocked(static_cast<quint32>(mid));
+        if (candidate < name) {
+            lo = mid + 1;
+        } else if (name < candidate) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+QString FullTextIndex::baseNameLocked(quint32 id) const {
+    const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+    const DocEntry entry = readAt<DocEntry>(m_segment, header.docTableOff + id * sizeof(DocEntry));
+    if (entry.nameOff + entry.nameLen > static_cast<quint64>(m_segmentSize)) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_segment + entry.nameOff),
+                             static_cast<int>(entry.nameLen));
+}
+
+void FullTextIndex::basePostingsLocked(const QByteArray& term, QSet<QString>* out) const {
+    if (!m_segment) {
+        return;
+    }
+    const SegmentHeader header = readAt<SegmentHeader>(m_segment, 0);
+    const quint64 limit = static_cast<quint64>(m_segmentSize);
+
+    // Step 1: Binary search the sorted term table.
+    int lo = 0;
+    int hi = static_cast<int>(header.termCount) - 1;
+    while (lo <= hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const TermEntry entry = readAt<TermEntry>(m_segment, header.termTableOff + mid * sizeof(TermEntry));
+        if (entry.termOff + entry.termLen > limit) {
+            return;
+        }
+        const QByteArray candidate = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(m_segment + entry.termOff), static_cast<int>(entry.termLen));
+
+        if (candidate < term) {
+            lo = mid + 1;
+        } else if (term < candidate) {
+            hi = mid - 1;
+        } else {
+            // Step 2: Decode the delta/varint postings, skipping tombstoned documents.
+            if (entry.postOff + entry.postLen > limit) {
+                return;
+            }
+            const uchar* p = m_segment + entry.postOff;
+            const uchar* end = p + entry.postLen;
+            quint32 id = 0;
+            quint32 delta = 0;
+            while (p < end && getVarint(p, end, &delta)) {
+                id += delta;
+                if (id < header.docCount && !m_tombstones.contains(id)) {
+                    out->insert(baseNameLocked(id));
+                }
+            }
+            return;
+        }
+    }
+}
+
+QString FullTextIndex::segmentPath() const {
+    return Constants::FULLTEXT_INDEX_DIR + QStringLiteral("/segment.bin");
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
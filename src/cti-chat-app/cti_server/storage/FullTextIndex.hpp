@@ -0,0 +1,241 @@
+/**
+ * @file FullTextIndex.hpp
+ * @brief Definition of the FullTextIndex class, an incremental inverted index.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the word index behind the SEARCH command. It maps every
+ * token of every served file to the files containing it, so a query costs a
+ * few postings lookups instead of a scan of the whole directory.
+ */
+
+#ifndef FULLTEXTINDEX_HPP
+#define FULLTEXTINDEX_HPP
+
+// Qt Depends
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDeadlineTimer>
+#include <QReadWriteLock>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+// Other
+#include <atomic>
+#include <memory>
+#include "storage/RootDirectory.hpp"
+
+class QFile;
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class FullTextIndex
+ * @brief Memory-mapped base segment plus an in-memory overlay of recent changes.
+ *
+ * Layout:
+ * - Base segment (<root>/.cti_index/segment.bin, memory-mapped): a sorted
+ *   term table whose postings are ascending document ids, delta-encoded as
+ *   varints. Document ids index a name-sorted document table that also stores
+ *   the size and mtime each document had when it was indexed.
+ * - Overlay: files changed since the segment was written, indexed in memory.
+ *   Their base documents are tombstoned so stale postings are skipped.
+ *
+ * Updates are asynchronous: the mutation hooks only queue the file name, and
+ * a dedicated thread re-tokenizes the file once the update delay has passed
+ * since its first queued change, however many times it changed in the
+ * meantime. A file that keeps growing (an APPEND log) is thus re-read at most
+ * once per delay rather than once per append batch. When the overlay grows
+ * past a threshold, the thread rebuilds the segment (tokenizing files in
+ * parallel) and swaps it in.
+ *
+ * At startup an existing segment is reused: documents whose size or mtime no
+ * longer match, and files the segment does not know, go to the overlay.
+ * Without a usable segment the index is built from scratch. Queries are
+ * refused until this first pass is done.
+ *
+ * Tokens are runs of ASCII letters/digits or non-ASCII bytes, lowercased,
+ * between MIN_TOKEN and MAX_TOKEN bytes long.
+ *
+ * Files and the segment are opened through the RootDirectory like client
+ * paths: symlinks and non-regular files are never indexed, and the size used
+ * is that of the opened descriptor.
+ */
+class FullTextIndex : public QThread {
+    Q_OBJECT
+public:
+    /** @brief Shortest indexed token, in bytes. */
+    static constexpr int MIN_TOKEN = 2;
+
+    /** @brief Longest indexed token, in bytes; longer runs are skipped. */
+    static constexpr int MAX_TOKEN = 64;
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the index size.
+     */
+    struct Stats {
+        quint64 baseDocs = 0;
+        quint64 baseTerms = 0;
+        quint64 overlayDocs = 0;
+        quint64 tombstones = 0;
+        quint64 rebuilds = 0;
+    };
+
+    /**
+     * @brief Creates the index for a served directory and starts its thread.
+     * @param root The directory served to clients.
+     * @param maxFileBytes Files larger than this are not indexed.
+     * @param maxOverlayDocs Overlay size that triggers a segment rebuild.
+     * @param updateDelayMs Delay between a file's first queued change and its re-read.
+     * @param parent Optional QObject parent.
+     */
+    FullTextIndex(std::shared_ptr<const RootDirectory> root, qint64 maxFileBytes, int maxOverlayDocs,
+                  int updateDelayMs, QObject* parent = nullptr);
+
+    /** @brief Stops the index thread and unmaps the segment. */
+    ~FullTextIndex() override;
+
+    /** @brief Returns true once the startup load or build has finished. */
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the files containing every token of @p query, sorted by name.
+     * @param query Free text; tokenized like file content.
+     * @param limit Maximum number of names to return.
+     * @param truncated Optional output, set when more than @p limit files match.
+     */
+    QStringList search(const QString& query, int limit, bool* truncated = nullptr) const;
+
+    /**
+     * @brief Queues a file for (re)indexing after the update delay. A missing
+     *        file is dropped from the index.
+     * @param name Path relative to the root.
+     */
+    void schedule(const QString& name);
+
+    /** @brief Queues a full rebuild of the segment. */
+    void requestRebuild();
+
+    /** @brief Returns a snapshot of the index size. */
+    Stats stats() const;
+
+    /**
+     * @brief Splits text into index tokens.
+     * @return Sorted, unique tokens.
+     */
+    static QVector<QByteArray> tokenize(const char* data, qint64 size);
+
+protected:
+    /** @brief Index loop: initial load/build, then queued updates and rebuilds. */
+    void run() override;
+
+private:
+    /**
+     * @struct Document
+     * @brief Tokens of one file and the metadata they were read at.
+     */
+    struct Document {
+        QString name;
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+        QVector<QByteArray> tokens;
+        bool ok = false;
+    };
+
+    /** @brief Reads and tokenizes one file (no locks held). */
+    Document readDocument(const QString& name) const;
+
+    /** @brief Applies a re-read document (or its removal) to the overlay. */
+    void apply(const Document& doc);
+
+    /** @brief Tokenizes every file in parallel and swaps in a fresh segment. */
+    void rebuild();
+
+    /** @brief Maps an existing segment and moves stale documents to the overlay. */
+    bool loadAndReconcile();
+
+    /** @brief Maps the segment file; validates its header and tables. */
+    bool mapSegment();
+
+    /** @brief Unmaps the current segment. Caller holds m_lock for writing. */
+    void unmapSegmentLocked();
+
+    /** @brief Returns the base document id of @p name, or -1. Caller holds m_lock. */
+    int baseDocLocked(const QString& name) const;
+
+    /** @brief Returns the name of base document @p id. Caller holds m_lock. */
+    QString baseNameLocked(quint32 id) const;
+
+    /** @brief Adds the live base documents containing @p term to @p out. Caller holds m_lock. */
+    void basePostingsLocked(const QByteArray& term, QSet<QString>* out) const;
+
+    /** @brief Path of the segment file relative to the root. */
+    QString segmentPath() const;
+
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Indexing size limit per file. */
+    const qint64 m_maxFileBytes;
+
+    /** @brief Overlay size that triggers a rebuild. */
+    const int m_maxOverlayDocs;
+
+    /** @brief Delay before a queued file is re-read. */
+    const int m_updateDelayMs;
+
+    /** @brief Protects the segment mapping, tombstones and overlay. */
+    mutable QReadWriteLock m_lock;
+
+    /** @brief Open segment file (owner of the mapping). */
+    std::unique_ptr<QFile> m_segmentFile;
+
+    /** @brief Mapped segment bytes, or nullptr. */
+    const uchar* m_segment = nullptr;
+
+    /** @brief Size of the mapping. */
+    qint64 m_segmentSize = 0;
+
+    /** @brief Base documents superseded by the overlay or removed. */
+    QSet<quint32> m_tombstones;
+
+    /** @brief Overlay: tokens per file. */
+    QHash<QString, QVector<QByteArray>> m_overlayDocs;
+
+    /** @brief Overlay: files per token. */
+    QHash<QByteArray, QSet<QString>> m_overlayTerms;
+
+    /** @brief Protects the work queue and flags below. */
+    QMutex m_queueMutex;
+
+    /** @brief Signals the index thread that work is queued. */
+    QWaitCondition m_workAvailable;
+
+    /** @brief Names waiting to be re-indexed, with the time each one is due. */
+    QHash<QString, QDeadlineTimer> m_pending;
+
+    /** @brief Set when a full rebuild is wanted. */
+    bool m_rebuildRequested = false;
+
+    /** @brief Set by the destructor to end the index loop. */
+    bool m_stopping = false;
+
+    /** @brief Set once the initial load/build has completed. */
+    std::atomic<bool> m_ready{false};
+
+    /** @brief Number of completed segment builds. */
+    std::atomic<quint64> m_rebuilds{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* FULLTEXTINDEX_HPP */
@@ -0,0 +1,407 @@
+/**
+ * @file MetadataIndex.cpp
+ * @brief Implementation of the inotify-backed directory metadata index.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QRegularExpression>
+#include <QSocketNotifier>
+#include <QFileSystemWatcher>
+
+// Other
+#include "MetadataIndex.hpp"
+#include "RootDirectory.hpp"
+#include "error/error_emitter.hpp"
+
+#include <sys/stat.h>
+#if defined(Q_OS_LINUX)
+#   include <sys/inotify.h>
+#   include <unistd.h>
+#endif
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Fills @p out from a stat() result; false unless it describes a regular file. */
+bool fromStat(const struct stat& st, FileMeta* out) {
+    if (!S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    if (out) {
+        out->size  = static_cast<qint64>(st.st_size);
+#if defined(Q_OS_LINUX)
+        out->mtimeMs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000
+                     + st.st_mtim.tv_nsec / 1000000;
+#else
+        out->mtimeMs = static_cast<qint64>(st.st_mtime) * 1000;
+#endif
+        out->inode = static_cast<quint64>(st.st_ino);
+    }
+    return true;
+}
+
+/** @brief Base64 flavour used for cursors: safe inside ';'/',' separated arguments. */
+const QByteArray::Base64Options CURSOR_ENCODING =
+    QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals;
+
+/**
+ * @brief Encodes the position after an entry as an opaque cursor ("<tag>:<key>:<name>").
+ */
+QString encodeCursor(char tag, qint64 key, const QString& name) {
+    QByteArray raw = QByteArray(1, tag) + ':' + QByteArray::number(key) + ':' + name.toUtf8();
+    return QString::fromLatin1(raw.toBase64(CURSOR_ENCODING));
+}
+
+/**
+ * @brief Decodes a cursor produced by encodeCursor() for the given sort tag.
+ */
+bool decodeCursor(const QString& cursor, char tag, qint64* key, QString* name) {
+    QByteArray raw = QByteArray::fromBase64(cursor.toLatin1(), CURSOR_ENCODING);
+    if (raw.size() < 3 || raw.at(0) != tag || raw.at(1) != ':') {
+        return false;
+    }
+
+    int sep = raw.indexOf(':', 2);
+    if (sep < 0) {
+        return false;
+    }
+
+    bool ok = false;
+    *key = raw.mid(2, sep - 2).toLongLong(&ok);
+    *name = QString::fromUtf8(raw.mid(sep + 1));
+    return ok;
+}
+
+/** @brief Returns the literal part of a glob before its first wildcard. */
+QString literalPrefix(const QString& glob) {
+    int i = 0;
+    while (i < glob.size() && glob[i] != '*' && glob[i] != '?' && glob[i] != '[') {
+        ++i;
+    }
+    return glob.left(i);
+}
+
+/** @brief Returns the cursor tag of a sort key. */
+char tagOf(ListQuery::SortKey key) {
+    switch (key) {
+        case ListQuery::SortKey::Size:  return 's';
+        case ListQuery::SortKey::Mtime: return 'm';
+        default:                        return 'n';
+    }
+}
+
+/**
+ * @class ListFilter
+ * @brief Prefix + glob predicate shared by all listing orders.
+ */
+class ListFilter {
+public:
+    explicit ListFilter(const ListQuery& query)
+        : m_prefix(query.prefix),
+          m_hasGlob(!query.glob.isEmpty()),
+          m_glob(m_hasGlob ? QRegularExpression(QRegularExpression::wildcardToRegularExpression(query.glob))
+                           : QRegularExpression()) {}
+
+    bool matches(const QString& name) const {
+        return name.startsWith(m_prefix) && (!m_hasGlob || m_glob.match(name).hasMatch());
+    }
+
+private:
+    QString m_prefix;
+    bool m_hasGlob;
+    QRegularExpression m_glob;
+};
+
+} /* namespace */
+
+/**
+ * @brief Constructs the index, performs the initial scan and starts watching.
+ */
+MetadataIndex::MetadataIndex(std::shared_ptr<const RootDirectory> root, QObject* parent)
+    : QObject(parent),
+      m_dir(std::move(root)),
+      m_root(m_dir->path()) {
+    // Step 1: Watch first so no change between the scan and the watch is lost.
+    startWatching();
+
+    // Step 2: Populate the index from disk.
+    rebuild();
+    EMIT_INFO() << "Metadata index ready. Files indexed:" << size();
+}
+
+MetadataIndex::~MetadataIndex() {
+#if defined(Q_OS_LINUX)
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+#endif
+}
+
+bool MetadataIndex::lookup(const QString& name, FileMeta* out) const {
+    if (!isIndexable(name)) {
+        // Not covered by the watch (nested or hidden): answer from disk.
+        return m_dir->stat(name, out);
+    }
+
+    QReadLocker locker(&m_lock);
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+    if (out) {
+        *out = it.value();
+    }
+    return true;
+}
+
+QStringList MetadataIndex::names() const {
+    QReadLocker locker(&m_lock);
+    return m_entries.keys();
+}
+
+bool MetadataIndex::list(const ListQuery& query, ListPage* page) const {
+    if (query.sort == ListQuery::SortKey::Size) {
+        QReadLocker locker(&m_lock);
+        return listOrdered(m_bySize, query, page);
+    }
+    if (query.sort == ListQuery::SortKey::Mtime) {
+        QReadLocker locker(&m_lock);
+        return listOrdered(m_byMtime, query, page);
+    }
+
+    // Step 1: Resolve the resume point from the cursor.
+    qint64 unused = 0;
+    QString after;
+    if (!query.cursor.isEmpty() && !decodeCursor(query.cursor, 'n', &unused, &after)) {
+        return false;
+    }
+
+    // Step 2: Narrow the scan to the tightest literal prefix (prefix vs. glob head).
+    QString seek = query.prefix;
+    const QString globHead = literalPrefix(query.glob);
+    if (globHead.startsWith(seek)) {
+        seek = globHead;
+    } else if (!seek.startsWith(globHead)) {
+        return true; // Disjoint prefix and glob: nothing can match.
+    }
+
+    const ListFilter filter(query);
+    QReadLocker locker(&m_lock);
+
+    // Step 3: Seek in O(log n), then walk forward until the page is full.
+    auto it = m_entries.lowerBound(seek);
+    if (!after.isEmpty() && after >= seek) {
+        it = m_entries.upperBound(after);
+    }
+
+    QString last;
+    for (; it != m_entries.constEnd() && it.key().startsWith(seek); ++it) {
+        if (!filter.matches(it.key())) {
+            continue;
+        }
+        if (query.limit > 0 && page->names.size() >= query.limit) {
+            page->nextCursor = encodeCursor('n', 0, last);
+            break;
+        }
+        page->names.append(it.key());
+        last = it.key();
+    }
+    return true;
+}
+
+bool MetadataIndex::listOrdered(const OrderedSet& set, const ListQuery& query, ListPage* page) const {
+    const char tag = tagOf(query.sort);
+    auto it = set.begin();
+
+    // Step 1: Seek past the cursor entry in O(log n).
+    if (!query.cursor.isEmpty()) {
+        qint64 key = 0;
+        QString name;
+        if (!decodeCursor(query.cursor, tag, &key, &name)) {
+            return false;
+        }
+        it = set.upper_bound(std::make_pair(key, name));
+    }
+
+    // Step 2: Walk forward, filtering, until the page is full.
+    const ListFilter filter(query);
+    qint64 lastKey = 0;
+    QString lastName;
+    for (; it != set.end(); ++it) {
+        if (!filter.matches(it->second)) {
+            continue;
+        }
+        if (query.limit > 0 && page->names.size() >= query.limit) {
+            page->nextCursor = encodeCursor(tag, lastKey, lastName);
+            break;
+        }
+        page->names.append(it->second);
+        lastKey = it->first;
+        lastName = it->second;
+    }
+    return true;
+}
+
+int MetadataIndex::size() const {
+    QReadLocker locker(&m_lock);
+    return m_entries.size();
+}
+
+void MetadataIndex::refresh(const QString& name) {
+    if (!isIndexable(name)) {
+        return;
+    }
+
+    FileMeta meta;
+    bool exists = m_dir->stat(name, &meta);
+
+    QWriteLocker locker(&m_lock);
+    if (exists) {
+        insertLocked(name, meta);
+    } else {
+        eraseLocked(name);
+    }
+}
+
+void MetadataIndex::remove(const QString& name) {
+    QWriteLocker locker(&m_lock);
+    eraseLocked(name);
+}
+
+void MetadataIndex::insertLocked(const QString& name, const FileMeta& meta) {
+    eraseLocked(name);
+    m_entries.insert(name, meta);
+    m_bySize.emplace(meta.size, name);
+    m_byMtime.emplace(meta.mtimeMs, name);
+}
+
+void MetadataIndex::eraseLocked(const QString& name) {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        return;
+    }
+    m_bySize.erase(std::make_pair(it->size, name));
+    m_byMtime.erase(std::make_pair(it->mtimeMs, name));
+    m_entries.erase(it);
+}
+
+void MetadataIndex::rebuild() {
+    // Step 1: Scan without holding the lock; readers keep the old view meanwhile.
+    QDir dir(m_root);
+    const QStringList files = dir.entryList(QDir::Files | QDir::NoDotAndDotDot);
+
+    QMap<QString, FileMeta> fresh;
+    OrderedSet bySize;
+    OrderedSet byMtime;
+    for (const QString& name : files) {
+        FileMeta meta;
+        if (m_dir->stat(name, &meta)) {
+            fresh.insert(name, meta);
+            bySize.emplace(meta.size, name);
+            byMtime.emplace(meta.mtimeMs, name);
+        }
+    }
+
+    // Step 2: Publish the new views.
+    QWriteLocker locker(&m_lock);
+    m_entries.swap(fresh);
+    m_bySize.swap(bySize);
+    m_byMtime.swap(byMtime);
+}
+
+bool MetadataIndex::statFile(const QString& path, FileMeta* out) {
+    struct stat st;
+    return ::stat(QFile::encodeName(path).constData(), &st) == 0 && fromStat(st, out);
+}
+
+bool MetadataIndex::statDescriptor(int fd, FileMeta* out) {
+    struct stat st;
+    return ::fstat(fd, &st) == 0 && fromStat(st, out);
+}
+
+void MetadataIndex::startWatching() {
+#if defined(Q_OS_LINUX)
+    m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd >= 0) {
+        const uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE
+                            | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO;
+        if (::inotify_add_watch(m_inotifyFd, QFile::encodeName(m_root).constData(), mask) >= 0) {
+            m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+            connect(m_notifier, &QSocketNotifier::activated,
+                    this, &MetadataIndex::onInotifyActivated);
+            EMIT_DEBUG() << "Metadata index watching" << m_root << "via inotify.";
+            return;
+        }
+        ::close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+    EMIT_WARN() << "inotify unavailable, falling back to QFileSystemWatcher.";
+#endif
+
+    m_watcher = new QFileSystemWatcher(QStringList{m_root}, this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &MetadataIndex::onDirectoryChanged);
+}
+
+void MetadataIndex::onInotifyActivated() {
+#if defined(Q_OS_LINUX)
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    QSet<QString> touched;
+    bool overflow = false;
+
+    // Step 1: Drain the queue, coalescing repeated events on the same name.
+    while (true) {
+        ssize_t len = ::read(m_inotifyFd, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+
+        for (char* p = buffer; p < buffer + len; ) {
+            auto* ev = reinterpret_cast<struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+            } else if (ev->len > 0) {
+                touched.insert(QFile::decodeName(ev->name));
+            }
+        }
+    }
+
+    // Step 2: The kernel dropped events; incremental state is unreliable.
+    if (overflow) {
+        EMIT_WARN() << "inotify queue overflow. Rescanning" << m_root;
+        rebuild();
+        emit rebuilt();
+        return;
+    }
+
+    // Step 3: One stat per distinct name settles create/modify/delete/move alike.
+    for (const QString& name : touched) {
+        refresh(name);
+        emit entryChanged(name);
+    }
+#endif
+}
+
+void MetadataIndex::onDirectoryChanged(const QString& path) {
+    Q_UNUSED(path);
+    rebuild();
+    emit rebuilt();
+}
+
+bool MetadataIndex::isIndexable(const QString& name) {
+    return !name.isEmpty() && !name.contains('/') && !name.startsWith('.');
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,272 @@
+/**
+ * @file MetadataIndex.hpp
+ * @brief Definition of the MetadataIndex class, an in-memory view of the served directory.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the directory/metadata index used by the LIST and INFO
+ * commands. The index is built once at startup and kept current through
+ * inotify events, so metadata queries are served from memory instead of
+ * hitting the filesystem on every request.
+ */
+
+#ifndef METADATAINDEX_HPP
+#define METADATAINDEX_HPP
+
+// Qt Depends
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QReadWriteLock>
+
+// Other
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+
+class QSocketNotifier;
+class QFileSystemWatcher;
+
+namespace CTI {
+namespace Chat {
+
+class RootDirectory;
+
+/**
+ * @struct FileMeta
+ * @brief Cached stat() result for a single served file.
+ */
+struct FileMeta {
+    /** @brief File size in bytes. */
+    qint64 size = 0;
+
+    /** @brief Last modification time in milliseconds since the epoch. */
+    qint64 mtimeMs = 0;
+
+    /** @brief Inode number, used to detect replaced files with equal mtime. */
+    quint64 inode = 0;
+};
+
+/**
+ * @struct ListQuery
+ * @brief Parameters of a paginated directory listing.
+ */
+struct ListQuery {
+    /** @brief Ordering of the listing. */
+    enum class SortKey { Name, Size, Mtime };
+
+    /** @brief Sort order; ties on size/mtime are broken by name. */
+    SortKey sort = SortKey::Name;
+
+    /** @brief Only names starting with this prefix are returned (empty = all). */
+    QString prefix;
+
+    /** @brief Wildcard filter such as "*.log" (empty = all). */
+    QString glob;
+
+    /** @brief Opaque cursor returned by the previous page (empty = first page). */
+    QString cursor;
+
+    /** @brief Maximum number of names in the page. */
+    int limit = 0;
+};
+
+/**
+ * @struct ListPage
+ * @brief One page of a directory listing.
+ */
+struct ListPage {
+    /** @brief Names in the requested order. */
+    QStringList names;
+
+    /** @brief Cursor for the next page, empty when this is the last page. */
+    QString nextCursor;
+};
+
+/**
+ * @class MetadataIndex
+ * @brief Thread-safe, inotify-backed index of the files in the served directory.
+ *
+ * The index mirrors what `QDir::entryList(QDir::Files)` would return for the
+ * root directory (regular files, no hidden entries), together with their
+ * size, modification time and inode.
+ *
+ * Lifecycle:
+ * 1. A full scan populates the index at construction.
+ * 2. An inotify watch on the root delivers create/modify/delete/move events
+ *    through a QSocketNotifier on the owning thread's event loop.
+ * 3. If the kernel event queue overflows (IN_Q_OVERFLOW) the index can no
+ *    longer trust its incremental state and falls back to a full rescan.
+ *
+ * Besides the name-sorted primary map, the index keeps ordered secondary
+ * sets by size and by mtime, so a listing page is produced by seeking to the
+ * cursor position (O(log n)) and walking forward (O(page)).
+ *
+ * Readers (session threads) only take a shared lock. Writers are the event
+ * loop of the owning thread and the file commands themselves, which refresh
+ * entries they mutated so a client never observes its own stale metadata.
+ *
+ * @note On platforms without inotify a QFileSystemWatcher is used instead and
+ *       every directory change triggers a full rescan.
+ */
+class MetadataIndex : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Builds the index for the given directory and starts watching it.
+     * @param root The directory to index; entries are resolved beneath it.
+     * @param parent Optional QObject parent.
+     */
+    explicit MetadataIndex(std::shared_ptr<const RootDirectory> root, QObject* parent = nullptr);
+
+    /** @brief Releases the inotify descriptor. */
+    ~MetadataIndex() override;
+
+    /**
+     * @brief Looks up the metadata of a served file.
+     *
+     * Top-level names are answered from memory. Nested paths ("dir/file") are
+     * outside the watched directory and are answered from disk, beneath the root.
+     *
+     * @param name Path relative to the root.
+     * @param out Receives the metadata when found.
+     * @return true if the file exists.
+     */
+    bool lookup(const QString& name, FileMeta* out) const;
+
+    /**
+     * @brief Returns every indexed file name, sorted by name.
+     */
+    QStringList names() const;
+
+    /**
+     * @brief Returns one page of the listing described by @p query.
+     *
+     * Name ordering with a prefix (or a glob with a literal prefix) seeks
+     * directly to the first candidate. Size/mtime orderings seek to the
+     * cursor and filter while walking.
+     *
+     * @param query Sort key, filters, cursor and page size.
+     * @param page Receives the names and the next cursor.
+     * @return false if the cursor is malformed or belongs to another sort key.
+     */
+    bool list(const ListQuery& query, ListPage* page) const;
+
+    /** @brief Returns the number of indexed files. */
+    int size() const;
+
+    /**
+     * @brief Re-reads the metadata of a single entry.
+     *
+     * Inserts, updates or removes the entry depending on what is found on
+     * disk. File commands call this after a successful mutation.
+     *
+     * @param name Path relative to the root.
+     */
+    void refresh(const QString& name);
+
+    /**
+     * @brief Drops a single entry from the index.
+     * @param name Path relative to the root.
+     */
+    void remove(const QString& name);
+
+    /**
+     * @brief Discards the current state and rescans the whole directory.
+     *
+     * Used at startup and as the consistency fallback after an inotify
+     * queue overflow.
+     */
+    void rebuild();
+
+    /**
+     * @brief Reads the metadata of a regular file directly from disk.
+     * @param path Filesystem path of the file.
+     * @param out Receives the metadata when the file exists.
+     * @return true if @p path is an existing regular file.
+     */
+    static bool statFile(const QString& path, FileMeta* out);
+
+    /**
+     * @brief Same as statFile() for an already open descriptor (fstat()).
+     * @return true if @p fd refers to a regular file.
+     */
+    static bool statDescriptor(int fd, FileMeta* out);
+
+    /**
+     * @brief Returns true if @p name belongs in the index (top-level, not hidden).
+     *
+     * Only such files are watched, so only they produce entryChanged().
+     */
+    static bool isIndexable(const QString& name);
+
+signals:
+    /**
+     * @brief Emitted when a watch event reported a change to @p name.
+     *
+     * Covers external modifications as well as the server's own, and fires
+     * after the index entry has been updated.
+     */
+    void entryChanged(const QString& name);
+
+    /** @brief Emitted after a full rescan replaced the whole index. */
+    void rebuilt();
+
+private slots:
+    /** @brief Drains pending inotify events and applies them to the index. */
+    void onInotifyActivated();
+
+    /** @brief Fallback watcher callback: rescans the directory. */
+    void onDirectoryChanged(const QString& path);
+
+private:
+    /** @brief Sets up inotify (or the QFileSystemWatcher fallback). */
+    void startWatching();
+
+    /** @brief (size|mtime, name) pairs ordered for the secondary sort keys. */
+    using OrderedSet = std::set<std::pair<qint64, QString>>;
+
+    /** @brief Inserts or replaces an entry in all views. Caller holds the write lock. */
+    void insertLocked(const QString& name, const FileMeta& meta);
+
+    /** @brief Removes an entry from all views. Caller holds the write lock. */
+    void eraseLocked(const QString& name);
+
+    /** @brief Walks a secondary ordered set from the cursor position. */
+    bool listOrdered(const OrderedSet& set, const ListQuery& query, ListPage* page) const;
+
+    /** @brief The directory being indexed. */
+    std::shared_ptr<const RootDirectory> m_dir;
+
+    /** @brief Its path (for scanning and watching). */
+    QString m_root;
+
+    /** @brief Name-sorted map of indexed files. */
+    QMap<QString, FileMeta> m_entries;
+
+    /** @brief Secondary view ordered by (size, name). */
+    OrderedSet m_bySize;
+
+    /** @brief Secondary view ordered by (mtime, name). */
+    OrderedSet m_byMtime;
+
+    /** @brief Protects m_entries; readers are session threads. */
+    mutable QReadWriteLock m_lock;
+
+    /** @brief inotify descriptor, or -1 when inotify is unavailable. */
+    int m_inotifyFd = -1;
+
+    /** @brief Event loop hook for m_inotifyFd. */
+    QSocketNotifier* m_notifier = nullptr;
+
+    /** @brief Fallback watcher when inotify cannot be used. */
+    QFileSystemWatcher* m_watcher = nullptr;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* METADATAINDEX_HPP */
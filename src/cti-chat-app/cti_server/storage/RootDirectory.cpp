@@ -0,0 +1,279 @@
+/**
+ * @file RootDirectory.cpp
+ * @brief Implementation of the openat2-based served directory sandbox.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+// Other
+#include "RootDirectory.hpp"
+#include "error/error_emitter.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<linux/openat2.h>)
+#   include <linux/openat2.h>
+#endif
+
+#if defined(SYS_openat2) && defined(RESOLVE_BENEATH)
+#   define CTI_HAVE_OPENAT2 1
+#endif
+
+namespace CTI {
+namespace Chat {
+
+namespace {
+
+/** @brief Closes a descriptor without clobbering errno. */
+void closeKeepErrno(int fd) {
+    const int saved = errno;
+    ::close(fd);
+    errno = saved;
+}
+
+} /* namespace */
+
+RootDirectory::RootDirectory(const QString& path) {
+    const QFileInfo info(path);
+    m_path = info.canonicalFilePath();
+    if (m_path.isEmpty()) {
+        m_path = info.absoluteFilePath();
+    }
+
+    m_fd = ::open(QFile::encodeName(m_path).constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (m_fd < 0) {
+        EMIT_ERROR() << "Cannot open served directory" << m_path << "errno:" << errno;
+        return;
+    }
+    EMIT_INFO() << "Serving directory:" << m_path;
+}
+
+RootDirectory::~RootDirectory() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool RootDirectory::contains(const QString& hostPath) const {
+    // Step 1: Canonical path of the file, or of its directory if it does not exist yet.
+    const QFileInfo info(hostPath);
+    QString canonical = info.canonicalFilePath();
+    if (canonical.isEmpty()) {
+        const QString dir = info.absoluteDir().canonicalPath();
+        canonical = dir.isEmpty() ? QDir::cleanPath(info.absoluteFilePath())
+                                  : QDir(dir).filePath(info.fileName());
+    }
+
+    // Step 2: Beneath the root, or the root itself.
+    return canonical == m_path || m_path == QLatin1String("/")
+        || canonical.startsWith(m_path + QLatin1Char('/'));
+}
+
+int RootDirectory::open(const QString& name, int flags, mode_t mode) const {
+    return resolve(QFile::encodeName(name), flags, mode);
+}
+
+int RootDirectory::openParent(const QString& name, QByteArray* leaf) const {
+    const QByteArray encoded = QFile::encodeName(name);
+    const int slash = encoded.lastIndexOf('/');
+    *leaf = encoded.mid(slash + 1);
+    if (leaf->isEmpty() || *leaf == "." || *leaf == "..") {
+        errno = EINVAL;
+        return -1;
+    }
+    return resolve(slash < 0 ? QByteArrayLiteral(".") : encoded.left(slash), O_RDONLY | O_DIRECTORY, 0);
+}
+
+bool RootDirectory::openRead(const QString& name, QFile* file) const {
+    // O_NONBLOCK: a FIFO must not block the open; it is refused below anyway.
+    const int fd = open(name, O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)
+        || !file->open(fd, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle)) {
+        ::close(fd);
+        return false;
+    }
+    return true;
+}
+
+bool RootDirectory::stat(const QString& name, FileMeta* out) const {
+    const int fd = open(name, O_PATH);
+    if (fd < 0) {
+        return false;
+    }
+    const bool ok = MetadataIndex::statDescriptor(fd, out);
+    ::close(fd);
+    return ok;
+}
+
+bool RootDirectory::remove(const QString& name) const {
+    QByteArray leaf;
+    const int dir = openParent(name, &leaf);
+    if (dir < 0) {
+        return false;
+    }
+    const bool ok = (::unlinkat(dir, leaf.constData(), 0) == 0);
+    closeKeepErrno(dir);
+    return ok;
+}
+
+bool RootDirectory::makeDirectory(const QString& name) const {
+    QByteArray leaf;
+    const int dir = openParent(name, &leaf);
+    if (dir < 0) {
+        return false;
+    }
+    struct stat st;
+    const bool ok = (::mkdirat(dir, leaf.constData(), 0755) == 0)
+        || (errno == EEXIST && ::fstatat(dir, leaf.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0
+            && S_ISDIR(st.st_mode));
+    closeKeepErrno(dir);
+    return ok;
+}
+
+bool RootDirectory::rename(const QString& from, const QString& to) const {
+    QByteArray fromLeaf;
+    QByteArray toLeaf;
+    const int fromDir = openParent(from, &fromLeaf);
+    if (fromDir < 0) {
+        return false;
+    }
+    const int toDir = openParent(to, &toLeaf);
+    if (toDir < 0) {
+        closeKeepErrno(fromDir);
+        return false;
+    }
+
+    // Never replace an existing destination (QFile::rename semantics).
+    const int rc = renameNoReplace(fromDir, fromLeaf.constData(), toDir, toLeaf.constData());
+
+    closeKeepErrno(fromDir);
+    closeKeepErrno(toDir);
+    return rc == 0;
+}
+
+int RootDirectory::renameNoReplace(int fromDir, const char* fromLeaf, int toDir, const char* toLeaf) {
+#if defined(RENAME_NOREPLACE)
+    const int rc = ::renameat2(fromDir, fromLeaf, toDir, toLeaf, RENAME_NOREPLACE);
+    if (rc == 0 || (errno != EINVAL && errno != ENOSYS)) {
+        return rc;
+    }
+#endif
+    struct stat st;
+    if (::fstatat(toDir, toLeaf, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    return ::renameat(fromDir, fromLeaf, toDir, toLeaf);
+}
+
+qint64 RootDirectory::readAt(int fd, qint64 offset, char* out, qint64 length) {
+    qint64 done = 0;
+    while (done < length) {
+        const ssize_t n = ::pread(fd, out + done, static_cast<size_t>(length - done),
+                                  static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+int RootDirectory::resolve(const QByteArray& relative, int flags, mode_t mode) const {
+    if (m_fd < 0 || relative.isEmpty() || relative.contains('\0')) {
+        errno = ENOENT;
+        return -1;
+    }
+
+#if defined(CTI_HAVE_OPENAT2)
+    static std::atomic<bool> unsupported{false};
+    if (!unsupported.load(std::memory_order_relaxed)) {
+        struct open_how how;
+        std::memset(&how, 0, sizeof(how));
+        how.flags = static_cast<quint64>(flags | O_CLOEXEC);
+        how.mode = (flags & O_CREAT) ? mode : 0;
+        how.resolve = RESOLVE_BENEATH | RESOLVE_NO_SYMLINKS;
+
+        int fd;
+        do {
+            fd = static_cast<int>(::syscall(SYS_openat2, m_fd, relative.constData(), &how, sizeof(how)));
+        } while (fd < 0 && errno == EINTR);
+        if (fd >= 0 || errno != ENOSYS) {
+            return fd;
+        }
+        unsupported.store(true, std::memory_order_relaxed);
+        EMIT_WARN() << "openat2 is not available; resolving paths component by component.";
+    }
+#endif
+    return walk(relative, flags, mode);
+}
+
+int RootDirectory::walk(const QByteArray& relative, int flags, mode_t mode) const {
+    if (relative.startsWith('/')) {
+        errno = EXDEV;
+        return -1;
+    }
+
+    const QList<QByteArray> parts = relative.split('/');
+    int dir = m_fd;
+    int owned = -1;
+    for (int i = 0; i < parts.size(); ++i) {
+        const QByteArray& part = parts[i];
+        const bool trivial = part.isEmpty() || part == ".";
+        if (part == "..") {
+            if (owned >= 0) {
+                ::close(owned);
+            }
+            errno = EXDEV;
+            return -1;
+        }
+
+        // Step 1: Intermediate components must be real directories.
+        if (i + 1 < parts.size()) {
+            if (trivial) {
+                continue;
+            }
+            const int next = ::openat(dir, part.constData(), O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (owned >= 0) {
+                closeKeepErrno(owned);
+            }
+            if (next < 0) {
+                return -1;
+            }
+            dir = owned = next;
+            continue;
+        }
+
+        // Step 2: The last one is opened without following a symlink.
+        const int fd = ::openat(dir, trivial ? "." : part.constData(), flags | O_NOFOLLOW | O_CLOEXEC, mode);
+        if (owned >= 0) {
+            closeKeepErrno(owned);
+        }
+        return fd;
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,160 @@
+/**
+ * @file RootDirectory.hpp
+ * @brief Definition of the RootDirectory class, the sandbox every file command resolves through.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the handle on the served directory. Client paths are
+ * never handed to the C library as strings; they are resolved by the kernel
+ * relative to one descriptor opened at startup, and may not leave it.
+ */
+
+#ifndef ROOTDIRECTORY_HPP
+#define ROOTDIRECTORY_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QString>
+
+// Other
+#include <sys/types.h>
+#include "storage/MetadataIndex.hpp"
+
+class QFile;
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class RootDirectory
+ * @brief Pre-opened served directory; resolves client paths beneath it.
+ *
+ * Every lookup is a single openat2(2) on the root descriptor with
+ * RESOLVE_BENEATH | RESOLVE_NO_SYMLINKS: the kernel refuses absolute paths,
+ * ".." that would climb above the root and symlinks anywhere in the path,
+ * and it does so atomically with the open, so there is no window between a
+ * check and the use of the path. Kernels older than 5.6 (no openat2) get an
+ * equivalent walk, one openat(O_NOFOLLOW) per component, that refuses ".."
+ * altogether.
+ *
+ * Operations that act on a directory entry rather than on a file (create,
+ * rename, unlink) open the entry's parent the same way and use the *at()
+ * system calls on the last component.
+ *
+ * The object is immutable after construction and safe to share between
+ * threads.
+ */
+class RootDirectory {
+public:
+    /**
+     * @brief Opens the served directory.
+     * @param path Directory to serve (relative to the process CWD or absolute).
+     */
+    explicit RootDirectory(const QString& path);
+
+    /** @brief Closes the root descriptor. */
+    ~RootDirectory();
+
+    RootDirectory(const RootDirectory&) = delete;
+    RootDirectory& operator=(const RootDirectory&) = delete;
+
+    /** @brief True if the directory could be opened. */
+    bool isOpen() const { return m_fd >= 0; }
+
+    /** @brief Canonical absolute path of the served directory. */
+    const QString& path() const { return m_path; }
+
+    /**
+     * @brief True if a host path (existing or not) lies beneath the served directory.
+     *
+     * Used at startup to keep server-private files (credentials, TLS key) out
+     * of reach of the file commands. Symlinks in the existing part of
+     * @p hostPath are resolved first.
+     */
+    bool contains(const QString& hostPath) const;
+
+    /**
+     * @brief Opens a file beneath the root.
+     * @param name Path relative to the root.
+     * @param flags open(2) flags; O_CLOEXEC is always added.
+     * @param mode Permission bits when @p flags creates the file.
+     * @return Descriptor owned by the caller, or -1 with errno set (EXDEV or
+     *         ELOOP when the path would escape the root).
+     */
+    int open(const QString& name, int flags, mode_t mode = 0) const;
+
+    /**
+     * @brief Opens the directory containing @p name.
+     * @param name Path relative to the root.
+     * @param leaf Receives the last component of @p name.
+     * @return Directory descriptor (O_RDONLY, usable with the *at() calls and
+     *         fsync()) owned by the caller, or -1 with errno set.
+     */
+    int openParent(const QString& name, QByteArray* leaf) const;
+
+    /**
+     * @brief Opens a regular file for reading into @p file (which owns the descriptor).
+     * @return false if the file does not exist beneath the root or is not regular.
+     */
+    bool openRead(const QString& name, QFile* file) const;
+
+    /**
+     * @brief Reads the metadata of a regular file beneath the root.
+     * @param out Receives the metadata (may be null).
+     * @return true if @p name is an existing regular file.
+     */
+    bool stat(const QString& name, FileMeta* out) const;
+
+    /** @brief Removes a directory entry (not a directory). */
+    bool remove(const QString& name) const;
+
+    /** @brief Creates a directory; true if a (real, not symlinked) directory exists afterwards. */
+    bool makeDirectory(const QString& name) const;
+
+    /**
+     * @brief Renames an entry; fails if @p to already exists.
+     * @return false with errno set (EEXIST when @p to exists).
+     */
+    bool rename(const QString& from, const QString& to) const;
+
+    /**
+     * @brief renameat(2) that never replaces an existing destination.
+     *
+     * Uses renameat2(RENAME_NOREPLACE), so the existence check and the rename
+     * are one atomic step; filesystems without it get a check-then-rename.
+     *
+     * @return 0, or -1 with errno set (EEXIST when the destination exists).
+     */
+    static int renameNoReplace(int fromDir, const char* fromLeaf, int toDir, const char* toLeaf);
+
+    /**
+     * @brief pread(2) until @p length bytes are read or the file ends.
+     *
+     * Files beneath the root may be truncated by other processes at any time,
+     * so they are read this way and never memory-mapped: touching a mapped
+     * page past the new end of the file raises SIGBUS.
+     *
+     * @return Bytes read (fewer than @p length only at the end of the file),
+     *         or -1 with errno set.
+     */
+    static qint64 readAt(int fd, qint64 offset, char* out, qint64 length);
+
+private:
+    /** @brief openat2(RESOLVE_BENEATH | RESOLVE_NO_SYMLINKS), or the walk on old kernels. */
+    int resolve(const QByteArray& relative, int flags, mode_t mode) const;
+
+    /** @brief Component-by-component fallback for kernels without openat2. */
+    int walk(const QByteArray& relative, int flags, mode_t mode) const;
+
+    /** @brief Canonical absolute path. */
+    QString m_path;
+
+    /** @brief O_PATH descriptor of the root. */
+    int m_fd = -1;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* ROOTDIRECTORY_HPP */
@@ -0,0 +1,179 @@
+/**
+ * @file WatchRegistry.cpp
+ * @brief Implementation of the WATCH subscription table.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QDateTime>
+#include <QDir>
+#include <QMutexLocker>
+#include <QVector>
+
+// Other
+#include "WatchRegistry.hpp"
+#include "error/error_emitter.hpp"
+
+#include <vector>
+
+namespace CTI {
+namespace Chat {
+
+void WatchRegistry::setSink(Sink sink) {
+    QMutexLocker locker(&m_mutex);
+    m_sink = std::move(sink);
+}
+
+bool WatchRegistry::watch(const std::string& clientId, const QString& path) {
+    const QString key = keyOf(path);
+
+    // Step 1: Capture the current state, so the first event is a real change.
+    FileMeta meta;
+    const bool exists = m_root->stat(key, &meta);
+
+    QMutexLocker locker(&m_mutex);
+    QSet<QString>& paths = m_byClient[clientId];
+    if (!paths.contains(key) && paths.size() >= m_maxPerClient) {
+        return false;
+    }
+    paths.insert(key);
+
+    // Step 2: Join (or open) the path's watch.
+    auto it = m_byPath.find(key);
+    if (it == m_byPath.end()) {
+        Watch watch;
+        watch.last = meta;
+        watch.exists = exists;
+        it = m_byPath.insert(key, watch);
+    }
+    it->clients.insert(clientId);
+    return true;
+}
+
+bool WatchRegistry::unwatch(const std::string& clientId, const QString& path) {
+    const QString key = keyOf(path);
+
+    QMutexLocker locker(&m_mutex);
+    auto client = m_byClient.find(clientId);
+    if (client == m_byClient.end() || !client->second.remove(key)) {
+        return false;
+    }
+    if (client->second.isEmpty()) {
+        m_byClient.erase(client);
+    }
+
+    auto it = m_byPath.find(key);
+    if (it != m_byPath.end()) {
+        it->clients.erase(clientId);
+        if (it->clients.empty()) {
+            m_byPath.erase(it);
+        }
+    }
+    return true;
+}
+
+void WatchRegistry::unwatchAll(const std::string& clientId) {
+    QMutexLocker locker(&m_mutex);
+    auto client = m_byClient.find(clientId);
+    if (client == m_byClient.end()) {
+        return;
+    }
+
+    for (const QString& key : client->second) {
+        auto it = m_byPath.find(key);
+        if (it != m_byPath.end()) {
+            it->clients.erase(clientId);
+            if (it->clients.empty()) {
+                m_byPath.erase(it);
+            }
+        }
+    }
+    EMIT_DEBUG() << "Dropped" << client->second.size() << "watches of client:" << clientId.c_str();
+    m_byClient.erase(client);
+}
+
+void WatchRegistry::notify(const QString& path) {
+    const QString key = keyOf(path);
+
+    // Step 1: Cheap exit for the common case of an unwatched path.
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_byPath.contains(key)) {
+            return;
+        }
+    }
+
+    FileMeta meta;
+    const bool exists = m_root->stat(key, &meta);
+
+    // Step 2: Classify the change against the last reported state.
+    QString event;
+    std::vector<std::string> targets;
+    Sink sink;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_byPath.find(key);
+        if (it == m_byPath.end()) {
+            return;
+        }
+        Watch& watch = it.value();
+
+        if (!watch.exists && exists) {
+            event = QString("EVENT CREATED %1 size=%2").arg(key).arg(meta.size);
+        } else if (watch.exists && !exists) {
+            event = QString("EVENT DELETED %1").arg(key);
+        } else if (exists && meta.inode == watch.last.inode && meta.size > watch.last.size) {
+            event = QString("EVENT APPENDED %1 offset=%2 length=%3")
+                    .arg(key).arg(watch.last.size).arg(meta.size - watch.last.size);
+        } else if (exists && (meta.size != watch.last.size || meta.mtimeMs != watch.last.mtimeMs
+                              || meta.inode != watch.last.inode)) {
+            event = QString("EVENT MODIFIED %1 size=%2 modified=%3")
+                    .arg(key).arg(meta.size)
+                    .arg(QDateTime::fromMSecsSinceEpoch(meta.mtimeMs).toString(Qt::ISODate));
+        } else {
+            return;
+        }
+
+        watch.last = meta;
+        watch.exists = exists;
+        targets.assign(watch.clients.begin(), watch.clients.end());
+        sink = m_sink;
+    }
+
+    // Step 3: Fan out without holding the registry lock.
+    if (!sink) {
+        return;
+    }
+    for (const std::string& clientId : targets) {
+        sink(clientId, event);
+    }
+    m_pushes.fetch_add(targets.size(), std::memory_order_relaxed);
+    EMIT_DEBUG() << "Pushed to" << targets.size() << "watchers:" << event;
+}
+
+void WatchRegistry::notifyAll() {
+    QList<QString> keys;
+    {
+        QMutexLocker locker(&m_mutex);
+        keys = m_byPath.keys();
+    }
+    for (const QString& key : keys) {
+        notify(key);
+    }
+}
+
+WatchRegistry::Stats WatchRegistry::stats() const {
+    Stats s;
+    QMutexLocker locker(&m_mutex);
+    s.paths = static_cast<quint64>(m_byPath.size());
+    for (const auto& client : m_byClient) {
+        s.subscriptions += static_cast<quint64>(client.second.size());
+    }
+    s.pushes = m_pushes.load(std::memory_order_relaxed);
+    return s;
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,143 @@
+/**
+ * @file WatchRegistry.hpp
+ * @brief Definition of the WatchRegistry class behind WATCH/UNWATCH.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the subscription table that turns file changes into
+ * pushed notifications, so clients no longer have to poll INFO/READ.
+ */
+
+#ifndef WATCHREGISTRY_HPP
+#define WATCHREGISTRY_HPP
+
+// Qt Depends
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+// Other
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "storage/MetadataIndex.hpp"
+#include "storage/RootDirectory.hpp"
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class WatchRegistry
+ * @brief Maps watched paths to subscribed clients and pushes change events.
+ *
+ * The registry is fed from two places: the FileServices mutation hooks
+ * (changes made through the server) and the MetadataIndex watch events
+ * (changes made by anyone else). For every notified path it compares the
+ * file's current size/mtime/inode with the last state it reported, so a
+ * change seen through both sources is pushed only once, and paths nobody
+ * watches cost a single hash lookup.
+ *
+ * Pushed events (one frame each):
+ * - "EVENT CREATED <path> size=<n>"
+ * - "EVENT APPENDED <path> offset=<old size> length=<n>" (same inode, grown)
+ * - "EVENT MODIFIED <path> size=<n> modified=<ISO time>"
+ * - "EVENT DELETED <path>"
+ */
+class WatchRegistry {
+public:
+    /** @brief Delivers one event to one client. */
+    using Sink = std::function<void(const std::string& clientId, const QString& event)>;
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the registry counters.
+     */
+    struct Stats {
+        quint64 paths = 0;
+        quint64 subscriptions = 0;
+        quint64 pushes = 0;
+    };
+
+    /**
+     * @param root The directory served to clients.
+     * @param maxPerClient Maximum number of paths a single client may watch.
+     */
+    WatchRegistry(std::shared_ptr<const RootDirectory> root, int maxPerClient)
+        : m_root(std::move(root)), m_maxPerClient(maxPerClient) {}
+
+    /** @brief Installs the delivery function (set once at startup). */
+    void setSink(Sink sink);
+
+    /**
+     * @brief Subscribes a client to a path (the file does not have to exist yet).
+     * @return false if the client already watches maxPerClient paths.
+     */
+    bool watch(const std::string& clientId, const QString& path);
+
+    /**
+     * @brief Removes one subscription.
+     * @return false if the client did not watch @p path.
+     */
+    bool unwatch(const std::string& clientId, const QString& path);
+
+    /** @brief Removes every subscription of a client (on UNWATCH without path or disconnect). */
+    void unwatchAll(const std::string& clientId);
+
+    /**
+     * @brief Reports that @p path may have changed; pushes an event if it did.
+     * @param path Path relative to the root.
+     */
+    void notify(const QString& path);
+
+    /** @brief Re-checks every watched path (after a full index rebuild). */
+    void notifyAll();
+
+    /** @brief Returns a snapshot of the registry counters. */
+    Stats stats() const;
+
+private:
+    /**
+     * @struct Watch
+     * @brief Subscribers of one path and the state last reported to them.
+     */
+    struct Watch {
+        std::set<std::string> clients;
+        FileMeta last;
+        bool exists = false;
+    };
+
+    /** @brief Normalizes a path into its registry key. */
+    static QString keyOf(const QString& path) { return QDir::cleanPath(path); }
+
+    /** @brief Served directory. */
+    const std::shared_ptr<const RootDirectory> m_root;
+
+    /** @brief Per-client subscription limit. */
+    const int m_maxPerClient;
+
+    /** @brief Protects every member below. */
+    mutable QMutex m_mutex;
+
+    /** @brief Delivery function. */
+    Sink m_sink;
+
+    /** @brief Watches by path. */
+    QHash<QString, Watch> m_byPath;
+
+    /** @brief Watched paths by client, for limits and cleanup. */
+    std::map<std::string, QSet<QString>> m_byClient;
+
+    /** @brief Number of events delivered. */
+    std::atomic<quint64> m_pushes{0};
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* WATCHREGISTRY_HPP */
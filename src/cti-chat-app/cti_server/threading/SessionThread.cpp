@@ -28,16 +28,19 @@ namespace Chat {
  * @param socketDescriptor The native handle for the TCP connection.
  * @param logic Shared pointer to the central business logic.
  * @param sessions Shared pointer to the session manager.
+ * @param tls Shared TLS context; null for plaintext.
  * @param parent Optional QObject parent.
  */
 SessionThread::SessionThread(qintptr socketDescriptor,
                              std::shared_ptr<ChatServer> logic,
                              std::shared_ptr<SessionManager> sessions,
+                             std::shared_ptr<TlsContext> tls,
                              QObject* parent)
     : QThread(parent),
       m_socketDescriptor(socketDescriptor),
       m_logic(logic),
-      m_sessions(sessions) {
+      m_sessions(sessions),
+      m_tls(std::move(tls)) {
     EMIT_DEBUG() << "Creating a new session thread.";
 }
 
@@ -54,11 +57,13 @@ void SessionThread::run() {
     EMIT_DEBUG() << "Running a session thread.";
 
     // Step 1: Create the ClientSession instance.
-    // Note: It is created here (inside run()) so its constructor runs in this thread.
+    // Note: It is created here (inside run()) so its constructor runs in this thread,
+    // and so does its TLS handshake: a full handshake never delays another session.
     ClientSession* session = new ClientSession(
         m_socketDescriptor,
         m_logic,
-        m_sessions.get()
+        m_sessions.get(),
+        m_tls
     );
 
     // Step 2: Explicitly move the session object to this thread.
@@ -23,6 +23,7 @@ namespace Chat {
 
 class ChatServer;
 class SessionManager;
+class TlsContext;
 
 /**
  * @class SessionThread
@@ -45,11 +46,13 @@ public:
      * @param socketDescriptor The native handle for the TCP connection.
      * @param logic Shared pointer to the central ChatServer logic.
      * @param sessions Shared pointer to the SessionManager registry.
+     * @param tls Shared TLS context; null for plaintext.
      * @param parent Optional QObject parent for memory management.
      */
     SessionThread(qintptr socketDescriptor,
                   std::shared_ptr<ChatServer> logic,
                   std::shared_ptr<SessionManager> sessions,
+                  std::shared_ptr<TlsContext> tls = nullptr,
                   QObject* parent = nullptr);
 
 protected:
@@ -70,6 +73,9 @@ private:
 
     /** @brief Reference to the manager for tracking active sessions. */
     std::shared_ptr<SessionManager> m_sessions;
+
+    /** @brief TLS context of the listener (null for plaintext). */
+    std::shared_ptr<TlsContext> m_tls;
 };
 
 } /* namespace Chat */
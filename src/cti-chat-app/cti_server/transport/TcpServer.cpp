@@ -27,14 +27,17 @@ namespace Chat {
  * 
  * @param logic Shared pointer to the central ChatServer business logic.
  * @param sessions Shared pointer to the SessionManager for client tracking.
+ * @param tls Shared TLS context (null for plaintext).
  * @param parent Optional QObject parent for the internal Qt tree.
  */
 TcpServer::TcpServer(std::shared_ptr<ChatServer> logic,
                      std::shared_ptr<SessionManager> sessions,
+                     std::shared_ptr<TlsContext> tls,
                      QObject* parent)
     : QTcpServer(parent),
       m_logic(logic),
-      m_sessions(sessions) {
+      m_sessions(sessions),
+      m_tls(std::move(tls)) {
     EMIT_INFO() << "TCP Server initiated.";
 }
 
@@ -65,7 +68,8 @@ void TcpServer::incomingConnection(qintptr socketDescriptor) {
     auto* thread = new SessionThread(
         socketDescriptor,
         m_logic,
-        m_sessions
+        m_sessions,
+        m_tls
     );
 
     // Step 2: Set up automatic cleanup
@@ -22,6 +22,7 @@ namespace Chat {
 
 class ChatServer;
 class SessionManager;
+class TlsContext;
 
 /**
  * @class TcpServer
@@ -40,10 +41,12 @@ public:
      * 
      * @param logic Shared pointer to the business logic (parsing/handling).
      * @param sessions Shared pointer to the thread-safe session registry.
+     * @param tls Shared TLS context; when set, every connection speaks TLS.
      * @param parent Optional QObject parent for the Qt object hierarchy.
      */
     TcpServer(std::shared_ptr<ChatServer> logic,
               std::shared_ptr<SessionManager> sessions,
+              std::shared_ptr<TlsContext> tls = nullptr,
               QObject* parent = nullptr);
 
 protected:
@@ -64,6 +67,9 @@ private:
 
     /** @brief Shared reference to the central connection registry. */
     std::shared_ptr<SessionManager> m_sessions;
+
+    /** @brief TLS context handed to every session (null for plaintext). */
+    std::shared_ptr<TlsContext> m_tls;
 };
 
 } /* namespace Chat */
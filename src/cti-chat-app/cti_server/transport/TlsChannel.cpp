@@ -0,0 +1,214 @@
+/**
+ * @file TlsChannel.cpp
+ * @brief Implementation of the memory-buffer TLS channel.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Other
+#include "TlsChannel.hpp"
+#include "TlsContext.hpp"
+#include "error/error_emitter.hpp"
+
+#if defined(CTI_HAVE_OPENSSL)
+#   include <openssl/err.h>
+#   include <openssl/ssl.h>
+#endif
+
+namespace CTI {
+namespace Chat {
+
+#if defined(CTI_HAVE_OPENSSL)
+
+TlsChannel::TlsChannel(std::shared_ptr<TlsContext> context)
+    : m_context(std::move(context)) {
+    m_clock.start();
+
+    // Step 1: Connection object with a memory buffer on each side.
+    m_ssl = m_context ? m_context->newConnection() : nullptr;
+    if (!m_ssl) {
+        fail();
+        return;
+    }
+    m_in = BIO_new(BIO_s_mem());
+    m_out = BIO_new(BIO_s_mem());
+    if (!m_in || !m_out) {
+        BIO_free(m_in);
+        BIO_free(m_out);
+        m_in = m_out = nullptr;
+        fail();
+        return;
+    }
+    SSL_set_bio(m_ssl, m_in, m_out);
+    SSL_set_accept_state(m_ssl);
+}
+
+TlsChannel::~TlsChannel() {
+    if (!m_ssl) {
+        return;
+    }
+    // OpenSSL drops a session from the cache when its connection is freed
+    // without a shutdown. Many clients just close the socket; a connection
+    // that ended without an error stays resumable.
+    if (m_established && !m_failed) {
+        SSL_set_shutdown(m_ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+    }
+    SSL_free(m_ssl); // Frees both BIOs.
+}
+
+bool TlsChannel::receive(const char* data, qint64 size, QByteArray* plain, QByteArray* out) {
+    if (m_failed) {
+        return false;
+    }
+    if (size > 0 && BIO_write(m_in, data, static_cast<int>(size)) != static_cast<int>(size)) {
+        fail();
+        return false;
+    }
+
+    // Step 1: Handshake first; it may need several round trips.
+    if (!m_established && !handshake()) {
+        drain(out);
+        return !m_failed;
+    }
+
+    // Step 2: Decrypt every complete record.
+    char chunk[16384];
+    for (;;) {
+        const int n = SSL_read(m_ssl, chunk, sizeof(chunk));
+        if (n > 0) {
+            plain->append(chunk, n);
+            continue;
+        }
+        const int err = SSL_get_error(m_ssl, n);
+        if (err == SSL_ERROR_WANT_READ) {
+            break;
+        }
+        if (err == SSL_ERROR_ZERO_RETURN) {
+            EMIT_DEBUG() << "TLS peer sent close_notify.";
+            SSL_shutdown(m_ssl);
+        } else {
+            EMIT_WARN() << "TLS record error:" << ERR_reason_error_string(ERR_peek_last_error());
+            ERR_clear_error();
+        }
+        m_failed = true;
+        break;
+    }
+    drain(out);
+    return !m_failed;
+}
+
+bool TlsChannel::send(const char* data, qint64 size, QByteArray* out) {
+    if (m_failed) {
+        return false;
+    }
+    if (!m_established) {
+        m_early.append(data, static_cast<int>(size));
+        return true;
+    }
+    const bool ok = write(data, size);
+    drain(out);
+    return ok;
+}
+
+void TlsChannel::abandon() {
+    if (!m_established) {
+        fail();
+    }
+}
+
+bool TlsChannel::handshake() {
+    const int rc = SSL_do_handshake(m_ssl);
+    if (rc != 1) {
+        const int err = SSL_get_error(m_ssl, rc);
+        if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+            EMIT_WARN() << "TLS handshake failed:" << ERR_reason_error_string(ERR_peek_last_error());
+            ERR_clear_error();
+            fail();
+        }
+        return false;
+    }
+
+    // Step 1: Account for it; a resumed session skipped the key exchange.
+    m_established = true;
+    const bool resumed = SSL_session_reused(m_ssl) == 1;
+    TlsContext::recordHandshake(resumed, m_clock.nsecsElapsed() / 1000);
+    EMIT_DEBUG() << "TLS handshake done:" << SSL_get_version(m_ssl) << (resumed ? "resumed" : "full")
+                 << "in" << m_clock.elapsed() << "ms";
+
+    // Step 2: Data the session sent meanwhile.
+    if (!m_early.isEmpty()) {
+        const QByteArray early = std::move(m_early);
+        m_early = QByteArray();
+        return write(early.constData(), early.size());
+    }
+    return true;
+}
+
+void TlsChannel::drain(QByteArray* out) {
+    const size_t pending = BIO_ctrl_pending(m_out);
+    if (pending == 0) {
+        return;
+    }
+    const int offset = out->size();
+    out->resize(offset + static_cast<int>(pending));
+    const int n = BIO_read(m_out, out->data() + offset, static_cast<int>(pending));
+    out->resize(offset + qMax(0, n));
+}
+
+bool TlsChannel::write(const char* data, qint64 size) {
+    // A memory BIO never pushes back, so each call consumes everything.
+    while (size > 0) {
+        const int n = SSL_write(m_ssl, data, static_cast<int>(qMin<qint64>(size, 1 << 30)));
+        if (n <= 0) {
+            EMIT_WARN() << "TLS write failed:" << ERR_reason_error_string(ERR_peek_last_error());
+            ERR_clear_error();
+            m_failed = true;
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+#else /* !CTI_HAVE_OPENSSL */
+
+TlsChannel::TlsChannel(std::shared_ptr<TlsContext> context)
+    : m_context(std::move(context)) {
+    fail();
+}
+
+TlsChannel::~TlsChannel() = default;
+
+bool TlsChannel::receive(const char*, qint64, QByteArray*, QByteArray*) {
+    return false;
+}
+
+bool TlsChannel::send(const char*, qint64, QByteArray*) {
+    return false;
+}
+
+void TlsChannel::abandon() {}
+
+bool TlsChannel::handshake() {
+    return false;
+}
+
+void TlsChannel::drain(QByteArray*) {}
+
+bool TlsChannel::write(const char*, qint64) {
+    return false;
+}
+
+#endif /* CTI_HAVE_OPENSSL */
+
+void TlsChannel::fail() {
+    if (!m_failed) {
+        m_failed = true;
+        TlsContext::recordFailure();
+    }
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,116 @@
+/**
+ * @file TlsChannel.hpp
+ * @brief Definition of the TlsChannel class, the TLS layer of one connection.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the per-connection TLS state machine ClientSession runs
+ * between its socket and its framing.
+ */
+
+#ifndef TLSCHANNEL_HPP
+#define TLSCHANNEL_HPP
+
+// Qt Depends
+#include <QByteArray>
+#include <QElapsedTimer>
+
+// Other
+#include <memory>
+
+struct bio_st;
+struct ssl_st;
+
+namespace CTI {
+namespace Chat {
+
+class TlsContext;
+
+/**
+ * @class TlsChannel
+ * @brief Server side of a TLS connection over memory buffers.
+ *
+ * The channel never touches the socket: ciphertext read from the socket is
+ * handed to receive(), which returns the decrypted bytes, and whatever the
+ * TLS layer has to send (handshake messages, tickets, records) is returned
+ * for the caller to write. The session therefore keeps its QTcpSocket, its
+ * read loop and its framing unchanged, and the handshake runs on the
+ * session's own thread, interleaved with nothing but its own connection.
+ *
+ * Application data sent before the handshake completes is held and flushed
+ * when it does. Not thread-safe; owned by the session.
+ */
+class TlsChannel {
+public:
+    /** @param context Shared context the connection is created from. */
+    explicit TlsChannel(std::shared_ptr<TlsContext> context);
+    ~TlsChannel();
+
+    TlsChannel(const TlsChannel&) = delete;
+    TlsChannel& operator=(const TlsChannel&) = delete;
+
+    /**
+     * @brief Processes ciphertext from the peer.
+     * @param data Bytes read from the socket.
+     * @param size Number of bytes.
+     * @param plain Receives the decrypted application data (appended).
+     * @param out Receives bytes to write to the socket (appended).
+     * @return false if the connection must be closed (handshake failure,
+     *         protocol error or close_notify); @p out may still hold an alert.
+     */
+    bool receive(const char* data, qint64 size, QByteArray* plain, QByteArray* out);
+
+    /**
+     * @brief Encrypts application data.
+     * @param out Receives bytes to write to the socket (appended; nothing
+     *        before the handshake completes).
+     * @return false if the connection has failed.
+     */
+    bool send(const char* data, qint64 size, QByteArray* out);
+
+    /** @brief True once the handshake has completed. */
+    bool established() const { return m_established; }
+
+    /** @brief True if the peer has failed (or the channel could not be created). */
+    bool failed() const { return m_failed; }
+
+    /** @brief Marks the handshake as abandoned (timeout) in the counters. */
+    void abandon();
+
+private:
+    /** @brief Advances the handshake; true when it has completed. */
+    bool handshake();
+
+    /** @brief Moves pending ciphertext from the write buffer to @p out. */
+    void drain(QByteArray* out);
+
+    /** @brief Encrypts @p size bytes into the write buffer. */
+    bool write(const char* data, qint64 size);
+
+    /** @brief Records the failure once. */
+    void fail();
+
+    std::shared_ptr<TlsContext> m_context;
+    ssl_st* m_ssl = nullptr;
+
+    /** @brief Ciphertext from the peer (owned by m_ssl). */
+    bio_st* m_in = nullptr;
+
+    /** @brief Ciphertext for the peer (owned by m_ssl). */
+    bio_st* m_out = nullptr;
+
+    /** @brief Application data queued during the handshake. */
+    QByteArray m_early;
+
+    /** @brief Started with the channel; measures the handshake. */
+    QElapsedTimer m_clock;
+
+    bool m_established = false;
+    bool m_failed = false;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* TLSCHANNEL_HPP */
@@ -0,0 +1,153 @@
+/**
+ * @file TlsContext.cpp
+ * @brief Implementation of the shared OpenSSL server context.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ */
+
+// Qt Depends
+#include <QFile>
+
+// Other
+#include "TlsContext.hpp"
+#include "error/error_emitter.hpp"
+#include "constants.hpp"
+
+#if defined(CTI_HAVE_OPENSSL)
+#   include <openssl/err.h>
+#   include <openssl/ssl.h>
+#endif
+
+namespace CTI {
+namespace Chat {
+
+std::atomic<ssl_ctx_st*> TlsContext::s_active{nullptr};
+std::atomic<quint64> TlsContext::s_full{0};
+std::atomic<quint64> TlsContext::s_resumed{0};
+std::atomic<quint64> TlsContext::s_failed{0};
+std::atomic<quint64> TlsContext::s_handshakeMicros{0};
+
+#if defined(CTI_HAVE_OPENSSL)
+
+namespace {
+
+/** @brief Id binding cached sessions to this server. */
+const unsigned char SESSION_ID_CONTEXT[] = "cti_server";
+
+/** @brief Logs and clears the OpenSSL error queue. */
+void logOpenSslErrors(const char* what) {
+    unsigned long err;
+    while ((err = ERR_get_error()) != 0) {
+        char text[256];
+        ERR_error_string_n(err, text, sizeof(text));
+        EMIT_ERROR() << what << text;
+    }
+}
+
+} /* namespace */
+
+std::shared_ptr<TlsContext> TlsContext::create(const QString& certPath, const QString& keyPath) {
+    // Step 1: Server context, TLS 1.2 and later only.
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) {
+        logOpenSslErrors("TLS context creation failed:");
+        return nullptr;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_options(ctx, SSL_OP_NO_RENEGOTIATION | SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+    // Step 2: Identity.
+    const QByteArray cert = QFile::encodeName(certPath);
+    const QByteArray key = QFile::encodeName(keyPath);
+    if (SSL_CTX_use_certificate_chain_file(ctx, cert.constData()) != 1
+        || SSL_CTX_use_PrivateKey_file(ctx, key.constData(), SSL_FILETYPE_PEM) != 1
+        || SSL_CTX_check_private_key(ctx) != 1) {
+        logOpenSslErrors("TLS certificate or key rejected:");
+        EMIT_ERROR() << "Cannot load TLS identity from" << certPath << "and" << keyPath;
+        SSL_CTX_free(ctx);
+        return nullptr;
+    }
+
+    // Step 3: Resumption. Session ids are looked up in the context's cache,
+    // tickets are sealed with the context's keys; both outlive connections.
+    SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, Constants::TLS_SESSION_CACHE_SIZE);
+    SSL_CTX_set_timeout(ctx, Constants::TLS_SESSION_LIFETIME_SEC);
+    SSL_CTX_set_num_tickets(ctx, Constants::TLS_TICKETS_PER_HANDSHAKE);
+
+    EMIT_INFO() << "TLS enabled with certificate" << certPath;
+    return std::shared_ptr<TlsContext>(new TlsContext(ctx));
+}
+
+TlsContext::TlsContext(ssl_ctx_st* ctx)
+    : m_ctx(ctx) {
+    s_active.store(ctx, std::memory_order_release);
+}
+
+TlsContext::~TlsContext() {
+    ssl_ctx_st* self = m_ctx;
+    s_active.compare_exchange_strong(self, nullptr);
+    SSL_CTX_free(m_ctx);
+}
+
+ssl_st* TlsContext::newConnection() const {
+    SSL* ssl = SSL_new(m_ctx);
+    if (!ssl) {
+        logOpenSslErrors("TLS connection setup failed:");
+    }
+    return ssl;
+}
+
+TlsContext::Stats TlsContext::stats() {
+    Stats s;
+    s.full            = s_full.load(std::memory_order_relaxed);
+    s.resumed         = s_resumed.load(std::memory_order_relaxed);
+    s.failed          = s_failed.load(std::memory_order_relaxed);
+    s.handshakeMicros = s_handshakeMicros.load(std::memory_order_relaxed);
+    if (SSL_CTX* ctx = s_active.load(std::memory_order_acquire)) {
+        s.cachedSessions = static_cast<quint64>(SSL_CTX_sess_number(ctx));
+    }
+    return s;
+}
+
+#else /* !CTI_HAVE_OPENSSL */
+
+std::shared_ptr<TlsContext> TlsContext::create(const QString& certPath, const QString& keyPath) {
+    Q_UNUSED(keyPath);
+    EMIT_ERROR() << "TLS requested (certificate" << certPath << ") but the server was built without OpenSSL.";
+    return nullptr;
+}
+
+TlsContext::TlsContext(ssl_ctx_st* ctx)
+    : m_ctx(ctx) {}
+
+TlsContext::~TlsContext() = default;
+
+ssl_st* TlsContext::newConnection() const {
+    return nullptr;
+}
+
+TlsContext::Stats TlsContext::stats() {
+    Stats s;
+    s.full            = s_full.load(std::memory_order_relaxed);
+    s.resumed         = s_resumed.load(std::memory_order_relaxed);
+    s.failed          = s_failed.load(std::memory_order_relaxed);
+    s.handshakeMicros = s_handshakeMicros.load(std::memory_order_relaxed);
+    return s;
+}
+
+#endif /* CTI_HAVE_OPENSSL */
+
+void TlsContext::recordHandshake(bool resumed, qint64 micros) {
+    (resumed ? s_resumed : s_full).fetch_add(1, std::memory_order_relaxed);
+    s_handshakeMicros.fetch_add(static_cast<quint64>(qMax<qint64>(0, micros)), std::memory_order_relaxed);
+}
+
+void TlsContext::recordFailure() {
+    s_failed.fetch_add(1, std::memory_order_relaxed);
+}
+
+} /* namespace Chat */
+} /* namespace CTI */
@@ -0,0 +1,102 @@
+/**
+ * @file TlsContext.hpp
+ * @brief Definition of the TlsContext class, the server's shared TLS configuration.
+ * @author Mohamed Ashraf
+ * @email mohamed.ashraf@coretech-innovations.com
+ * @date Oct 2026
+ *
+ * This file defines the one OpenSSL context every TLS connection is created
+ * from, which also holds the session cache that lets clients resume.
+ */
+
+#ifndef TLSCONTEXT_HPP
+#define TLSCONTEXT_HPP
+
+// Qt Depends
+#include <QString>
+
+// Other
+#include <atomic>
+#include <memory>
+
+struct ssl_ctx_st;
+struct ssl_st;
+
+namespace CTI {
+namespace Chat {
+
+/**
+ * @class TlsContext
+ * @brief Certificate, key, protocol settings and session cache shared by all TLS sessions.
+ *
+ * A single SSL_CTX is created at startup and every connection's SSL object
+ * is made from it. Resumption depends on that sharing: the server-side
+ * session cache (TLS 1.2 session ids) and the session-ticket keys (TLS 1.2
+ * tickets and TLS 1.3 PSKs) both belong to the context, so a client
+ * reconnecting with a session issued on an earlier connection skips the
+ * certificate and key-exchange work of a full handshake.
+ *
+ * Handshake counters are process-wide (there is one listener) and are
+ * reported by STATS: full and resumed handshakes, failures and the time
+ * spent in handshakes.
+ */
+class TlsContext {
+public:
+    /**
+     * @struct Stats
+     * @brief Handshake counters.
+     */
+    struct Stats {
+        quint64 full = 0;
+        quint64 resumed = 0;
+        quint64 failed = 0;
+        /** @brief Time from the first byte to the end of the handshake, summed. */
+        quint64 handshakeMicros = 0;
+        /** @brief Sessions held by the server-side cache. */
+        quint64 cachedSessions = 0;
+    };
+
+    /**
+     * @brief Loads the certificate chain and private key into a new context.
+     * @param certPath PEM certificate (chain).
+     * @param keyPath PEM private key.
+     * @return The context, or null (logged) if TLS is unavailable or the files are unusable.
+     */
+    static std::shared_ptr<TlsContext> create(const QString& certPath, const QString& keyPath);
+
+    ~TlsContext();
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    /** @brief Creates the server-side SSL object of a new connection (owned by the caller). */
+    ssl_st* newConnection() const;
+
+    /** @brief Records a completed handshake. */
+    static void recordHandshake(bool resumed, qint64 micros);
+
+    /** @brief Records a failed or timed-out handshake. */
+    static void recordFailure();
+
+    /** @brief Returns the handshake counters. */
+    static Stats stats();
+
+private:
+    explicit TlsContext(ssl_ctx_st* ctx);
+
+    /** @brief The shared OpenSSL context. */
+    ssl_ctx_st* m_ctx = nullptr;
+
+    /** @brief Context whose cache size stats() reports. */
+    static std::atomic<ssl_ctx_st*> s_active;
+
+    static std::atomic<quint64> s_full;
+    static std::atomic<quint64> s_resumed;
+    static std::atomic<quint64> s_failed;
+    static std::atomic<quint64> s_handshakeMicros;
+};
+
+} /* namespace Chat */
+} /* namespace CTI */
+
+#endif /* TLSCONTEXT_HPP */